@@ -0,0 +1,104 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+/*
+ * Copyright (C) 2026, Ideas on Board Oy
+ *
+ * cache_file.h - Helpers for persistent cache files
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include <libcamera/base/span.h>
+
+namespace libcamera {
+
+class CacheFile
+{
+public:
+	/* Upper bound of the strings and blobs stored in cache files. */
+	static constexpr uint32_t kMaxBlobSize = 64 * 1024;
+
+	class Writer
+	{
+	public:
+		template<typename T>
+		void write(const T &value)
+		{
+			const uint8_t *data = reinterpret_cast<const uint8_t *>(&value);
+			data_.insert(data_.end(), data, data + sizeof(value));
+		}
+
+		void writeBlob(Span<const uint8_t> blob)
+		{
+			write<uint32_t>(blob.size());
+			data_.insert(data_.end(), blob.begin(), blob.end());
+		}
+
+		void writeString(const std::string &str)
+		{
+			writeBlob({ reinterpret_cast<const uint8_t *>(str.data()), str.size() });
+		}
+
+		Span<const uint8_t> data() const { return data_; }
+
+	private:
+		std::vector<uint8_t> data_;
+	};
+
+	class Reader
+	{
+	public:
+		Reader(Span<const uint8_t> data)
+			: data_(data), pos_(0)
+		{
+		}
+
+		template<typename T>
+		bool read(T *value)
+		{
+			if (data_.size() - pos_ < sizeof(*value))
+				return false;
+
+			memcpy(value, data_.data() + pos_, sizeof(*value));
+			pos_ += sizeof(*value);
+			return true;
+		}
+
+		bool readBlob(std::vector<uint8_t> *blob)
+		{
+			uint32_t size;
+			if (!read(&size) || size > kMaxBlobSize ||
+			    data_.size() - pos_ < size)
+				return false;
+
+			blob->assign(data_.data() + pos_, data_.data() + pos_ + size);
+			pos_ += size;
+			return true;
+		}
+
+		bool readString(std::string *str)
+		{
+			std::vector<uint8_t> blob;
+			if (!readBlob(&blob))
+				return false;
+
+			str->assign(blob.begin(), blob.end());
+			return true;
+		}
+
+		bool atEnd() const { return pos_ == data_.size(); }
+
+	private:
+		Span<const uint8_t> data_;
+		size_t pos_;
+	};
+
+	static int load(const std::string &path, std::vector<uint8_t> *data);
+	static int save(const std::string &path, Span<const uint8_t> data);
+};
+
+} /* namespace libcamera */
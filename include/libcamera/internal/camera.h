@@ -17,6 +17,8 @@
 
 #include <libcamera/camera.h>
 
+#include "libcamera/internal/frame_timing.h"
+
 namespace libcamera {
 
 class CameraControlValidator;
@@ -38,6 +40,7 @@ public:
 	ControlList properties_;
 
 	uint32_t requestSequence_;
+	FrameTimingModel frameTiming_;
 
 	const CameraControlValidator *validator() const { return validator_.get(); }
 
@@ -0,0 +1,131 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+/*
+ * Copyright (C) 2026, Ideas on Board Oy
+ *
+ * camera_configuration_cache.h - Cache of camera configuration validation results
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <list>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <libcamera/base/mutex.h>
+
+#include <libcamera/camera.h>
+#include <libcamera/color_space.h>
+#include <libcamera/geometry.h>
+#include <libcamera/pixel_format.h>
+#include <libcamera/transform.h>
+
+namespace libcamera {
+
+class CameraConfigurationKey
+{
+public:
+	CameraConfigurationKey();
+	CameraConfigurationKey(const CameraConfiguration &config);
+
+	bool operator==(const CameraConfigurationKey &other) const;
+	bool operator!=(const CameraConfigurationKey &other) const
+	{
+		return !(*this == other);
+	}
+
+private:
+	struct StreamKey {
+		PixelFormat pixelFormat;
+		Size size;
+		unsigned int stride;
+		unsigned int frameSize;
+		unsigned int bufferCount;
+		std::optional<ColorSpace> colorSpace;
+
+		bool operator==(const StreamKey &other) const;
+	};
+
+	Transform transform_;
+	std::vector<StreamKey> streams_;
+};
+
+template<typename Value>
+class CameraConfigurationCache
+{
+public:
+	static constexpr unsigned int kMaxEntries = 8;
+
+	CameraConfigurationCache()
+		: hits_(0), misses_(0)
+	{
+	}
+
+	std::optional<Value> find(const CameraConfigurationKey &key)
+	{
+		MutexLocker locker(mutex_);
+
+		auto it = lookup(key);
+		if (it == entries_.end()) {
+			misses_++;
+			return std::nullopt;
+		}
+
+		/* Keep the entries sorted from most to least recently used. */
+		entries_.splice(entries_.begin(), entries_, it);
+		hits_++;
+
+		return it->second;
+	}
+
+	void insert(const CameraConfigurationKey &key, Value value)
+	{
+		MutexLocker locker(mutex_);
+
+		auto it = lookup(key);
+		if (it != entries_.end())
+			entries_.erase(it);
+
+		entries_.emplace_front(key, std::move(value));
+		if (entries_.size() > kMaxEntries)
+			entries_.pop_back();
+	}
+
+	void clear()
+	{
+		MutexLocker locker(mutex_);
+		entries_.clear();
+	}
+
+	unsigned int hits() const
+	{
+		MutexLocker locker(mutex_);
+		return hits_;
+	}
+
+	unsigned int misses() const
+	{
+		MutexLocker locker(mutex_);
+		return misses_;
+	}
+
+private:
+	using Entry = std::pair<CameraConfigurationKey, Value>;
+
+	typename std::list<Entry>::iterator lookup(const CameraConfigurationKey &key)
+		LIBCAMERA_TSA_REQUIRES(mutex_)
+	{
+		return std::find_if(entries_.begin(), entries_.end(),
+				    [&](const Entry &entry) {
+					    return entry.first == key;
+				    });
+	}
+
+	mutable Mutex mutex_;
+	std::list<Entry> entries_ LIBCAMERA_TSA_GUARDED_BY(mutex_);
+	unsigned int hits_ LIBCAMERA_TSA_GUARDED_BY(mutex_);
+	unsigned int misses_ LIBCAMERA_TSA_GUARDED_BY(mutex_);
+};
+
+} /* namespace libcamera */
@@ -26,6 +26,7 @@ namespace libcamera {
 
 class Camera;
 class DeviceEnumerator;
+class V4L2CapabilityCache;
 
 class CameraManager::Private : public Extensible::Private, public Thread
 {
@@ -60,6 +61,7 @@ private:
 	int status_ LIBCAMERA_TSA_GUARDED_BY(mutex_);
 
 	std::unique_ptr<DeviceEnumerator> enumerator_;
+	std::unique_ptr<V4L2CapabilityCache> capabilityCache_;
 
 	IPAManager ipaManager_;
 	ProcessManager processManager_;
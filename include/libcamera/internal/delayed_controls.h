@@ -9,6 +9,11 @@
 
 #include <stdint.h>
 #include <unordered_map>
+#include <vector>
+
+#include <linux/videodev2.h>
+
+#include <libcamera/base/utils.h>
 
 #include <libcamera/controls.h>
 
@@ -24,6 +29,14 @@ public:
 		bool priorityWrite;
 	};
 
+	struct Statistics {
+		unsigned int frames = 0;
+		unsigned int writes = 0;
+		utils::Duration lastLatency{ 0 };
+		utils::Duration maxLatency{ 0 };
+		utils::Duration totalLatency{ 0 };
+	};
+
 	DelayedControls(V4L2Device *device,
 			const std::unordered_map<uint32_t, ControlParams> &controlParams);
 
@@ -34,6 +47,8 @@ public:
 
 	void applyControls(uint32_t sequence);
 
+	const Statistics &statistics() const { return stats_; }
+
 private:
 	class Info : public ControlValue
 	{
@@ -67,15 +82,31 @@ private:
 		}
 	};
 
+	struct Control {
+		const ControlId *id;
+		ControlParams params;
+		ControlType type;
+		ControlRingBuffer values;
+	};
+
+	static bool fillV4L2Control(v4l2_ext_control *v4l2Ctrl,
+				    const Control &ctrl, Info &info);
+
+	Control *findControl(const ControlId *id);
+
 	V4L2Device *device_;
-	/* \todo Evaluate if we should index on ControlId * or unsigned int */
-	std::unordered_map<const ControlId *, ControlParams> controlParams_;
+	/* Controls handled by the instance, sorted by V4L2 control id. */
+	std::vector<Control> controls_;
 	unsigned int maxDelay_;
 
 	uint32_t queueCount_;
 	uint32_t writeCount_;
-	/* \todo Evaluate if we should index on ControlId * or unsigned int */
-	std::unordered_map<const ControlId *, ControlRingBuffer> values_;
+
+	/* Preallocated storage for the controls written at each frame start. */
+	std::vector<v4l2_ext_control> priorityWrites_;
+	std::vector<v4l2_ext_control> writes_;
+
+	Statistics stats_;
 };
 
 } /* namespace libcamera */
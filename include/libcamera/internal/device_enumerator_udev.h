@@ -54,6 +54,7 @@ private:
 		DependencyMap deps_;
 	};
 
+	int addMediaDevice(std::unique_ptr<MediaDevice> media);
 	int addUdevDevice(struct udev_device *dev);
 	int populateMediaDevice(MediaDevice *media, DependencyMap *deps);
 	std::string lookupDeviceNode(dev_t devnum);
@@ -0,0 +1,43 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+/*
+ * Copyright (C) 2026, Ideas on Board Oy
+ *
+ * frame_timing.h - Frame timing model for capture sequence prediction
+ */
+
+#pragma once
+
+#include <optional>
+#include <stdint.h>
+
+#include <libcamera/base/utils.h>
+
+namespace libcamera {
+
+class FrameTimingModel
+{
+public:
+	FrameTimingModel();
+
+	void reset();
+
+	void frameStarted(uint32_t sequence, utils::time_point time);
+	void frameCompleted(uint32_t sequence, utils::time_point time);
+
+	uint32_t predictSequence(utils::time_point time);
+
+	utils::Duration frameDuration() const { return frameDuration_; }
+
+private:
+	void update(uint32_t sequence, utils::time_point time);
+
+	bool frameStartEvents_;
+	bool valid_;
+	uint32_t sequence_;
+	utils::time_point time_;
+	utils::Duration frameDuration_;
+
+	std::optional<uint32_t> lastPrediction_;
+};
+
+} /* namespace libcamera */
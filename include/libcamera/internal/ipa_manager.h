@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <memory>
 #include <stdint.h>
 #include <vector>
 
@@ -16,6 +17,8 @@
 #include <libcamera/ipa/ipa_module_info.h>
 
 #include "libcamera/internal/ipa_module.h"
+#include "libcamera/internal/ipa_module_cache.h"
+#include "libcamera/internal/ipa_proxy_worker_pool.h"
 #include "libcamera/internal/pipeline_handler.h"
 #include "libcamera/internal/pub_key.h"
 
@@ -67,6 +70,8 @@ private:
 	bool isSignatureValid(IPAModule *ipa) const;
 
 	std::vector<IPAModule *> modules_;
+	std::unique_ptr<IPAModuleCache> cache_;
+	std::unique_ptr<IPAProxyWorkerPool> workerPool_;
 
 #if HAVE_IPA_PUBKEY
 	static const uint8_t publicKeyData_[];
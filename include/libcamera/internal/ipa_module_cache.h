@@ -0,0 +1,86 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+/*
+ * Copyright (C) 2026, Ideas on Board Oy
+ *
+ * ipa_module_cache.h - Persistent cache of IPA module information
+ */
+
+#pragma once
+
+#include <map>
+#include <optional>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include <libcamera/base/class.h>
+#include <libcamera/base/span.h>
+
+#include <libcamera/ipa/ipa_module_info.h>
+
+namespace libcamera {
+
+class IPAModuleCache
+{
+public:
+	IPAModuleCache(const std::string &path);
+	~IPAModuleCache();
+
+	static std::string defaultPath();
+
+	const std::string &path() const { return path_; }
+
+	bool moduleInfo(const std::string &modulePath, IPAModuleInfo *info);
+	void setModuleInfo(const std::string &modulePath,
+			   const IPAModuleInfo &info);
+
+	std::optional<bool> signatureValid(const std::string &modulePath,
+					   Span<const uint8_t> signature);
+	void setSignatureValid(const std::string &modulePath,
+			       Span<const uint8_t> signature, bool valid);
+
+	int save();
+
+	unsigned int hits() const { return hits_; }
+	unsigned int misses() const { return misses_; }
+
+private:
+	LIBCAMERA_DISABLE_COPY_AND_MOVE(IPAModuleCache)
+
+	struct FileId {
+		uint64_t dev;
+		uint64_t ino;
+		uint64_t size;
+		int64_t mtime;
+		int64_t ctime;
+
+		bool operator==(const FileId &other) const;
+		bool operator!=(const FileId &other) const { return !(*this == other); }
+	};
+
+	struct Entry {
+		FileId id;
+
+		bool hasInfo;
+		IPAModuleInfo info;
+
+		bool hasSignature;
+		bool signatureValid;
+		std::vector<uint8_t> signature;
+	};
+
+	static int fileId(const std::string &path, FileId *id);
+
+	int load();
+	Entry *lookup(const std::string &modulePath);
+	Entry *update(const std::string &modulePath);
+
+	std::string path_;
+	std::map<std::string, Entry> entries_;
+	bool dirty_;
+
+	unsigned int hits_;
+	unsigned int misses_;
+};
+
+} /* namespace libcamera */
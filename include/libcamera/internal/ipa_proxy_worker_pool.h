@@ -0,0 +1,65 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+/*
+ * Copyright (C) 2026, Ideas on Board Oy
+ *
+ * ipa_proxy_worker_pool.h - Pool of pre-spawned IPA proxy workers
+ */
+
+#pragma once
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <libcamera/base/class.h>
+#include <libcamera/base/mutex.h>
+
+#include "libcamera/internal/ipc_unixsocket.h"
+#include "libcamera/internal/process.h"
+
+namespace libcamera {
+
+class IPAProxyWorkerPool
+{
+public:
+	struct Worker {
+		std::unique_ptr<Process> process;
+		std::unique_ptr<IPCUnixSocket> socket;
+	};
+
+	IPAProxyWorkerPool(unsigned int size);
+	~IPAProxyWorkerPool();
+
+	static IPAProxyWorkerPool *instance();
+
+	static std::unique_ptr<Worker> spawn(const std::string &modulePath,
+					     const std::string &workerPath);
+
+	std::unique_ptr<Worker> acquire(const std::string &modulePath,
+					const std::string &workerPath);
+
+	unsigned int size() const { return size_; }
+	unsigned int available(const std::string &modulePath) const;
+
+	unsigned int hits() const;
+	unsigned int misses() const;
+
+private:
+	LIBCAMERA_DISABLE_COPY_AND_MOVE(IPAProxyWorkerPool)
+
+	using Key = std::pair<std::string, std::string>;
+
+	static IPAProxyWorkerPool *self_;
+
+	unsigned int size_;
+
+	mutable Mutex mutex_;
+	std::map<Key, std::deque<std::unique_ptr<Worker>>> workers_
+		LIBCAMERA_TSA_GUARDED_BY(mutex_);
+	unsigned int hits_ LIBCAMERA_TSA_GUARDED_BY(mutex_);
+	unsigned int misses_ LIBCAMERA_TSA_GUARDED_BY(mutex_);
+};
+
+} /* namespace libcamera */
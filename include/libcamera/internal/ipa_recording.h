@@ -0,0 +1,40 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+/*
+ * Copyright (C) 2026, Ideas on Board Oy
+ *
+ * ipa_recording.h - IPA interface recording format
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+namespace libcamera {
+
+#define IPA_RECORDING_FORMAT_VERSION	1
+#define IPA_RECORDING_MAGIC		"LCIPAREC"
+
+enum ipa_record_type {
+	IPA_RECORD_INIT = 1,
+	IPA_RECORD_CONFIGURE = 2,
+	IPA_RECORD_START = 3,
+	IPA_RECORD_STOP = 4,
+	IPA_RECORD_QUEUE_REQUEST = 5,
+	IPA_RECORD_FILL_PARAMS = 6,
+	IPA_RECORD_PROCESS_STATS = 7,
+};
+
+struct ipa_recording_header {
+	char magic[8];
+	uint32_t version;
+	char pipeline[20];
+};
+
+struct ipa_record_header {
+	uint32_t type;
+	uint32_t frame;
+	uint32_t size;
+	uint32_t reserved[1];
+};
+
+} /* namespace libcamera */
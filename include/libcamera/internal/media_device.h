@@ -10,6 +10,7 @@
 #include <map>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <linux/media.h>
@@ -46,6 +47,7 @@ public:
 
 	const std::vector<MediaEntity *> &entities() const { return entities_; }
 	MediaEntity *getEntityByName(const std::string &name) const;
+	const std::vector<MediaEntity *> &entitiesByFunction(unsigned int function) const;
 
 	MediaLink *link(const std::string &sourceName, unsigned int sourceIdx,
 			const std::string &sinkName, unsigned int sinkIdx);
@@ -89,6 +91,8 @@ private:
 
 	std::map<unsigned int, MediaObject *> objects_;
 	std::vector<MediaEntity *> entities_;
+	std::unordered_map<std::string, MediaEntity *> entitiesByName_;
+	std::unordered_map<unsigned int, std::vector<MediaEntity *>> entitiesByFunction_;
 };
 
 } /* namespace libcamera */
@@ -20,6 +20,7 @@
 #include <libcamera/controls.h>
 #include <libcamera/stream.h>
 
+#include "libcamera/internal/camera_configuration_cache.h"
 #include "libcamera/internal/ipa_proxy.h"
 
 namespace libcamera {
@@ -46,11 +47,13 @@ public:
 					const DeviceMatch &dm);
 
 	bool acquire();
+	int acquireCamera(Camera *camera);
 	void release(Camera *camera);
 
 	virtual std::unique_ptr<CameraConfiguration> generateConfiguration(Camera *camera,
 									   Span<const StreamRole> roles) = 0;
 	virtual int configure(Camera *camera, CameraConfiguration *config) = 0;
+	int configureCamera(Camera *camera, CameraConfiguration *config);
 
 	virtual int exportFrameBuffers(Camera *camera, Stream *stream,
 				       std::vector<std::unique_ptr<FrameBuffer>> *buffers) = 0;
@@ -74,9 +77,12 @@ protected:
 	void registerCamera(std::shared_ptr<Camera> camera);
 	void hotplugMediaDevice(MediaDevice *media);
 
+	static bool lazyCameraInit();
+
 	virtual int queueRequestDevice(Camera *camera, Request *request) = 0;
 	virtual void stopDevice(Camera *camera) = 0;
 
+	virtual int acquireDevice(Camera *camera);
 	virtual void releaseDevice(Camera *camera);
 
 	CameraManager *manager_;
@@ -100,6 +106,10 @@ private:
 	Mutex lock_;
 	unsigned int useCount_ LIBCAMERA_TSA_GUARDED_BY(lock_);
 
+	const Camera *configuredCamera_ LIBCAMERA_TSA_GUARDED_BY(lock_);
+	CameraConfigurationKey configuredKey_;
+	std::vector<Stream *> configuredStreams_;
+
 	friend class PipelineHandlerFactoryBase;
 };
 
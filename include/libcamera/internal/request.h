@@ -10,6 +10,7 @@
 #include <chrono>
 #include <map>
 #include <memory>
+#include <vector>
 
 #include <libcamera/base/event_notifier.h>
 #include <libcamera/base/timer.h>
@@ -56,7 +57,8 @@ private:
 	uint32_t sequence_ = 0;
 	bool prepared_ = false;
 
-	std::unordered_set<FrameBuffer *> pending_;
+	std::vector<FrameBuffer *> pending_;
+	std::vector<BufferMap::node_type> spareNodes_;
 	std::map<FrameBuffer *, std::unique_ptr<EventNotifier>> notifiers_;
 	std::unique_ptr<Timer> timer_;
 };
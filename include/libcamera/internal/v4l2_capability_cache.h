@@ -0,0 +1,62 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+/*
+ * Copyright (C) 2026, Ideas on Board Oy
+ *
+ * v4l2_capability_cache.h - Persistent cache of V4L2 device capabilities
+ */
+
+#pragma once
+
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include <libcamera/base/class.h>
+#include <libcamera/base/mutex.h>
+
+#include <libcamera/geometry.h>
+
+namespace libcamera {
+
+class V4L2CapabilityCache
+{
+public:
+	using Formats = std::map<uint32_t, std::vector<SizeRange>>;
+
+	V4L2CapabilityCache(const std::string &path);
+	~V4L2CapabilityCache();
+
+	static V4L2CapabilityCache *instance();
+	static std::string defaultPath();
+
+	const std::string &path() const { return path_; }
+
+	bool formats(const std::string &key, Formats *formats);
+	void setFormats(const std::string &key, const Formats &formats);
+
+	int save();
+
+	unsigned int hits() const;
+	unsigned int misses() const;
+
+private:
+	LIBCAMERA_DISABLE_COPY_AND_MOVE(V4L2CapabilityCache)
+
+	static V4L2CapabilityCache *self_;
+
+	static std::string systemId();
+
+	int load();
+
+	std::string path_;
+
+	mutable Mutex mutex_;
+	std::map<std::string, Formats> entries_ LIBCAMERA_TSA_GUARDED_BY(mutex_);
+	bool dirty_ LIBCAMERA_TSA_GUARDED_BY(mutex_);
+
+	unsigned int hits_ LIBCAMERA_TSA_GUARDED_BY(mutex_);
+	unsigned int misses_ LIBCAMERA_TSA_GUARDED_BY(mutex_);
+};
+
+} /* namespace libcamera */
@@ -10,6 +10,7 @@
 #include <map>
 #include <memory>
 #include <optional>
+#include <unordered_map>
 #include <vector>
 
 #include <linux/videodev2.h>
@@ -31,6 +32,13 @@ class EventNotifier;
 class V4L2Device : protected Loggable
 {
 public:
+	struct ControlStatistics {
+		unsigned int reads;
+		unsigned int writes;
+		unsigned int skippedWrites;
+		unsigned int skippedControls;
+	};
+
 	void close();
 	bool isOpen() const { return fd_.isValid(); }
 
@@ -38,9 +46,12 @@ public:
 
 	ControlList getControls(const std::vector<uint32_t> &ids);
 	int setControls(ControlList *ctrls);
+	int setControls(Span<v4l2_ext_control> v4l2Ctrls);
 
 	const struct v4l2_query_ext_ctrl *controlInfo(uint32_t id) const;
 
+	const ControlStatistics &controlStatistics() const { return controlStats_; }
+
 	const std::string &deviceNode() const { return deviceNode_; }
 	std::string devicePath() const;
 
@@ -68,7 +79,23 @@ protected:
 	static int fromColorSpace(const std::optional<ColorSpace> &colorSpace, T &v4l2Format);
 
 private:
+	struct ControlTemplate {
+		struct Entry {
+			unsigned int id;
+			ControlType type;
+			uint32_t v4l2Type;
+			uint32_t elems;
+			bool hasPayload;
+			bool cacheable;
+			bool invalidatesOthers;
+		};
+
+		std::vector<Entry> entries;
+	};
+
 	static ControlType v4l2CtrlType(uint32_t ctrlType);
+	static bool isCacheable(const v4l2_query_ext_ctrl &ctrl);
+	static bool invalidatesOthers(const v4l2_query_ext_ctrl &ctrl);
 	static std::unique_ptr<ControlId> v4l2ControlId(const v4l2_query_ext_ctrl &ctrl);
 	std::optional<ControlInfo> v4l2ControlInfo(const v4l2_query_ext_ctrl &ctrl);
 	std::optional<ControlInfo> v4l2MenuControlInfo(const v4l2_query_ext_ctrl &ctrl);
@@ -77,6 +104,11 @@ private:
 	void updateControls(ControlList *ctrls,
 			    Span<const v4l2_ext_control> v4l2Ctrls);
 
+	const ControlTemplate *controlTemplate(const ControlList &ctrls);
+	int writeControls(Span<v4l2_ext_control> v4l2Ctrls);
+	void updateControlValues(Span<const v4l2_ext_control> v4l2Ctrls);
+	void invalidateControlValues();
+
 	void eventAvailable();
 
 	std::map<unsigned int, struct v4l2_query_ext_ctrl> controlInfo_;
@@ -88,6 +120,12 @@ private:
 
 	EventNotifier *fdEventNotifier_;
 	bool frameStartEnabled_;
+
+	std::vector<ControlTemplate> controlTemplates_;
+	std::vector<v4l2_ext_control> v4l2Ctrls_;
+	std::vector<unsigned int> v4l2CtrlIndices_;
+	std::unordered_map<unsigned int, ControlValue> controlValues_;
+	ControlStatistics controlStats_;
 };
 
 } /* namespace libcamera */
@@ -271,6 +271,7 @@ private:
 	template<typename T>
 	static std::optional<ColorSpace> toColorSpace(const T &v4l2Format);
 
+	const MediaEntity *entity_;
 	V4L2Capability caps_;
 	V4L2DeviceFormat format_;
 	const PixelFormatInfo *formatInfo_;
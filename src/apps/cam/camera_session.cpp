@@ -207,11 +207,12 @@ int CameraSession::start()
 #endif
 
 	if (options_.isSet(OptFile)) {
-		if (!options_[OptFile].toString().empty())
-			sink_ = std::make_unique<FileSink>(camera_.get(), streamNames_,
-							   options_[OptFile]);
-		else
-			sink_ = std::make_unique<FileSink>(camera_.get(), streamNames_);
+		FileSink::Backend backend = options_.isSet(OptFileUring)
+					  ? FileSink::Backend::Uring
+					  : FileSink::Backend::Sync;
+
+		sink_ = std::make_unique<FileSink>(camera_.get(), streamNames_,
+						   options_[OptFile].toString(), backend);
 	}
 
 	if (sink_) {
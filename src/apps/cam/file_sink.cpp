@@ -5,6 +5,7 @@
  * file_sink.cpp - File Sink
  */
 
+#include <algorithm>
 #include <assert.h>
 #include <fcntl.h>
 #include <iomanip>
@@ -19,22 +20,28 @@
 #include "../common/image.h"
 
 #include "file_sink.h"
+#ifdef HAVE_LIBURING
+#include "uring_writer.h"
+#endif
 
 using namespace libcamera;
 
 FileSink::FileSink([[maybe_unused]] const libcamera::Camera *camera,
 		   const std::map<const libcamera::Stream *, std::string> &streamNames,
-		   const std::string &pattern)
+		   const std::string &pattern, Backend backend)
 	:
 #ifdef HAVE_TIFF
 	  camera_(camera),
 #endif
-	  streamNames_(streamNames), pattern_(pattern)
+	  streamNames_(streamNames), pattern_(pattern), backend_(backend)
 {
 }
 
 FileSink::~FileSink()
 {
+#ifdef HAVE_LIBURING
+	closeFiles();
+#endif
 }
 
 int FileSink::configure(const libcamera::CameraConfiguration &config)
@@ -55,28 +62,86 @@ void FileSink::mapBuffer(FrameBuffer *buffer)
 	mappedBuffers_[buffer] = std::move(image);
 }
 
+int FileSink::start()
+{
+	if (backend_ != Backend::Uring)
+		return FrameSink::start();
+
+#ifdef HAVE_LIBURING
+	/*
+	 * Size the ring to hold all the planes of all the buffers, as they may
+	 * all be in flight at the same time.
+	 */
+	std::vector<Span<uint8_t>> planes;
+	for (const auto &[buffer, image] : mappedBuffers_) {
+		for (unsigned int i = 0; i < image->numPlanes(); ++i)
+			planes.push_back(image->data(i));
+	}
+
+	uring_ = UringWriter::create(std::max<size_t>(planes.size(), 8));
+	if (!uring_) {
+		std::cerr << "Falling back to synchronous file writes"
+			  << std::endl;
+		return FrameSink::start();
+	}
+
+	uring_->writeDone.connect(this, &FileSink::writeDone);
+
+	int ret = uring_->registerBuffers(planes);
+	if (ret < 0)
+		std::cerr << "Failed to register buffers with io_uring: "
+			  << strerror(-ret) << std::endl;
+#else
+	std::cerr << "io_uring support not available, "
+		  << "falling back to synchronous file writes" << std::endl;
+#endif
+
+	return FrameSink::start();
+}
+
+int FileSink::stop()
+{
+#ifdef HAVE_LIBURING
+	if (uring_) {
+		/*
+		 * Wait for all writes to complete before the buffers get
+		 * unmapped. Pending requests are then dropped, the camera has
+		 * been stopped already.
+		 */
+		uring_->writeDone.disconnect(this);
+		uring_->flush();
+		uring_.reset();
+	}
+
+	pending_.clear();
+	closeFiles();
+#endif
+
+	return FrameSink::stop();
+}
+
 bool FileSink::processRequest(Request *request)
 {
+#ifdef HAVE_LIBURING
+	if (uring_)
+		return queueRequest(request);
+#endif
+
 	for (auto [stream, buffer] : request->buffers())
 		writeBuffer(stream, buffer, request->metadata());
 
 	return true;
 }
 
-void FileSink::writeBuffer(const Stream *stream, FrameBuffer *buffer,
-			   [[maybe_unused]] const ControlList &metadata)
+std::string FileSink::fileName(const Stream *stream, const FrameBuffer *buffer,
+			       bool *append)
 {
 	std::string filename;
 	size_t pos;
-	int fd, ret = 0;
 
 	if (!pattern_.empty())
 		filename = pattern_;
 
-#ifdef HAVE_TIFF
-	bool dng = filename.find(".dng", filename.size() - 4) != std::string::npos;
-#endif /* HAVE_TIFF */
-
 	if (filename.empty() || filename.back() == '/')
 		filename += "frame-#.bin";
 
@@ -88,6 +153,23 @@ void FileSink::writeBuffer(const Stream *stream, FrameBuffer *buffer,
 		filename.replace(pos, 1, ss.str());
 	}
 
+	*append = pos == std::string::npos;
+
+	return filename;
+}
+
+void FileSink::writeBuffer(const Stream *stream, FrameBuffer *buffer,
+			   [[maybe_unused]] const ControlList &metadata)
+{
+	bool append;
+	int fd, ret = 0;
+
+	std::string filename = fileName(stream, buffer, &append);
+
+#ifdef HAVE_TIFF
+	bool dng = filename.find(".dng", filename.size() - 4) != std::string::npos;
+#endif /* HAVE_TIFF */
+
 	Image *image = mappedBuffers_[buffer].get();
 
 #ifdef HAVE_TIFF
@@ -104,7 +186,7 @@ void FileSink::writeBuffer(const Stream *stream, FrameBuffer *buffer,
 #endif /* HAVE_TIFF */
 
 	fd = open(filename.c_str(), O_CREAT | O_WRONLY |
-		  (pos == std::string::npos ? O_APPEND : O_TRUNC),
+		  (append ? O_APPEND : O_TRUNC),
 		  S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH);
 	if (fd == -1) {
 		ret = -errno;
@@ -145,3 +227,149 @@ void FileSink::writeBuffer(const Stream *stream, FrameBuffer *buffer,
 
 	close(fd);
 }
+
+#ifdef HAVE_LIBURING
+bool FileSink::queueRequest(Request *request)
+{
+	PendingRequest &pending = pending_[request];
+	pending.writes = 0;
+
+	for (auto [stream, buffer] : request->buffers()) {
+		bool append;
+		std::string filename = fileName(stream, buffer, &append);
+
+#ifdef HAVE_TIFF
+		/* DNG files are written synchronously by libtiff. */
+		if (filename.find(".dng", filename.size() - 4) != std::string::npos) {
+			writeBuffer(stream, buffer, request->metadata());
+			continue;
+		}
+#endif /* HAVE_TIFF */
+
+		pending.writes += queueBuffer(request, filename, append, buffer,
+					      &pending);
+	}
+
+	if (!pending.writes) {
+		for (int fd : pending.fds)
+			close(fd);
+
+		pending_.erase(request);
+		return true;
+	}
+
+	/* Submit the writes for all planes of all streams in one go. */
+	uring_->submit();
+
+	return false;
+}
+
+unsigned int FileSink::queueBuffer(Request *request, const std::string &filename,
+				   bool append, FrameBuffer *buffer,
+				   PendingRequest *pending)
+{
+	AppendFile *file = nullptr;
+	off_t offset = 0;
+	int fd;
+
+	/*
+	 * Writes complete out of order, so O_APPEND can't be used to serialize
+	 * frames in a single file. Keep the file open instead and track the
+	 * write offset explicitly.
+	 */
+	if (append) {
+		auto iter = appendFiles_.find(filename);
+		if (iter == appendFiles_.end()) {
+			fd = open(filename.c_str(), O_CREAT | O_WRONLY,
+				  S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH);
+			if (fd >= 0) {
+				off_t end = lseek(fd, 0, SEEK_END);
+				iter = appendFiles_.insert({ filename, { fd, end < 0 ? 0 : end } }).first;
+			}
+		}
+
+		if (iter != appendFiles_.end()) {
+			file = &iter->second;
+			fd = file->fd;
+			offset = file->offset;
+		}
+	} else {
+		fd = open(filename.c_str(), O_CREAT | O_WRONLY | O_TRUNC,
+			  S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH);
+		if (fd >= 0)
+			pending->fds.push_back(fd);
+	}
+
+	if (fd == -1) {
+		int ret = -errno;
+		std::cerr << "failed to open file " << filename << ": "
+			  << strerror(-ret) << std::endl;
+		return 0;
+	}
+
+	Image *image = mappedBuffers_[buffer].get();
+	unsigned int writes = 0;
+
+	for (unsigned int i = 0; i < buffer->planes().size(); ++i) {
+		const unsigned int bytesused = buffer->metadata().planes()[i].bytesused;
+
+		Span<uint8_t> data = image->data(i);
+		const unsigned int length = std::min<unsigned int>(bytesused, data.size());
+
+		if (bytesused > data.size())
+			std::cerr << "payload size " << bytesused
+				  << " larger than plane size " << data.size()
+				  << std::endl;
+
+		int ret = uring_->write(fd, data.subspan(0, length), offset, request);
+		if (ret < 0) {
+			std::cerr << "failed to queue write: " << strerror(-ret)
+				  << std::endl;
+			break;
+		}
+
+		offset += length;
+		writes++;
+	}
+
+	if (file)
+		file->offset = offset;
+
+	return writes;
+}
+
+void FileSink::writeDone(void *tag, int result)
+{
+	Request *request = static_cast<Request *>(tag);
+
+	/*
+	 * Short writes are completed by the UringWriter, only errors are
+	 * reported here.
+	 */
+	if (result < 0)
+		std::cerr << "write error: " << strerror(-result) << std::endl;
+
+	auto iter = pending_.find(request);
+	if (iter == pending_.end())
+		return;
+
+	PendingRequest &pending = iter->second;
+	if (--pending.writes)
+		return;
+
+	for (int fd : pending.fds)
+		close(fd);
+
+	pending_.erase(iter);
+
+	requestProcessed.emit(request);
+}
+
+void FileSink::closeFiles()
+{
+	for (const auto &[filename, file] : appendFiles_)
+		close(file.fd);
+
+	appendFiles_.clear();
+}
+#endif /* HAVE_LIBURING */
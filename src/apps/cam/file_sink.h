@@ -10,36 +10,78 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <sys/types.h>
+#include <vector>
 
 #include <libcamera/stream.h>
 
 #include "frame_sink.h"
 
 class Image;
+#ifdef HAVE_LIBURING
+class UringWriter;
+#endif
 
 class FileSink : public FrameSink
 {
 public:
+	enum class Backend {
+		Sync,
+		Uring,
+	};
+
 	FileSink(const libcamera::Camera *camera,
 		 const std::map<const libcamera::Stream *, std::string> &streamNames,
-		 const std::string &pattern = "");
+		 const std::string &pattern = "",
+		 Backend backend = Backend::Sync);
 	~FileSink();
 
 	int configure(const libcamera::CameraConfiguration &config) override;
 
 	void mapBuffer(libcamera::FrameBuffer *buffer) override;
 
+	int start() override;
+	int stop() override;
+
 	bool processRequest(libcamera::Request *request) override;
 
 private:
+	std::string fileName(const libcamera::Stream *stream,
+			     const libcamera::FrameBuffer *buffer,
+			     bool *append);
 	void writeBuffer(const libcamera::Stream *stream,
 			 libcamera::FrameBuffer *buffer,
 			 const libcamera::ControlList &metadata);
 
+#ifdef HAVE_LIBURING
+	struct PendingRequest {
+		unsigned int writes;
+		std::vector<int> fds;
+	};
+
+	struct AppendFile {
+		int fd;
+		off_t offset;
+	};
+
+	bool queueRequest(libcamera::Request *request);
+	unsigned int queueBuffer(libcamera::Request *request,
+				 const std::string &filename, bool append,
+				 libcamera::FrameBuffer *buffer,
+				 PendingRequest *pending);
+	void writeDone(void *tag, int result);
+	void closeFiles();
+
+	std::unique_ptr<UringWriter> uring_;
+	std::map<libcamera::Request *, PendingRequest> pending_;
+	std::map<std::string, AppendFile> appendFiles_;
+#endif
+
 #ifdef HAVE_TIFF
 	const libcamera::Camera *camera_;
 #endif
 	std::map<const libcamera::Stream *, std::string> streamNames_;
 	std::string pattern_;
+	Backend backend_;
 	std::map<libcamera::FrameBuffer *, std::unique_ptr<Image>> mappedBuffers_;
 };
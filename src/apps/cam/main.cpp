@@ -152,6 +152,13 @@ int CamApp::parseOptions(int argc, char *argv[])
 			 "The default file name is 'frame-#.bin'.",
 			 "file", ArgumentOptional, "filename", false,
 			 OptCamera);
+#ifdef HAVE_LIBURING
+	parser.addOption(OptFileUring, OptionNone,
+			 "Write captured frames to disk asynchronously with io_uring\n"
+			 "This option applies to --file. If io_uring isn't supported by\n"
+			 "the kernel, frames are written synchronously.",
+			 "file-uring", ArgumentNone, nullptr, false, OptCamera);
+#endif
 #ifdef HAVE_SDL
 	parser.addOption(OptSDL, OptionNone, "Display viewfinder through SDL",
 			 "sdl", ArgumentNone, "", false, OptCamera);
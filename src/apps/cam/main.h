@@ -23,4 +23,5 @@ enum {
 	OptStrictFormats = 257,
 	OptMetadata = 258,
 	OptCaptureScript = 259,
+	OptFileUring = 260,
 };
@@ -0,0 +1,289 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright (C) 2026, Ideas on Board Oy
+ *
+ * uring_writer.cpp - Asynchronous file writer based on io_uring
+ */
+
+#include "uring_writer.h"
+
+#include <errno.h>
+#include <iostream>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "../common/event_loop.h"
+
+using namespace libcamera;
+
+/*
+ * The UringWriter submits file writes through an io_uring instance. Writes are
+ * queued with write() and handed to the kernel in a single batch by submit(),
+ * replacing one write() system call per plane with one io_uring_enter() per
+ * request. Completions are signalled through an eventfd monitored by the
+ * EventLoop, and reported to the user through the writeDone signal with the
+ * tag passed to write() and the number of bytes written, or a negative error
+ * code. Short writes are resubmitted for the remaining data, a write is thus
+ * only reported once all its data has been written or an error occurred.
+ *
+ * Buffers registered with registerBuffers() are written with fixed-buffer
+ * operations, sparing the kernel from pinning the pages on every write.
+ */
+
+UringWriter::UringWriter()
+	: ringValid_(false), eventfd_(-1), inflight_(0), queued_(0)
+{
+}
+
+UringWriter::~UringWriter()
+{
+	if (eventfd_ >= 0) {
+		EventLoop::instance()->removeFdEvent(eventfd_);
+		close(eventfd_);
+	}
+
+	if (ringValid_)
+		io_uring_queue_exit(&ring_);
+}
+
+/*
+ * Create a writer with a submission queue of \a depth entries. Return a null
+ * pointer if io_uring is not available, in which case the caller shall fall
+ * back to synchronous writes.
+ */
+std::unique_ptr<UringWriter> UringWriter::create(unsigned int depth)
+{
+	std::unique_ptr<UringWriter> writer{ new UringWriter() };
+
+	int ret = writer->init(depth);
+	if (ret < 0) {
+		std::cerr << "io_uring unavailable: " << strerror(-ret)
+			  << std::endl;
+		return nullptr;
+	}
+
+	return writer;
+}
+
+int UringWriter::init(unsigned int depth)
+{
+	int ret = io_uring_queue_init(depth, &ring_, 0);
+	if (ret < 0)
+		return ret;
+
+	ringValid_ = true;
+
+	eventfd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+	if (eventfd_ < 0)
+		return -errno;
+
+	ret = io_uring_register_eventfd(&ring_, eventfd_);
+	if (ret < 0)
+		return ret;
+
+	EventLoop::instance()->addFdEvent(eventfd_, EventLoop::Read,
+					  [this]() { processCompletions(); });
+
+	return 0;
+}
+
+int UringWriter::registerBuffers(const std::vector<Span<uint8_t>> &buffers)
+{
+	if (!registered_.empty()) {
+		io_uring_unregister_buffers(&ring_);
+		registered_.clear();
+	}
+
+	std::vector<struct iovec> iovecs;
+	iovecs.reserve(buffers.size());
+
+	for (const Span<uint8_t> &buffer : buffers)
+		iovecs.push_back({ buffer.data(), buffer.size() });
+
+	/*
+	 * Registration pins the pages of the buffers, which isn't possible for
+	 * all memory types (in particular some dmabuf exporters map buffers
+	 * with VM_PFNMAP) and is subject to RLIMIT_MEMLOCK. Failures are not
+	 * fatal, writes will then use the non-fixed operations.
+	 */
+	int ret = io_uring_register_buffers(&ring_, iovecs.data(), iovecs.size());
+	if (ret < 0)
+		return ret;
+
+	registered_ = buffers;
+
+	return 0;
+}
+
+int UringWriter::registeredIndex(Span<const uint8_t> data) const
+{
+	for (unsigned int i = 0; i < registered_.size(); ++i) {
+		const Span<uint8_t> &buffer = registered_[i];
+
+		if (data.data() >= buffer.data() &&
+		    data.data() + data.size() <= buffer.data() + buffer.size())
+			return i;
+	}
+
+	return -1;
+}
+
+int UringWriter::write(int fd, Span<const uint8_t> data, off_t offset,
+		       void *tag)
+{
+	unsigned int slot;
+	if (!freeWrites_.empty()) {
+		slot = freeWrites_.back();
+		freeWrites_.pop_back();
+	} else {
+		slot = writes_.size();
+		writes_.emplace_back();
+	}
+
+	writes_[slot] = { tag, fd, data, offset, 0 };
+
+	int ret = queue(slot);
+	if (ret < 0) {
+		freeWrites_.push_back(slot);
+		return ret;
+	}
+
+	return 0;
+}
+
+/* Queue a write operation for the remaining data of the write in \a slot. */
+int UringWriter::queue(unsigned int slot)
+{
+	const Write &write = writes_[slot];
+	Span<const uint8_t> data = write.data.subspan(write.written);
+	off_t offset = write.offset + write.written;
+
+	struct io_uring_sqe *sqe = io_uring_get_sqe(&ring_);
+	if (!sqe) {
+		/*
+		 * The submission queue is full. Submitting the pending entries
+		 * frees all submission queue slots.
+		 */
+		int ret = submit();
+		if (ret < 0)
+			return ret;
+
+		sqe = io_uring_get_sqe(&ring_);
+		if (!sqe)
+			return -EBUSY;
+	}
+
+	int index = registeredIndex(data);
+	if (index >= 0)
+		io_uring_prep_write_fixed(sqe, write.fd, data.data(), data.size(),
+					  offset, index);
+	else
+		io_uring_prep_write(sqe, write.fd, data.data(), data.size(),
+				    offset);
+
+	io_uring_sqe_set_data64(sqe, slot);
+
+	queued_++;
+
+	return 0;
+}
+
+int UringWriter::submit()
+{
+	if (!queued_)
+		return 0;
+
+	int ret = io_uring_submit(&ring_);
+	if (ret < 0) {
+		std::cerr << "io_uring submission failed: " << strerror(-ret)
+			  << std::endl;
+		return ret;
+	}
+
+	inflight_ += ret;
+	queued_ -= ret;
+
+	return 0;
+}
+
+/*
+ * Wait for all in-flight writes to complete. This is used when stopping, as
+ * buffers must not be unmapped or reused while the kernel may still access
+ * them.
+ */
+void UringWriter::flush()
+{
+	while (inflight_ || queued_) {
+		/* Submit the queued writes and remainders of short writes. */
+		if (submit() < 0)
+			break;
+
+		struct io_uring_cqe *cqe;
+
+		int ret = io_uring_wait_cqe(&ring_, &cqe);
+		if (ret < 0) {
+			if (ret == -EINTR)
+				continue;
+
+			std::cerr << "io_uring wait failed: " << strerror(-ret)
+				  << std::endl;
+			break;
+		}
+
+		complete(cqe);
+	}
+}
+
+void UringWriter::complete(struct io_uring_cqe *cqe)
+{
+	unsigned int slot = io_uring_cqe_get_data64(cqe);
+	int result = cqe->res;
+
+	io_uring_cqe_seen(&ring_, cqe);
+	inflight_--;
+
+	Write &write = writes_[slot];
+
+	/*
+	 * On short writes, queue the remaining data. It will be submitted
+	 * with the next batch. A write that makes no progress would never
+	 * complete, report it as an I/O error.
+	 */
+	if (result == 0 && write.written < write.data.size())
+		result = -EIO;
+
+	if (result > 0) {
+		write.written += result;
+		if (write.written < write.data.size()) {
+			result = queue(slot);
+			if (!result)
+				return;
+		}
+	}
+
+	if (result >= 0)
+		result = write.written;
+
+	void *tag = write.tag;
+	freeWrites_.push_back(slot);
+
+	writeDone.emit(tag, result);
+}
+
+void UringWriter::processCompletions()
+{
+	uint64_t count;
+	ssize_t ret = read(eventfd_, &count, sizeof(count));
+	if (ret < 0 && errno != EAGAIN)
+		std::cerr << "Failed to read eventfd: " << strerror(errno)
+			  << std::endl;
+
+	struct io_uring_cqe *cqe;
+	while (io_uring_peek_cqe(&ring_, &cqe) == 0)
+		complete(cqe);
+
+	/* Submit the remainders of short writes. */
+	submit();
+}
@@ -0,0 +1,64 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright (C) 2026, Ideas on Board Oy
+ *
+ * uring_writer.h - Asynchronous file writer based on io_uring
+ */
+
+#pragma once
+
+#include <memory>
+#include <stdint.h>
+#include <sys/types.h>
+#include <vector>
+
+#include <liburing.h>
+
+#include <libcamera/base/signal.h>
+#include <libcamera/base/span.h>
+
+class UringWriter
+{
+public:
+	static std::unique_ptr<UringWriter> create(unsigned int depth);
+	~UringWriter();
+
+	int registerBuffers(const std::vector<libcamera::Span<uint8_t>> &buffers);
+
+	int write(int fd, libcamera::Span<const uint8_t> data, off_t offset,
+		  void *tag);
+	int submit();
+	void flush();
+
+	unsigned int inflight() const { return inflight_; }
+
+	libcamera::Signal<void *, int> writeDone;
+
+private:
+	struct Write {
+		void *tag;
+		int fd;
+		libcamera::Span<const uint8_t> data;
+		off_t offset;
+		size_t written;
+	};
+
+	UringWriter();
+
+	int init(unsigned int depth);
+	int registeredIndex(libcamera::Span<const uint8_t> data) const;
+	int queue(unsigned int slot);
+	void complete(struct io_uring_cqe *cqe);
+	void processCompletions();
+
+	struct io_uring ring_;
+	bool ringValid_;
+	int eventfd_;
+
+	std::vector<libcamera::Span<uint8_t>> registered_;
+
+	std::vector<Write> writes_;
+	std::vector<unsigned int> freeWrites_;
+	unsigned int inflight_;
+	unsigned int queued_;
+};
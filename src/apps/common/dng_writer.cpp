@@ -10,6 +10,8 @@
 #include <algorithm>
 #include <iostream>
 #include <map>
+#include <thread>
+#include <vector>
 
 #include <tiffio.h>
 
@@ -139,14 +141,44 @@ void packScanlineSBGGR10P(void *output, const void *input, unsigned int width)
 	const uint8_t *in = static_cast<const uint8_t *>(input);
 	uint8_t *out = static_cast<uint8_t *>(output);
 
-	/* \todo Can this be made more efficient? */
-	for (unsigned int x = 0; x < width; x += 4) {
-		*out++ = in[0];
-		*out++ = (in[4] & 0x03) << 6 | in[1] >> 2;
-		*out++ = (in[1] & 0x03) << 6 | (in[4] & 0x0c) << 2 | in[2] >> 4;
-		*out++ = (in[2] & 0x0f) << 4 | (in[4] & 0x30) >> 2 | in[3] >> 6;
-		*out++ = (in[3] & 0x3f) << 2 | (in[4] & 0xc0) >> 6;
+	/*
+	 * Repack groups of 4 pixels from the CSI-2 layout (4 bytes of MSBs
+	 * followed by one byte of LSBs) to a big-endian 40-bit word. The
+	 * iterations are independent and branchless, allowing the compiler to
+	 * vectorize the loop.
+	 */
+	const unsigned int groups = width / 4;
+	for (unsigned int i = 0; i < groups; i++) {
+		const uint64_t value =
+			static_cast<uint64_t>(in[0] << 2 | (in[4] & 0x03)) << 30 |
+			static_cast<uint64_t>(in[1] << 2 | (in[4] & 0x0c) >> 2) << 20 |
+			static_cast<uint64_t>(in[2] << 2 | (in[4] & 0x30) >> 4) << 10 |
+			static_cast<uint64_t>(in[3] << 2 | (in[4] & 0xc0) >> 6);
+
+		out[0] = value >> 32;
+		out[1] = value >> 24;
+		out[2] = value >> 16;
+		out[3] = value >> 8;
+		out[4] = value;
+
 		in += 5;
+		out += 5;
+	}
+
+	/*
+	 * Handle the last incomplete group, if any. The input lines are padded
+	 * to a multiple of 4 pixels, but only the bytes that belong to the
+	 * line can be written to the output.
+	 */
+	const unsigned int remaining = width % 4;
+	if (remaining) {
+		uint64_t value = 0;
+		for (unsigned int i = 0; i < remaining; i++)
+			value |= static_cast<uint64_t>(in[i] << 2 | ((in[4] >> (i * 2)) & 0x03))
+			      << (30 - i * 10);
+
+		for (unsigned int i = 0; i < (remaining * 10 + 7) / 8; i++)
+			out[i] = value >> (32 - i * 8);
 	}
 }
 
@@ -155,12 +187,23 @@ void packScanlineSBGGR12P(void *output, const void *input, unsigned int width)
 	const uint8_t *in = static_cast<const uint8_t *>(input);
 	uint8_t *out = static_cast<uint8_t *>(output);
 
-	/* \todo Can this be made more efficient? */
-	for (unsigned int i = 0; i < width; i += 2) {
-		*out++ = in[0];
-		*out++ = (in[2] & 0x0f) << 4 | in[1] >> 4;
-		*out++ = (in[1] & 0x0f) << 4 | in[2] >> 4;
+	/* Repack groups of 2 pixels to a big-endian 24-bit word. */
+	const unsigned int groups = width / 2;
+	for (unsigned int i = 0; i < groups; i++) {
+		const uint32_t value = (in[0] << 4 | (in[2] & 0x0f)) << 12 |
+				       (in[1] << 4 | (in[2] & 0xf0) >> 4);
+
+		out[0] = value >> 16;
+		out[1] = value >> 8;
+		out[2] = value;
+
 		in += 3;
+		out += 3;
+	}
+
+	if (width % 2) {
+		out[0] = in[0];
+		out[1] = (in[2] & 0x0f) << 4;
 	}
 }
 
@@ -194,7 +237,33 @@ void packScanlineIPU3(void *output, const void *input, unsigned int width)
 	 *
 	 * \todo Improve packing to keep the 10-bit sample size.
 	 */
-	unsigned int x = 0;
+	auto unpackGroup = [](const uint8_t *src, uint16_t *dst) {
+		dst[0] = (src[1] & 0x03) << 14 | (src[0] & 0xff) << 6;
+		dst[1] = (src[2] & 0x0f) << 12 | (src[1] & 0xfc) << 4;
+		dst[2] = (src[3] & 0x3f) << 10 | (src[2] & 0xf0) << 2;
+		dst[3] = (src[4] & 0xff) <<  8 | (src[3] & 0xc0) << 0;
+	};
+
+	/*
+	 * Process complete blocks of 25 pixels stored in 32 bytes without
+	 * bounds checks, and fall back to per-pixel processing for the last
+	 * incomplete block.
+	 */
+	const unsigned int blocks = width / 25;
+	for (unsigned int b = 0; b < blocks; b++) {
+		for (unsigned int i = 0; i < 6; i++)
+			unpackGroup(in + i * 5, out + i * 4);
+
+		out[24] = (in[31] & 0x03) << 14 | (in[30] & 0xff) << 6;
+
+		in += 32;
+		out += 25;
+	}
+
+	unsigned int x = blocks * 25;
+	if (x >= width)
+		return;
+
 	while (true) {
 		for (unsigned int i = 0; i < 6; i++) {
 			*out++ = (in[1] & 0x03) << 14 | (in[0] & 0xff) << 6;
@@ -380,6 +449,42 @@ static const std::map<PixelFormat, FormatInfo> formatInfo = {
 	} },
 };
 
+/*
+ * Pack the RAW image to the full frame \a output buffer. Lines are split in
+ * horizontal bands that are packed concurrently.
+ */
+static void packFrame(const FormatInfo &info, uint8_t *output,
+		      unsigned int outputStride, const uint8_t *input,
+		      const StreamConfiguration &config)
+{
+	/* Bands smaller than this are not worth the cost of a thread. */
+	static constexpr unsigned int kMinBandHeight = 64;
+
+	const unsigned int height = config.size.height;
+	const unsigned int bands =
+		std::clamp(std::thread::hardware_concurrency(), 1U,
+			   std::max(height / kMinBandHeight, 1U));
+
+	auto packBand = [&](unsigned int band) {
+		unsigned int start = height * band / bands;
+		unsigned int end = height * (band + 1) / bands;
+
+		for (unsigned int y = start; y < end; y++)
+			info.packScanline(output + y * outputStride,
+					  input + y * config.stride,
+					  config.size.width);
+	};
+
+	std::vector<std::thread> threads;
+	for (unsigned int band = 1; band < bands; band++)
+		threads.emplace_back(packBand, band);
+
+	packBand(0);
+
+	for (std::thread &thread : threads)
+		thread.join();
+}
+
 int DNGWriter::write(const char *filename, const Camera *camera,
 		     const StreamConfiguration &config,
 		     const ControlList &metadata,
@@ -401,12 +506,8 @@ int DNGWriter::write(const char *filename, const Camera *camera,
 		return -EINVAL;
 	}
 
-	/*
-	 * Scanline buffer, has to be large enough to store both a RAW scanline
-	 * or a thumbnail scanline. The latter will always be much smaller than
-	 * the former as we downscale by 16 in both directions.
-	 */
-	uint8_t scanline[(config.size.width * info->bitsPerSample + 7) / 8];
+	/* Thumbnail scanline buffer, 8-bit RGB downscaled by 16. */
+	std::vector<uint8_t> scanline(config.size.width / 16 * 3);
 
 	toff_t rawIFDOffset = 0;
 	toff_t exifIFDOffset = 0;
@@ -506,10 +607,10 @@ int DNGWriter::write(const char *filename, const Camera *camera,
 	/* Write the thumbnail. */
 	const uint8_t *row = static_cast<const uint8_t *>(data);
 	for (unsigned int y = 0; y < config.size.height / 16; y++) {
-		info->thumbScanline(*info, &scanline, row,
+		info->thumbScanline(*info, scanline.data(), row,
 				    config.size.width / 16, config.stride);
 
-		if (TIFFWriteScanline(tif, &scanline, y, 0) != 1) {
+		if (TIFFWriteScanline(tif, scanline.data(), y, 0) != 1) {
 			std::cerr << "Failed to write thumbnail scanline"
 				  << std::endl;
 			TIFFClose(tif);
@@ -589,19 +690,22 @@ int DNGWriter::write(const char *filename, const Camera *camera,
 	TIFFSetField(tif, TIFFTAG_BLACKLEVEL, 4, &blackLevel);
 	TIFFSetField(tif, TIFFTAG_WHITELEVEL, 1, &whiteLevel);
 
-	/* Write RAW content. */
-	row = static_cast<const uint8_t *>(data);
-	for (unsigned int y = 0; y < config.size.height; y++) {
-		info->packScanline(&scanline, row, config.size.width);
+	/*
+	 * Write RAW content. Pack the whole image first and write it as a
+	 * single strip, avoiding the per-line overhead of TIFFWriteScanline().
+	 */
+	const unsigned int rawStride = (config.size.width * info->bitsPerSample + 7) / 8;
+	std::vector<uint8_t> raw(rawStride * config.size.height);
 
-		if (TIFFWriteScanline(tif, &scanline, y, 0) != 1) {
-			std::cerr << "Failed to write RAW scanline"
-				  << std::endl;
-			TIFFClose(tif);
-			return -EINVAL;
-		}
+	packFrame(*info, raw.data(), rawStride,
+		  static_cast<const uint8_t *>(data), config);
 
-		row += config.stride;
+	TIFFSetField(tif, TIFFTAG_ROWSPERSTRIP, config.size.height);
+
+	if (TIFFWriteEncodedStrip(tif, 0, raw.data(), raw.size()) < 0) {
+		std::cerr << "Failed to write RAW strip" << std::endl;
+		TIFFClose(tif);
+		return -EINVAL;
 	}
 
 	/* Checkpoint the IFD to retrieve its offset, and write it out. */
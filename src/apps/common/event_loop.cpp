@@ -84,6 +84,13 @@ void EventLoop::addFdEvent(int fd, EventType type,
 	events_.push_back(std::move(event));
 }
 
+void EventLoop::removeFdEvent(int fd)
+{
+	events_.remove_if([fd](const std::unique_ptr<Event> &event) {
+		return event_get_fd(event->event_) == fd;
+	});
+}
+
 void EventLoop::addTimerEvent(const std::chrono::microseconds period,
 			      const std::function<void()> &callback)
 {
@@ -37,6 +37,7 @@ public:
 
 	void addFdEvent(int fd, EventType type,
 			const std::function<void()> &handler);
+	void removeFdEvent(int fd);
 
 	using duration = std::chrono::steady_clock::duration;
 	void addTimerEvent(const std::chrono::microseconds period,
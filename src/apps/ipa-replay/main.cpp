@@ -0,0 +1,539 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright (C) 2026, Ideas on Board Oy
+ *
+ * main.cpp - Replay a recording of the RkISP1 IPA interface calls
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <libgen.h>
+#include <map>
+#include <memory>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <vector>
+
+#include <linux/rkisp1-config.h>
+
+#include <libcamera/base/file.h>
+#include <libcamera/base/shared_fd.h>
+#include <libcamera/base/span.h>
+#include <libcamera/base/unique_fd.h>
+
+#include <libcamera/control_ids.h>
+#include <libcamera/controls.h>
+#include <libcamera/framebuffer.h>
+#include <libcamera/ipa/rkisp1_ipa_interface.h>
+#include <libcamera/ipa/rkisp1_ipa_serializer.h>
+
+#include "libcamera/internal/control_serializer.h"
+#include "libcamera/internal/ipa_recording.h"
+#include "libcamera/internal/ipa_module.h"
+
+using namespace libcamera;
+using namespace libcamera::ipa::rkisp1;
+
+namespace {
+
+constexpr unsigned int kParamsBufferId = 1;
+constexpr unsigned int kStatsBufferId = 2;
+
+/* Split a record payload in chunks */
+class ChunkReader
+{
+public:
+	ChunkReader(Span<const uint8_t> data)
+		: data_(data)
+	{
+	}
+
+	bool next(std::vector<uint8_t> *chunk)
+	{
+		uint32_t size;
+
+		if (data_.size() < sizeof(size))
+			return false;
+
+		memcpy(&size, data_.data(), sizeof(size));
+		data_ = data_.subspan(sizeof(size));
+
+		if (data_.size() < size)
+			return false;
+
+		chunk->assign(data_.begin(), data_.begin() + size);
+		data_ = data_.subspan(size);
+
+		return true;
+	}
+
+private:
+	Span<const uint8_t> data_;
+};
+
+/* A buffer shared with the IPA module, backed by anonymous memory */
+class ReplayBuffer
+{
+public:
+	ReplayBuffer()
+		: mem_(nullptr), size_(0)
+	{
+	}
+
+	~ReplayBuffer()
+	{
+		if (mem_)
+			munmap(mem_, size_);
+	}
+
+	int create(const char *name, size_t size)
+	{
+		UniqueFD fd(memfd_create(name, MFD_CLOEXEC));
+		if (!fd.isValid())
+			return -errno;
+
+		if (ftruncate(fd.get(), size) < 0)
+			return -errno;
+
+		void *mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+				 fd.get(), 0);
+		if (mem == MAP_FAILED)
+			return -errno;
+
+		mem_ = static_cast<uint8_t *>(mem);
+		size_ = size;
+		fd_ = SharedFD(std::move(fd));
+
+		return 0;
+	}
+
+	IPABuffer ipaBuffer(unsigned int id) const
+	{
+		FrameBuffer::Plane plane;
+		plane.fd = fd_;
+		plane.offset = 0;
+		plane.length = size_;
+
+		return IPABuffer(id, { plane });
+	}
+
+	Span<uint8_t> data() { return { mem_, size_ }; }
+
+private:
+	SharedFD fd_;
+	uint8_t *mem_;
+	size_t size_;
+};
+
+struct CallStats {
+	CallStats()
+		: count(0), total(0), max(0)
+	{
+	}
+
+	void add(std::chrono::nanoseconds duration)
+	{
+		count++;
+		total += duration;
+		max = std::max(max, duration);
+	}
+
+	unsigned int count;
+	std::chrono::nanoseconds total;
+	std::chrono::nanoseconds max;
+};
+
+class Replayer
+{
+public:
+	Replayer(IPARkISP1Interface *ipa, const std::string &tuningFile)
+		: ipa_(ipa), tuningFile_(tuningFile),
+		  serializer_(ControlSerializer::Role::Worker), mapped_(false)
+	{
+		ipa_->paramsBufferReady.connect(this, &Replayer::paramsBufferReady);
+		ipa_->metadataReady.connect(this, &Replayer::metadataReady);
+		ipa_->setSensorControls.connect(this, &Replayer::setSensorControls);
+	}
+
+	int run(Span<const uint8_t> recording);
+
+private:
+	int replay(const struct ipa_record_header &header, ChunkReader &chunks);
+	int mapBuffers();
+
+	void paramsBufferReady(unsigned int frame);
+	void metadataReady(unsigned int frame, const ControlList &metadata);
+	void setSensorControls(unsigned int frame, const ControlList &sensorControls);
+
+	void printSummary();
+
+	IPARkISP1Interface *ipa_;
+	std::string tuningFile_;
+
+	ControlSerializer serializer_;
+	ReplayBuffer params_;
+	ReplayBuffer stats_;
+	bool mapped_;
+
+	CallStats queueRequestStats_;
+	CallStats fillParamsStats_;
+	CallStats processStatsStats_;
+};
+
+int Replayer::run(Span<const uint8_t> recording)
+{
+	struct ipa_recording_header header;
+
+	if (recording.size() < sizeof(header)) {
+		std::cerr << "Recording too short" << std::endl;
+		return -EINVAL;
+	}
+
+	memcpy(&header, recording.data(), sizeof(header));
+	recording = recording.subspan(sizeof(header));
+
+	if (memcmp(header.magic, IPA_RECORDING_MAGIC, sizeof(header.magic)) ||
+	    header.version != IPA_RECORDING_FORMAT_VERSION) {
+		std::cerr << "Invalid recording format" << std::endl;
+		return -EINVAL;
+	}
+
+	header.pipeline[sizeof(header.pipeline) - 1] = '\0';
+	if (strcmp(header.pipeline, "rkisp1")) {
+		std::cerr << "Unsupported recording for pipeline "
+			  << header.pipeline << std::endl;
+		return -EINVAL;
+	}
+
+	while (!recording.empty()) {
+		struct ipa_record_header record;
+
+		if (recording.size() < sizeof(record)) {
+			std::cerr << "Truncated record header" << std::endl;
+			return -EINVAL;
+		}
+
+		memcpy(&record, recording.data(), sizeof(record));
+		recording = recording.subspan(sizeof(record));
+
+		if (recording.size() < record.size) {
+			std::cerr << "Truncated record" << std::endl;
+			return -EINVAL;
+		}
+
+		ChunkReader chunks(recording.first(record.size));
+		recording = recording.subspan(record.size);
+
+		int ret = replay(record, chunks);
+		if (ret < 0)
+			return ret;
+	}
+
+	printSummary();
+
+	return 0;
+}
+
+int Replayer::replay(const struct ipa_record_header &header, ChunkReader &chunks)
+{
+	std::vector<uint8_t> chunk;
+	int ret;
+
+	switch (header.type) {
+	case IPA_RECORD_INIT: {
+		serializer_.reset();
+
+		if (!chunks.next(&chunk))
+			return -EINVAL;
+		IPASettings settings = IPADataSerializer<IPASettings>::deserialize(chunk);
+
+		if (!chunks.next(&chunk))
+			return -EINVAL;
+		uint32_t hwRevision = IPADataSerializer<uint32_t>::deserialize(chunk);
+
+		if (!chunks.next(&chunk))
+			return -EINVAL;
+		IPACameraSensorInfo sensorInfo =
+			IPADataSerializer<IPACameraSensorInfo>::deserialize(chunk);
+
+		if (!chunks.next(&chunk))
+			return -EINVAL;
+		ControlInfoMap sensorControls =
+			IPADataSerializer<ControlInfoMap>::deserialize(chunk, &serializer_);
+
+		if (!tuningFile_.empty())
+			settings.configurationFile = tuningFile_;
+
+		std::cout << "Sensor " << settings.sensorModel
+			  << ", tuning file " << settings.configurationFile
+			  << std::endl;
+
+		ControlInfoMap ipaControls;
+		ret = ipa_->init(settings, hwRevision, sensorInfo, sensorControls,
+				 &ipaControls);
+		if (ret < 0) {
+			std::cerr << "Failed to initialize the IPA: "
+				  << strerror(-ret) << std::endl;
+			return ret;
+		}
+
+		break;
+	}
+
+	case IPA_RECORD_CONFIGURE: {
+		serializer_.reset();
+
+		if (!chunks.next(&chunk))
+			return -EINVAL;
+		IPAConfigInfo config =
+			IPADataSerializer<IPAConfigInfo>::deserialize(chunk, &serializer_);
+
+		if (!chunks.next(&chunk))
+			return -EINVAL;
+		std::map<uint32_t, IPAStream> streamConfig =
+			IPADataSerializer<std::map<uint32_t, IPAStream>>::deserialize(chunk);
+
+		ControlInfoMap ipaControls;
+		ret = ipa_->configure(config, streamConfig, &ipaControls);
+		if (ret < 0) {
+			std::cerr << "Failed to configure the IPA: "
+				  << strerror(-ret) << std::endl;
+			return ret;
+		}
+
+		break;
+	}
+
+	case IPA_RECORD_START:
+		ret = mapBuffers();
+		if (ret < 0)
+			return ret;
+
+		ret = ipa_->start();
+		if (ret < 0) {
+			std::cerr << "Failed to start the IPA: "
+				  << strerror(-ret) << std::endl;
+			return ret;
+		}
+
+		break;
+
+	case IPA_RECORD_STOP:
+		ipa_->stop();
+		break;
+
+	case IPA_RECORD_QUEUE_REQUEST: {
+		if (!chunks.next(&chunk))
+			return -EINVAL;
+		ControlList controls =
+			IPADataSerializer<ControlList>::deserialize(chunk, &serializer_);
+
+		auto begin = std::chrono::steady_clock::now();
+		ipa_->queueRequest(header.frame, controls);
+		queueRequestStats_.add(std::chrono::steady_clock::now() - begin);
+
+		break;
+	}
+
+	case IPA_RECORD_FILL_PARAMS: {
+		auto begin = std::chrono::steady_clock::now();
+		ipa_->fillParamsBuffer(header.frame, kParamsBufferId);
+		fillParamsStats_.add(std::chrono::steady_clock::now() - begin);
+
+		break;
+	}
+
+	case IPA_RECORD_PROCESS_STATS: {
+		if (!chunks.next(&chunk))
+			return -EINVAL;
+
+		Span<uint8_t> buffer = stats_.data();
+		if (!chunk.empty()) {
+			if (chunk.size() != buffer.size()) {
+				std::cerr << "Statistics size mismatch" << std::endl;
+				return -EINVAL;
+			}
+
+			std::copy(chunk.begin(), chunk.end(), buffer.begin());
+		}
+
+		if (!chunks.next(&chunk))
+			return -EINVAL;
+		ControlList sensorControls =
+			IPADataSerializer<ControlList>::deserialize(chunk, &serializer_);
+
+		auto begin = std::chrono::steady_clock::now();
+		ipa_->processStatsBuffer(header.frame, kStatsBufferId, sensorControls);
+		processStatsStats_.add(std::chrono::steady_clock::now() - begin);
+
+		break;
+	}
+
+	default:
+		std::cerr << "Skipping unknown record type " << header.type
+			  << std::endl;
+		break;
+	}
+
+	return 0;
+}
+
+int Replayer::mapBuffers()
+{
+	if (mapped_)
+		return 0;
+
+	int ret = params_.create("params", sizeof(struct rkisp1_params_cfg));
+	if (ret == 0)
+		ret = stats_.create("stats", sizeof(struct rkisp1_stat_buffer));
+	if (ret < 0) {
+		std::cerr << "Failed to allocate buffers: " << strerror(-ret)
+			  << std::endl;
+		return ret;
+	}
+
+	ipa_->mapBuffers({ params_.ipaBuffer(kParamsBufferId),
+			   stats_.ipaBuffer(kStatsBufferId) });
+	mapped_ = true;
+
+	return 0;
+}
+
+void Replayer::paramsBufferReady(unsigned int frame)
+{
+	/*
+	 * Print a 64-bit FNV-1a hash of the parameters buffer, to compare the
+	 * output of different versions of the algorithms.
+	 */
+	uint64_t hash = 0xcbf29ce484222325ULL;
+	for (uint8_t byte : params_.data()) {
+		hash ^= byte;
+		hash *= 0x100000001b3ULL;
+	}
+
+	std::cout << "frame " << frame << " params " << std::hex
+		  << std::setw(16) << std::setfill('0') << hash << std::dec
+		  << std::endl;
+}
+
+void Replayer::metadataReady(unsigned int frame, const ControlList &metadata)
+{
+	std::cout << "frame " << frame << " metadata";
+
+	for (const auto &[id, value] : metadata) {
+		auto it = controls::controls.find(id);
+		if (it != controls::controls.end())
+			std::cout << " " << it->second->name();
+		else
+			std::cout << " " << id;
+
+		std::cout << "=" << value.toString();
+	}
+
+	std::cout << std::endl;
+}
+
+void Replayer::setSensorControls(unsigned int frame, const ControlList &sensorControls)
+{
+	std::cout << "frame " << frame << " sensor";
+
+	for (const auto &[id, value] : sensorControls)
+		std::cout << " 0x" << std::hex << id << std::dec << "="
+			  << value.toString();
+
+	std::cout << std::endl;
+}
+
+void Replayer::printSummary()
+{
+	auto print = [](const char *name, const CallStats &stats) {
+		if (!stats.count)
+			return;
+
+		std::cout << "  " << std::setw(20) << std::setfill(' ') << std::left
+			  << name << std::right << stats.count << " calls, average "
+			  << stats.total.count() / stats.count / 1000
+			  << "us, max " << stats.max.count() / 1000 << "us"
+			  << std::endl;
+	};
+
+	std::cout << "Processing time:" << std::endl;
+	print("queueRequest", queueRequestStats_);
+	print("fillParamsBuffer", fillParamsStats_);
+	print("processStatsBuffer", processStatsStats_);
+}
+
+void usage(char *argv0)
+{
+	std::cout << "Usage: " << basename(argv0) << " ipa_rkisp1.so recording [tuning.yaml]" << std::endl;
+	std::cout << std::endl;
+	std::cout << "Replay a recording of the IPA interface calls, captured by setting the" << std::endl;
+	std::cout << "LIBCAMERA_RKISP1_RECORD_FILE environment variable, against an IPA module." << std::endl;
+	std::cout << "The tuning file stored in the recording is used unless overridden." << std::endl;
+	std::cout << std::endl;
+	std::cout << "The parameters computed for each frame are printed as a hash, along with" << std::endl;
+	std::cout << "the metadata and sensor controls, for comparison between IPA versions." << std::endl;
+	std::cout << "Per-algorithm processing times are logged by the IPA module in the" << std::endl;
+	std::cout << "IPARkISP1 category." << std::endl;
+}
+
+} /* namespace */
+
+int main(int argc, char **argv)
+{
+	if (argc < 3 || argc > 4) {
+		usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	/*
+	 * Enable profiling in the IPA module and make sure its report is
+	 * logged, unless the user has selected log levels explicitly. This
+	 * must be done before the log categories get created.
+	 */
+	setenv("LIBCAMERA_RKISP1_PROFILE", "1", 1);
+	unsetenv("LIBCAMERA_RKISP1_RECORD_FILE");
+	setenv("LIBCAMERA_LOG_LEVELS", "IPARkISP1:INFO", 0);
+
+	File file{ argv[2] };
+	if (!file.open(File::OpenModeFlag::ReadOnly)) {
+		std::cerr << "Failed to open recording " << argv[2] << ": "
+			  << strerror(-file.error()) << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	Span<uint8_t> recording = file.map();
+	if (recording.empty()) {
+		std::cerr << "Failed to map recording " << argv[2] << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	IPAModule module{ argv[1] };
+	if (!module.isValid() || !module.load()) {
+		std::cerr << "Invalid IPA module " << argv[1] << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	if (strcmp(module.info().name, "rkisp1")) {
+		std::cerr << "Unsupported IPA module " << module.info().name
+			  << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	std::unique_ptr<IPARkISP1Interface> ipa{
+		static_cast<IPARkISP1Interface *>(module.createInterface())
+	};
+	if (!ipa) {
+		std::cerr << "Failed to create the IPA interface" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	Replayer replayer(ipa.get(), argc == 4 ? argv[3] : "");
+	int ret = replayer.run(recording);
+
+	return ret < 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -19,9 +19,17 @@
  * packed formats
  */
 
+/*
+ * The byte coordinates need more precision than mediump guarantees, which
+ * would result in sampling the wrong bytes on the right side of the image.
+ */
 #ifdef GL_ES
+#ifdef GL_FRAGMENT_PRECISION_HIGH
+precision highp float;
+#else
 precision mediump float;
 #endif
+#endif
 
 /*
  * These constants are used to select the bytes containing the HS part of
@@ -64,6 +72,10 @@ uniform vec2 tex_size;
 uniform vec2 tex_step;
 uniform vec2 tex_bayer_first_red;
 
+/* White balance gains and gamma exponent applied after demosaicing */
+uniform vec3 wb_gains;
+uniform float gamma;
+
 uniform sampler2D tex_y;
 
 void main(void)
@@ -212,5 +224,7 @@ void main(void)
 			vec3(patterns.y, C, patterns.x) :
 			vec3(patterns.wz, C));
 
+	rgb = pow(clamp(rgb * wb_gains, 0.0, 1.0), vec3(gamma));
+
 	gl_FragColor = vec4(rgb, 1.0);
 }
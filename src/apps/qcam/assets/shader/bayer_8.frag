@@ -25,6 +25,10 @@ varying vec4            center;
 varying vec4            yCoord;
 varying vec4            xCoord;
 
+/** White balance gains and gamma exponent applied after demosaicing */
+uniform vec3            wb_gains;
+uniform float           gamma;
+
 void main(void) {
     #define fetch(x, y) texture2D(tex_y, vec2(x, y)).r
 
@@ -97,11 +101,13 @@ void main(void) {
     PATTERN.xw  += kB.xw * B;
     PATTERN.xz  += kF.xz * F;
 
-    gl_FragColor.rgb = (alternate.y == 0.0) ?
+    vec3 rgb = (alternate.y == 0.0) ?
         ((alternate.x == 0.0) ?
             vec3(C, PATTERN.xy) :
             vec3(PATTERN.z, C, PATTERN.w)) :
         ((alternate.x == 0.0) ?
             vec3(PATTERN.w, C, PATTERN.z) :
             vec3(PATTERN.yx, C));
+
+    gl_FragColor = vec4(pow(clamp(rgb * wb_gains, 0.0, 1.0), vec3(gamma)), 1.0);
 }
@@ -0,0 +1,18 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+/*
+ * Copyright (C) 2026, Ideas on Board Oy
+ *
+ * histogram.frag - Fragment shader for histogram computation
+ */
+
+#ifdef GL_ES
+precision mediump float;
+#endif
+
+/* Channel of the histogram framebuffer the point is accumulated to */
+uniform vec4 channel_mask;
+
+void main(void)
+{
+	gl_FragColor = channel_mask / 255.0;
+}
@@ -0,0 +1,34 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+/*
+ * Copyright (C) 2026, Ideas on Board Oy
+ *
+ * histogram.vert - Vertex shader for histogram computation
+ */
+
+/*
+ * Each vertex is a point corresponding to one texel of the statistics texture.
+ * The vertex shader samples the texel, computes the histogram bin it belongs
+ * to, and positions the point on that bin in the histogram framebuffer. Points
+ * are accumulated with additive blending.
+ *
+ * The histogram framebuffer has one line per line of the statistics texture,
+ * to keep the number of points accumulated in a single 8-bit texel lower than
+ * 256. The lines are summed when reading the histogram back.
+ */
+
+attribute vec2 textureIn;
+
+uniform sampler2D tex_stats;
+uniform vec3 channel_weights;
+uniform float bins;
+
+void main(void)
+{
+	vec3 rgb = texture2DLod(tex_stats, textureIn, 0.0).rgb;
+	float value = clamp(dot(rgb, channel_weights), 0.0, 1.0);
+	float bin = min(floor(value * bins), bins - 1.0);
+
+	gl_Position = vec4((bin + 0.5) / bins * 2.0 - 1.0,
+			   textureIn.y * 2.0 - 1.0, 0.0, 1.0);
+	gl_PointSize = 1.0;
+}
@@ -7,10 +7,14 @@
 
 #include "format_converter.h"
 
+#include <algorithm>
 #include <errno.h>
+#include <functional>
 #include <utility>
 
 #include <QImage>
+#include <QRunnable>
+#include <QThread>
 
 #include <libcamera/formats.h>
 
@@ -178,182 +182,267 @@ int FormatConverter::configure(const libcamera::PixelFormat &format,
 	height_ = size.height();
 	stride_ = stride;
 
+	lineBuffers_.clear();
+	setOutputSize(size);
+
 	return 0;
 }
 
+/*
+ * Set the size of the converted image. Downscaling is performed during
+ * conversion using nearest-neighbour sampling, which avoids converting pixels
+ * that would be discarded when rendering the image to a smaller widget. The
+ * output size can't be larger than the input size, and can't be changed for
+ * MJPEG as the whole image is always decoded.
+ */
+void FormatConverter::setOutputSize(const QSize &size)
+{
+	QSize outputSize = size.boundedTo(QSize(width_, height_));
+	if (formatFamily_ == MJPEG || outputSize.isEmpty())
+		outputSize = QSize(width_, height_);
+
+	if (!lineBuffers_.empty() && outputSize == this->outputSize())
+		return;
+
+	outWidth_ = outputSize.width();
+	outHeight_ = outputSize.height();
+	scaled_ = outWidth_ != width_ || outHeight_ != height_;
+
+	xMap_.resize(outWidth_);
+	for (unsigned int x = 0; x < outWidth_; x++)
+		xMap_[x] = x * width_ / outWidth_;
+
+	/* Bands smaller than this are not worth the cost of a thread. */
+	constexpr int kMinBandHeight = 32;
+	int bands = std::clamp(QThread::idealThreadCount(), 1,
+			       std::max<int>(outHeight_ / kMinBandHeight, 1));
+
+	pool_.setMaxThreadCount(std::max(bands - 1, 1));
+
+	lineBuffers_.resize(bands);
+	for (LineBuffer &buffer : lineBuffers_) {
+		buffer.y.resize(outWidth_);
+		buffer.u.resize(outWidth_);
+		buffer.v.resize(outWidth_);
+	}
+}
+
+namespace {
+
+class ConvertTask : public QRunnable
+{
+public:
+	ConvertTask(const std::function<void()> &func)
+		: func_(func)
+	{
+	}
+
+	void run() override
+	{
+		func_();
+	}
+
+private:
+	std::function<void()> func_;
+};
+
+} /* namespace */
+
 void FormatConverter::convert(const Image *src, size_t size, QImage *dst)
+{
+	if (formatFamily_ == MJPEG) {
+		dst->loadFromData(src->data(0).data(), size, "JPEG");
+		return;
+	}
+
+	/*
+	 * Split the output image in bands of lines. All bands but the first
+	 * one are converted by the thread pool, the first band is converted
+	 * in the calling thread.
+	 */
+	unsigned char *bits = dst->bits();
+	unsigned int bands = lineBuffers_.size();
+
+	auto convertBand = [this, src, bits, bands](unsigned int band) {
+		unsigned int start = outHeight_ * band / bands;
+		unsigned int end = outHeight_ * (band + 1) / bands;
+
+		convertLines(src, bits, start, end, &lineBuffers_[band]);
+	};
+
+	for (unsigned int band = 1; band < bands; band++)
+		pool_.start(new ConvertTask([&convertBand, band]() {
+			convertBand(band);
+		}));
+
+	convertBand(0);
+
+	pool_.waitForDone();
+}
+
+void FormatConverter::convertLines(const Image *src, unsigned char *dst,
+				   unsigned int start, unsigned int end,
+				   LineBuffer *buffer)
 {
 	switch (formatFamily_) {
 	case MJPEG:
-		dst->loadFromData(src->data(0).data(), size, "JPEG");
 		break;
 	case RGB:
-		convertRGB(src, dst->bits());
+		convertRGB(src, dst, start, end);
 		break;
 	case YUVPacked:
-		convertYUVPacked(src, dst->bits());
+		convertYUVPacked(src, dst, start, end, buffer);
 		break;
 	case YUVSemiPlanar:
-		convertYUVSemiPlanar(src, dst->bits());
+		convertYUVSemiPlanar(src, dst, start, end, buffer);
 		break;
 	case YUVPlanar:
-		convertYUVPlanar(src, dst->bits());
+		convertYUVPlanar(src, dst, start, end, buffer);
 		break;
 	};
 }
 
-static void yuv_to_rgb(int y, int u, int v, int *r, int *g, int *b)
+/*
+ * Convert a line of YUV samples to RGB32. The samples are stored in separate
+ * contiguous arrays, one entry per output pixel, and the loop body is
+ * branchless to allow vectorization by the compiler.
+ */
+static void yuv_to_rgb_line(const uint8_t *ys, const uint8_t *us,
+			    const uint8_t *vs, unsigned char *dst,
+			    unsigned int width)
 {
-	int c = y - 16;
-	int d = u - 128;
-	int e = v - 128;
-	*r = CLIP(( 298 * c           + 409 * e + 128) >> RGBSHIFT);
-	*g = CLIP(( 298 * c - 100 * d - 208 * e + 128) >> RGBSHIFT);
-	*b = CLIP(( 298 * c + 516 * d           + 128) >> RGBSHIFT);
+	for (unsigned int x = 0; x < width; x++) {
+		int c = ys[x] - 16;
+		int d = us[x] - 128;
+		int e = vs[x] - 128;
+
+		dst[4 * x + 0] = CLIP(( 298 * c + 516 * d           + 128) >> RGBSHIFT);
+		dst[4 * x + 1] = CLIP(( 298 * c - 100 * d - 208 * e + 128) >> RGBSHIFT);
+		dst[4 * x + 2] = CLIP(( 298 * c           + 409 * e + 128) >> RGBSHIFT);
+		dst[4 * x + 3] = 0xff;
+	}
 }
 
-void FormatConverter::convertRGB(const Image *srcImage, unsigned char *dst)
+void FormatConverter::convertRGB(const Image *srcImage, unsigned char *dst,
+				 unsigned int start, unsigned int end)
 {
 	const unsigned char *src = srcImage->data(0).data();
-	unsigned int x, y;
-	int r, g, b;
-
-	for (y = 0; y < height_; y++) {
-		for (x = 0; x < width_; x++) {
-			r = src[bpp_ * x + r_pos_];
-			g = src[bpp_ * x + g_pos_];
-			b = src[bpp_ * x + b_pos_];
-
-			dst[4 * x + 0] = b;
-			dst[4 * x + 1] = g;
-			dst[4 * x + 2] = r;
-			dst[4 * x + 3] = 0xff;
-		}
 
-		src += stride_;
-		dst += width_ * 4;
+	for (unsigned int y = start; y < end; y++) {
+		const unsigned char *line = src + srcLine(y) * stride_;
+		unsigned char *out = dst + y * outWidth_ * 4;
+
+		for (unsigned int x = 0; x < outWidth_; x++) {
+			const unsigned char *pixel = line + bpp_ * xMap_[x];
+
+			out[4 * x + 0] = pixel[b_pos_];
+			out[4 * x + 1] = pixel[g_pos_];
+			out[4 * x + 2] = pixel[r_pos_];
+			out[4 * x + 3] = 0xff;
+		}
 	}
 }
 
-void FormatConverter::convertYUVPacked(const Image *srcImage, unsigned char *dst)
+void FormatConverter::convertYUVPacked(const Image *srcImage, unsigned char *dst,
+				       unsigned int start, unsigned int end,
+				       LineBuffer *buffer)
 {
 	const unsigned char *src = srcImage->data(0).data();
-	unsigned int src_x, src_y, dst_x, dst_y;
-	unsigned int src_stride;
-	unsigned int dst_stride;
-	unsigned int cr_pos;
-	int r, g, b, y, cr, cb;
-
-	cr_pos = (cb_pos_ + 2) % 4;
-	src_stride = stride_;
-	dst_stride = width_ * 4;
-
-	for (src_y = 0, dst_y = 0; dst_y < height_; src_y++, dst_y++) {
-		for (src_x = 0, dst_x = 0; dst_x < width_; ) {
-			cb = src[src_y * src_stride + src_x * 4 + cb_pos_];
-			cr = src[src_y * src_stride + src_x * 4 + cr_pos];
-
-			y = src[src_y * src_stride + src_x * 4 + y_pos_];
-			yuv_to_rgb(y, cb, cr, &r, &g, &b);
-			dst[dst_y * dst_stride + 4 * dst_x + 0] = b;
-			dst[dst_y * dst_stride + 4 * dst_x + 1] = g;
-			dst[dst_y * dst_stride + 4 * dst_x + 2] = r;
-			dst[dst_y * dst_stride + 4 * dst_x + 3] = 0xff;
-			dst_x++;
-
-			y = src[src_y * src_stride + src_x * 4 + y_pos_ + 2];
-			yuv_to_rgb(y, cb, cr, &r, &g, &b);
-			dst[dst_y * dst_stride + 4 * dst_x + 0] = b;
-			dst[dst_y * dst_stride + 4 * dst_x + 1] = g;
-			dst[dst_y * dst_stride + 4 * dst_x + 2] = r;
-			dst[dst_y * dst_stride + 4 * dst_x + 3] = 0xff;
-			dst_x++;
-
-			src_x++;
+	unsigned int cr_pos = (cb_pos_ + 2) % 4;
+	uint8_t *ys = buffer->y.data();
+	uint8_t *us = buffer->u.data();
+	uint8_t *vs = buffer->v.data();
+
+	for (unsigned int y = start; y < end; y++) {
+		const unsigned char *line = src + srcLine(y) * stride_;
+
+		/* Deinterleave the samples, upsampling chroma horizontally. */
+		for (unsigned int x = 0; x < outWidth_; x++) {
+			unsigned int src_x = xMap_[x];
+			const unsigned char *group = line + (src_x / 2) * 4;
+
+			ys[x] = group[y_pos_ + (src_x % 2) * 2];
+			us[x] = group[cb_pos_];
+			vs[x] = group[cr_pos];
 		}
+
+		yuv_to_rgb_line(ys, us, vs, dst + y * outWidth_ * 4, outWidth_);
 	}
 }
 
-void FormatConverter::convertYUVPlanar(const Image *srcImage, unsigned char *dst)
+void FormatConverter::convertYUVPlanar(const Image *srcImage, unsigned char *dst,
+				       unsigned int start, unsigned int end,
+				       LineBuffer *buffer)
 {
 	unsigned int c_stride = stride_ / horzSubSample_;
-	unsigned int c_inc = horzSubSample_ == 1 ? 1 : 0;
 	const unsigned char *src_y = srcImage->data(0).data();
 	const unsigned char *src_cb = srcImage->data(1).data();
 	const unsigned char *src_cr = srcImage->data(2).data();
-	int r, g, b;
+	uint8_t *us = buffer->u.data();
+	uint8_t *vs = buffer->v.data();
 
 	if (nvSwap_)
 		std::swap(src_cb, src_cr);
 
-	for (unsigned int y = 0; y < height_; y++) {
-		const unsigned char *line_y = src_y + y * stride_;
-		const unsigned char *line_cb = src_cb + (y / vertSubSample_) *
+	for (unsigned int y = start; y < end; y++) {
+		unsigned int src_line = srcLine(y);
+		const unsigned char *line_y = src_y + src_line * stride_;
+		const unsigned char *line_cb = src_cb + (src_line / vertSubSample_) *
 					       c_stride;
-		const unsigned char *line_cr = src_cr + (y / vertSubSample_) *
+		const unsigned char *line_cr = src_cr + (src_line / vertSubSample_) *
 					       c_stride;
+		const uint8_t *ys = line_y;
+
+		if (scaled_) {
+			for (unsigned int x = 0; x < outWidth_; x++)
+				buffer->y[x] = line_y[xMap_[x]];
+			ys = buffer->y.data();
+		}
 
-		for (unsigned int x = 0; x < width_; x += 2) {
-			yuv_to_rgb(*line_y, *line_cb, *line_cr, &r, &g, &b);
-			dst[0] = b;
-			dst[1] = g;
-			dst[2] = r;
-			dst[3] = 0xff;
-			line_y++;
-			line_cb += c_inc;
-			line_cr += c_inc;
-			dst += 4;
-
-			yuv_to_rgb(*line_y, *line_cb, *line_cr, &r, &g, &b);
-			dst[0] = b;
-			dst[1] = g;
-			dst[2] = r;
-			dst[3] = 0xff;
-			line_y++;
-			line_cb += 1;
-			line_cr += 1;
-			dst += 4;
+		for (unsigned int x = 0; x < outWidth_; x++) {
+			unsigned int src_x = xMap_[x] / horzSubSample_;
+
+			us[x] = line_cb[src_x];
+			vs[x] = line_cr[src_x];
 		}
+
+		yuv_to_rgb_line(ys, us, vs, dst + y * outWidth_ * 4, outWidth_);
 	}
 }
 
-void FormatConverter::convertYUVSemiPlanar(const Image *srcImage, unsigned char *dst)
+void FormatConverter::convertYUVSemiPlanar(const Image *srcImage, unsigned char *dst,
+					   unsigned int start, unsigned int end,
+					   LineBuffer *buffer)
 {
 	unsigned int c_stride = stride_ * (2 / horzSubSample_);
-	unsigned int c_inc = horzSubSample_ == 1 ? 2 : 0;
 	unsigned int cb_pos = nvSwap_ ? 1 : 0;
 	unsigned int cr_pos = nvSwap_ ? 0 : 1;
 	const unsigned char *src = srcImage->data(0).data();
 	const unsigned char *src_c = srcImage->data(1).data();
-	int r, g, b;
-
-	for (unsigned int y = 0; y < height_; y++) {
-		const unsigned char *src_y = src + y * stride_;
-		const unsigned char *src_cb = src_c + (y / vertSubSample_) *
-					      c_stride + cb_pos;
-		const unsigned char *src_cr = src_c + (y / vertSubSample_) *
-					      c_stride + cr_pos;
-
-		for (unsigned int x = 0; x < width_; x += 2) {
-			yuv_to_rgb(*src_y, *src_cb, *src_cr, &r, &g, &b);
-			dst[0] = b;
-			dst[1] = g;
-			dst[2] = r;
-			dst[3] = 0xff;
-			src_y++;
-			src_cb += c_inc;
-			src_cr += c_inc;
-			dst += 4;
-
-			yuv_to_rgb(*src_y, *src_cb, *src_cr, &r, &g, &b);
-			dst[0] = b;
-			dst[1] = g;
-			dst[2] = r;
-			dst[3] = 0xff;
-			src_y++;
-			src_cb += 2;
-			src_cr += 2;
-			dst += 4;
+	uint8_t *us = buffer->u.data();
+	uint8_t *vs = buffer->v.data();
+
+	for (unsigned int y = start; y < end; y++) {
+		unsigned int src_line = srcLine(y);
+		const unsigned char *line_y = src + src_line * stride_;
+		const unsigned char *line_c = src_c + (src_line / vertSubSample_) *
+					      c_stride;
+		const uint8_t *ys = line_y;
+
+		if (scaled_) {
+			for (unsigned int x = 0; x < outWidth_; x++)
+				buffer->y[x] = line_y[xMap_[x]];
+			ys = buffer->y.data();
+		}
+
+		/* Deinterleave the chroma samples and upsample horizontally. */
+		for (unsigned int x = 0; x < outWidth_; x++) {
+			unsigned int src_x = xMap_[x] / horzSubSample_ * 2;
+
+			us[x] = line_c[src_x + cb_pos];
+			vs[x] = line_c[src_x + cr_pos];
 		}
+
+		yuv_to_rgb_line(ys, us, vs, dst + y * outWidth_ * 4, outWidth_);
 	}
 }
@@ -8,8 +8,11 @@
 #pragma once
 
 #include <stddef.h>
+#include <stdint.h>
+#include <vector>
 
 #include <QSize>
+#include <QThreadPool>
 
 #include <libcamera/pixel_format.h>
 
@@ -22,6 +25,9 @@ public:
 	int configure(const libcamera::PixelFormat &format, const QSize &size,
 		      unsigned int stride);
 
+	void setOutputSize(const QSize &size);
+	QSize outputSize() const { return QSize(outWidth_, outHeight_); }
+
 	void convert(const Image *src, size_t size, QImage *dst);
 
 private:
@@ -33,16 +39,47 @@ private:
 		YUVSemiPlanar,
 	};
 
-	void convertRGB(const Image *src, unsigned char *dst);
-	void convertYUVPacked(const Image *src, unsigned char *dst);
-	void convertYUVPlanar(const Image *src, unsigned char *dst);
-	void convertYUVSemiPlanar(const Image *src, unsigned char *dst);
+	struct LineBuffer {
+		std::vector<uint8_t> y;
+		std::vector<uint8_t> u;
+		std::vector<uint8_t> v;
+	};
+
+	void convertLines(const Image *src, unsigned char *dst,
+			  unsigned int start, unsigned int end,
+			  LineBuffer *buffer);
+	void convertRGB(const Image *src, unsigned char *dst,
+			unsigned int start, unsigned int end);
+	void convertYUVPacked(const Image *src, unsigned char *dst,
+			      unsigned int start, unsigned int end,
+			      LineBuffer *buffer);
+	void convertYUVPlanar(const Image *src, unsigned char *dst,
+			      unsigned int start, unsigned int end,
+			      LineBuffer *buffer);
+	void convertYUVSemiPlanar(const Image *src, unsigned char *dst,
+				  unsigned int start, unsigned int end,
+				  LineBuffer *buffer);
+
+	unsigned int srcLine(unsigned int line) const
+	{
+		return line * height_ / outHeight_;
+	}
 
 	libcamera::PixelFormat format_;
 	unsigned int width_;
 	unsigned int height_;
 	unsigned int stride_;
 
+	/* Output parameters */
+	unsigned int outWidth_;
+	unsigned int outHeight_;
+	bool scaled_;
+	std::vector<unsigned int> xMap_;
+
+	/* Conversion is split in bands of lines processed concurrently */
+	QThreadPool pool_;
+	std::vector<LineBuffer> lineBuffers_;
+
 	enum FormatFamily formatFamily_;
 
 	/* NV parameters */
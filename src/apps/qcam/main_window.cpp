@@ -12,6 +12,7 @@
 #include <string>
 
 #include <libcamera/camera_manager.h>
+#include <libcamera/control_ids.h>
 #include <libcamera/version.h>
 
 #include <QCoreApplication>
@@ -714,6 +715,10 @@ void MainWindow::processCapture()
 	}
 
 	/* Process buffers. */
+	const auto &colourGains = request->metadata().get(controls::ColourGains);
+	if (colourGains)
+		viewfinder_->setColourGains((*colourGains)[0], (*colourGains)[1]);
+
 	if (request->buffers().count(vfStream_))
 		processViewfinder(request->buffers().at(vfStream_));
 
@@ -30,5 +30,8 @@ public:
 	virtual void render(libcamera::FrameBuffer *buffer, Image *image) = 0;
 	virtual void stop() = 0;
 
+	virtual void setColourGains([[maybe_unused]] float red,
+				    [[maybe_unused]] float blue) {}
+
 	virtual QImage getCurrentImage() = 0;
 };
@@ -7,12 +7,18 @@
 
 #include "viewfinder_gl.h"
 
+#include <algorithm>
 #include <array>
+#include <vector>
 
 #include <QByteArray>
+#include <QColor>
 #include <QFile>
 #include <QImage>
+#include <QPainter>
+#include <QPolygonF>
 #include <QStringList>
+#include <QVector4D>
 
 #include <libcamera/formats.h>
 
@@ -61,7 +67,11 @@ static const QList<libcamera::PixelFormat> supportedFormats{
 ViewFinderGL::ViewFinderGL(QWidget *parent)
 	: QOpenGLWidget(parent), buffer_(nullptr),
 	  colorSpace_(libcamera::ColorSpace::Raw), image_(nullptr),
-	  vertexBuffer_(QOpenGLBuffer::VertexBuffer)
+	  vertexBuffer_(QOpenGLBuffer::VertexBuffer),
+	  wbGains_(1.0f, 1.0f, 1.0f), raw_(false), histogramSupported_(true),
+	  statsVertexBuffer_(QOpenGLBuffer::VertexBuffer),
+	  histogramVertexBuffer_(QOpenGLBuffer::VertexBuffer), histogramFrame_(0),
+	  histogram_{}
 {
 }
 
@@ -122,6 +132,11 @@ QImage ViewFinderGL::getCurrentImage()
 	return grabFramebuffer();
 }
 
+void ViewFinderGL::setColourGains(float red, float blue)
+{
+	wbGains_ = QVector3D(red, 1.0f, blue);
+}
+
 void ViewFinderGL::render(libcamera::FrameBuffer *buffer, Image *image)
 {
 	if (buffer_)
@@ -143,6 +158,7 @@ bool ViewFinderGL::selectFormat(const libcamera::PixelFormat &format)
 	vertexShaderFile_ = ":identity.vert";
 
 	fragmentShaderDefines_.clear();
+	raw_ = false;
 
 	switch (format) {
 	case libcamera::formats::NV12:
@@ -237,6 +253,7 @@ bool ViewFinderGL::selectFormat(const libcamera::PixelFormat &format)
 		vertexShaderFile_ = ":bayer_8.vert";
 		fragmentShaderFile_ = ":bayer_8.frag";
 		textureMinMagFilters_ = GL_NEAREST;
+		raw_ = true;
 		break;
 	case libcamera::formats::SGBRG8:
 		firstRed_.setX(0.0);
@@ -244,6 +261,7 @@ bool ViewFinderGL::selectFormat(const libcamera::PixelFormat &format)
 		vertexShaderFile_ = ":bayer_8.vert";
 		fragmentShaderFile_ = ":bayer_8.frag";
 		textureMinMagFilters_ = GL_NEAREST;
+		raw_ = true;
 		break;
 	case libcamera::formats::SGRBG8:
 		firstRed_.setX(1.0);
@@ -251,6 +269,7 @@ bool ViewFinderGL::selectFormat(const libcamera::PixelFormat &format)
 		vertexShaderFile_ = ":bayer_8.vert";
 		fragmentShaderFile_ = ":bayer_8.frag";
 		textureMinMagFilters_ = GL_NEAREST;
+		raw_ = true;
 		break;
 	case libcamera::formats::SRGGB8:
 		firstRed_.setX(0.0);
@@ -258,6 +277,7 @@ bool ViewFinderGL::selectFormat(const libcamera::PixelFormat &format)
 		vertexShaderFile_ = ":bayer_8.vert";
 		fragmentShaderFile_ = ":bayer_8.frag";
 		textureMinMagFilters_ = GL_NEAREST;
+		raw_ = true;
 		break;
 	case libcamera::formats::SBGGR10_CSI2P:
 		firstRed_.setX(1.0);
@@ -265,6 +285,7 @@ bool ViewFinderGL::selectFormat(const libcamera::PixelFormat &format)
 		fragmentShaderDefines_.append("#define RAW10P");
 		fragmentShaderFile_ = ":bayer_1x_packed.frag";
 		textureMinMagFilters_ = GL_NEAREST;
+		raw_ = true;
 		break;
 	case libcamera::formats::SGBRG10_CSI2P:
 		firstRed_.setX(0.0);
@@ -272,6 +293,7 @@ bool ViewFinderGL::selectFormat(const libcamera::PixelFormat &format)
 		fragmentShaderDefines_.append("#define RAW10P");
 		fragmentShaderFile_ = ":bayer_1x_packed.frag";
 		textureMinMagFilters_ = GL_NEAREST;
+		raw_ = true;
 		break;
 	case libcamera::formats::SGRBG10_CSI2P:
 		firstRed_.setX(1.0);
@@ -279,6 +301,7 @@ bool ViewFinderGL::selectFormat(const libcamera::PixelFormat &format)
 		fragmentShaderDefines_.append("#define RAW10P");
 		fragmentShaderFile_ = ":bayer_1x_packed.frag";
 		textureMinMagFilters_ = GL_NEAREST;
+		raw_ = true;
 		break;
 	case libcamera::formats::SRGGB10_CSI2P:
 		firstRed_.setX(0.0);
@@ -286,6 +309,7 @@ bool ViewFinderGL::selectFormat(const libcamera::PixelFormat &format)
 		fragmentShaderDefines_.append("#define RAW10P");
 		fragmentShaderFile_ = ":bayer_1x_packed.frag";
 		textureMinMagFilters_ = GL_NEAREST;
+		raw_ = true;
 		break;
 	case libcamera::formats::SBGGR12_CSI2P:
 		firstRed_.setX(1.0);
@@ -293,6 +317,7 @@ bool ViewFinderGL::selectFormat(const libcamera::PixelFormat &format)
 		fragmentShaderDefines_.append("#define RAW12P");
 		fragmentShaderFile_ = ":bayer_1x_packed.frag";
 		textureMinMagFilters_ = GL_NEAREST;
+		raw_ = true;
 		break;
 	case libcamera::formats::SGBRG12_CSI2P:
 		firstRed_.setX(0.0);
@@ -300,6 +325,7 @@ bool ViewFinderGL::selectFormat(const libcamera::PixelFormat &format)
 		fragmentShaderDefines_.append("#define RAW12P");
 		fragmentShaderFile_ = ":bayer_1x_packed.frag";
 		textureMinMagFilters_ = GL_NEAREST;
+		raw_ = true;
 		break;
 	case libcamera::formats::SGRBG12_CSI2P:
 		firstRed_.setX(1.0);
@@ -307,6 +333,7 @@ bool ViewFinderGL::selectFormat(const libcamera::PixelFormat &format)
 		fragmentShaderDefines_.append("#define RAW12P");
 		fragmentShaderFile_ = ":bayer_1x_packed.frag";
 		textureMinMagFilters_ = GL_NEAREST;
+		raw_ = true;
 		break;
 	case libcamera::formats::SRGGB12_CSI2P:
 		firstRed_.setX(0.0);
@@ -314,6 +341,7 @@ bool ViewFinderGL::selectFormat(const libcamera::PixelFormat &format)
 		fragmentShaderDefines_.append("#define RAW12P");
 		fragmentShaderFile_ = ":bayer_1x_packed.frag";
 		textureMinMagFilters_ = GL_NEAREST;
+		raw_ = true;
 		break;
 	default:
 		ret = false;
@@ -410,9 +438,6 @@ bool ViewFinderGL::createVertexShader()
 
 bool ViewFinderGL::createFragmentShader()
 {
-	int attributeVertex;
-	int attributeTexture;
-
 	/*
 	 * Create the fragment shader, compile it, and add it to the shader
 	 * program. The #define macros stored in fragmentShaderDefines_, if
@@ -449,22 +474,7 @@ bool ViewFinderGL::createFragmentShader()
 		close();
 	}
 
-	attributeVertex = shaderProgram_.attributeLocation("vertexIn");
-	attributeTexture = shaderProgram_.attributeLocation("textureIn");
-
-	shaderProgram_.enableAttributeArray(attributeVertex);
-	shaderProgram_.setAttributeBuffer(attributeVertex,
-					  GL_FLOAT,
-					  0,
-					  2,
-					  2 * sizeof(GLfloat));
-
-	shaderProgram_.enableAttributeArray(attributeTexture);
-	shaderProgram_.setAttributeBuffer(attributeTexture,
-					  GL_FLOAT,
-					  8 * sizeof(GLfloat),
-					  2,
-					  2 * sizeof(GLfloat));
+	setupVertexAttributes(vertexBuffer_);
 
 	textureUniformY_ = shaderProgram_.uniformLocation("tex_y");
 	textureUniformU_ = shaderProgram_.uniformLocation("tex_u");
@@ -473,6 +483,8 @@ bool ViewFinderGL::createFragmentShader()
 	textureUniformSize_ = shaderProgram_.uniformLocation("tex_size");
 	textureUniformStrideFactor_ = shaderProgram_.uniformLocation("stride_factor");
 	textureUniformBayerFirstRed_ = shaderProgram_.uniformLocation("tex_bayer_first_red");
+	textureUniformWbGains_ = shaderProgram_.uniformLocation("wb_gains");
+	textureUniformGamma_ = shaderProgram_.uniformLocation("gamma");
 
 	/* Create the textures. */
 	for (std::unique_ptr<QOpenGLTexture> &texture : textures_) {
@@ -486,6 +498,247 @@ bool ViewFinderGL::createFragmentShader()
 	return true;
 }
 
+void ViewFinderGL::setupVertexAttributes(QOpenGLBuffer &buffer)
+{
+	int attributeVertex = shaderProgram_.attributeLocation("vertexIn");
+	int attributeTexture = shaderProgram_.attributeLocation("textureIn");
+
+	buffer.bind();
+
+	shaderProgram_.enableAttributeArray(attributeVertex);
+	shaderProgram_.setAttributeBuffer(attributeVertex,
+					  GL_FLOAT,
+					  0,
+					  2,
+					  2 * sizeof(GLfloat));
+
+	shaderProgram_.enableAttributeArray(attributeTexture);
+	shaderProgram_.setAttributeBuffer(attributeTexture,
+					  GL_FLOAT,
+					  8 * sizeof(GLfloat),
+					  2,
+					  2 * sizeof(GLfloat));
+}
+
+bool ViewFinderGL::createHistogramProgram()
+{
+	if (!histogramProgram_.addShaderFromSourceFile(QOpenGLShader::Vertex,
+						       ":histogram.vert") ||
+	    !histogramProgram_.addShaderFromSourceFile(QOpenGLShader::Fragment,
+						       ":histogram.frag") ||
+	    !histogramProgram_.link()) {
+		qWarning() << "[ViewFinderGL]:" << histogramProgram_.log();
+		return false;
+	}
+
+	return true;
+}
+
+/*
+ * Compute the histogram of the raw image on the GPU. The image is first
+ * rendered to a small statistics texture, reducing the number of samples.
+ * White balance and gamma are disabled for that pass, so that the histogram
+ * reflects the sensor exposure and not the display processing.
+ * Each texel of the statistics texture is then drawn as a point, positioned
+ * by the histogram vertex shader on the bin corresponding to its value, and
+ * accumulated to the histogram framebuffer with additive blending. Only the
+ * small histogram framebuffer is read back.
+ */
+void ViewFinderGL::computeHistogram()
+{
+	if (!histogramSupported_)
+		return;
+
+	if (!histogramProgram_.isLinked()) {
+		GLint units = 0;
+		glGetIntegerv(GL_MAX_VERTEX_TEXTURE_IMAGE_UNITS, &units);
+
+		if (!units || !createHistogramProgram()) {
+			qWarning() << "[ViewFinderGL]:"
+				   << "histogram computation not supported";
+			histogramSupported_ = false;
+			return;
+		}
+	}
+
+	/*
+	 * Subsample the image by an integer factor, keeping the statistics
+	 * width lower than 256 to avoid overflowing the 8-bit histogram
+	 * counters.
+	 */
+	int factor = std::max(size_.width() / kStatsWidth, 1);
+	QSize statsSize(size_.width() / factor,
+			std::max(size_.height() / factor, 1));
+
+	if (!statsFbo_ || statsFbo_->size() != statsSize) {
+		statsFbo_ = std::make_unique<QOpenGLFramebufferObject>(statsSize);
+		histogramFbo_ = std::make_unique<QOpenGLFramebufferObject>(
+			kHistogramBins, statsSize.height());
+
+		std::vector<GLfloat> points;
+		points.reserve(statsSize.width() * statsSize.height() * 2);
+
+		for (int y = 0; y < statsSize.height(); ++y) {
+			for (int x = 0; x < statsSize.width(); ++x) {
+				points.push_back((x + 0.5f) / statsSize.width());
+				points.push_back((y + 0.5f) / statsSize.height());
+			}
+		}
+
+		if (!histogramVertexBuffer_.isCreated())
+			histogramVertexBuffer_.create();
+		histogramVertexBuffer_.bind();
+		histogramVertexBuffer_.allocate(points.data(),
+						points.size() * sizeof(GLfloat));
+	}
+
+	/*
+	 * Map the centre of each statistics pixel to the centre of a texel.
+	 * Sampling on the edge between two texels would result in the shaders
+	 * using the wrong Bayer pattern phase. The mapping depends on the image
+	 * size, which may change without changing the statistics size.
+	 */
+	GLfloat left = (0.5f - factor / 2.0f) / size_.width();
+	GLfloat right = left + static_cast<GLfloat>(factor) *
+			       statsSize.width() / size_.width();
+	GLfloat top = (0.5f - factor / 2.0f) / size_.height();
+	GLfloat bottom = top + static_cast<GLfloat>(factor) *
+				 statsSize.height() / size_.height();
+
+	const GLfloat coordinates[2][4][2]{
+		{
+			/* Vertex coordinates */
+			{ -1.0f, -1.0f },
+			{ -1.0f, +1.0f },
+			{ +1.0f, +1.0f },
+			{ +1.0f, -1.0f },
+		},
+		{
+			/* Texture coordinates */
+			{ left, bottom },
+			{ left, top },
+			{ right, top },
+			{ right, bottom },
+		},
+	};
+
+	if (!statsVertexBuffer_.isCreated())
+		statsVertexBuffer_.create();
+	statsVertexBuffer_.bind();
+	statsVertexBuffer_.allocate(coordinates, sizeof(coordinates));
+
+	GLint viewport[4];
+	glGetIntegerv(GL_VIEWPORT, viewport);
+
+	/*
+	 * Render the image to the statistics texture. The white balance gains
+	 * and gamma are set again by doRender() for the next frame.
+	 */
+	statsFbo_->bind();
+	glViewport(0, 0, statsSize.width(), statsSize.height());
+	shaderProgram_.setUniformValue(textureUniformWbGains_,
+				       QVector3D(1.0f, 1.0f, 1.0f));
+	shaderProgram_.setUniformValue(textureUniformGamma_, 1.0f);
+	setupVertexAttributes(statsVertexBuffer_);
+	glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+
+	/* Accumulate the histogram, one draw per channel. */
+	static const std::array<QVector3D, 4> weights{ {
+		{ 1.0f, 0.0f, 0.0f },
+		{ 0.0f, 1.0f, 0.0f },
+		{ 0.0f, 0.0f, 1.0f },
+		{ 0.2126f, 0.7152f, 0.0722f },
+	} };
+	static const std::array<QVector4D, 4> masks{ {
+		{ 1.0f, 0.0f, 0.0f, 0.0f },
+		{ 0.0f, 1.0f, 0.0f, 0.0f },
+		{ 0.0f, 0.0f, 1.0f, 0.0f },
+		{ 0.0f, 0.0f, 0.0f, 1.0f },
+	} };
+
+	histogramFbo_->bind();
+	glViewport(0, 0, kHistogramBins, statsSize.height());
+	glClearColor(0.0, 0.0, 0.0, 0.0);
+	glClear(GL_COLOR_BUFFER_BIT);
+
+	histogramProgram_.bind();
+	histogramVertexBuffer_.bind();
+
+	int attributeTexture = histogramProgram_.attributeLocation("textureIn");
+	histogramProgram_.enableAttributeArray(attributeTexture);
+	histogramProgram_.setAttributeBuffer(attributeTexture, GL_FLOAT, 0, 2,
+					     2 * sizeof(GLfloat));
+
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, statsFbo_->texture());
+	histogramProgram_.setUniformValue("tex_stats", 0);
+	histogramProgram_.setUniformValue("bins",
+					  static_cast<GLfloat>(kHistogramBins));
+
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_ONE, GL_ONE);
+
+	for (unsigned int i = 0; i < weights.size(); ++i) {
+		histogramProgram_.setUniformValue("channel_weights", weights[i]);
+		histogramProgram_.setUniformValue("channel_mask", masks[i]);
+		glDrawArrays(GL_POINTS, 0, statsSize.width() * statsSize.height());
+	}
+
+	glDisable(GL_BLEND);
+
+	/* Read the histogram back and sum the lines. */
+	std::vector<uint8_t> data(kHistogramBins * statsSize.height() * 4);
+	glReadPixels(0, 0, kHistogramBins, statsSize.height(), GL_RGBA,
+		     GL_UNSIGNED_BYTE, data.data());
+
+	for (auto &channel : histogram_)
+		channel.fill(0);
+
+	for (int y = 0; y < statsSize.height(); ++y) {
+		const uint8_t *line = &data[y * kHistogramBins * 4];
+
+		for (unsigned int bin = 0; bin < kHistogramBins; ++bin) {
+			for (unsigned int c = 0; c < histogram_.size(); ++c)
+				histogram_[c][bin] += line[bin * 4 + c];
+		}
+	}
+
+	/*
+	 * Restore the framebuffer and viewport for the histogram overlay. The
+	 * viewfinder program is bound again by doRender() for the next frame.
+	 */
+	histogramProgram_.disableAttributeArray(attributeTexture);
+	glBindFramebuffer(GL_FRAMEBUFFER, defaultFramebufferObject());
+	glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+}
+
+void ViewFinderGL::drawHistogram()
+{
+	static const std::array<QColor, 4> colours{ {
+		Qt::red, Qt::green, Qt::blue, Qt::white,
+	} };
+
+	QPainter painter(this);
+	QRectF area(10, height() - 110, 2 * kHistogramBins, 100);
+
+	painter.fillRect(area, QColor(0, 0, 0, 128));
+
+	unsigned int max = 1;
+	for (const auto &channel : histogram_)
+		max = std::max(max, *std::max_element(channel.begin(), channel.end()));
+
+	for (unsigned int c = 0; c < histogram_.size(); ++c) {
+		QPolygonF curve;
+
+		for (unsigned int bin = 0; bin < kHistogramBins; ++bin)
+			curve << QPointF(area.left() + bin * area.width() / (kHistogramBins - 1),
+					 area.bottom() - histogram_[c][bin] * area.height() / max);
+
+		painter.setPen(colours[c]);
+		painter.drawPolyline(curve);
+	}
+}
+
 void ViewFinderGL::configureTexture(QOpenGLTexture &texture)
 {
 	glBindTexture(GL_TEXTURE_2D, texture.textureId());
@@ -541,6 +794,15 @@ void ViewFinderGL::initializeGL()
 
 void ViewFinderGL::doRender()
 {
+	/*
+	 * The histogram is computed with a different program and drawn with
+	 * QPainter, both of which change the GL state. Restore the program,
+	 * vertex attributes and blending on every frame.
+	 */
+	shaderProgram_.bind();
+	setupVertexAttributes(vertexBuffer_);
+	glDisable(GL_BLEND);
+
 	/* Stride of the first plane, in pixels. */
 	unsigned int stridePixels;
 
@@ -784,6 +1046,8 @@ void ViewFinderGL::doRender()
 		shaderProgram_.setUniformValue(textureUniformStep_,
 					       1.0f / (stride_ - 1),
 					       1.0f / (size_.height() - 1));
+		shaderProgram_.setUniformValue(textureUniformWbGains_, wbGains_);
+		shaderProgram_.setUniformValue(textureUniformGamma_, kRawGamma);
 
 		/*
 		 * The stride is already taken into account in the shaders, set
@@ -821,6 +1085,17 @@ void ViewFinderGL::paintGL()
 
 		doRender();
 		glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+
+		if (raw_) {
+			/*
+			 * Reading the histogram back stalls the GPU pipeline,
+			 * only refresh it every few frames.
+			 */
+			if (!(histogramFrame_++ % kHistogramInterval))
+				computeHistogram();
+			if (histogramSupported_)
+				drawHistogram();
+		}
 	}
 }
 
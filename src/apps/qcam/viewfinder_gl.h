@@ -14,12 +14,14 @@
 #include <QImage>
 #include <QMutex>
 #include <QOpenGLBuffer>
+#include <QOpenGLFramebufferObject>
 #include <QOpenGLFunctions>
 #include <QOpenGLShader>
 #include <QOpenGLShaderProgram>
 #include <QOpenGLTexture>
 #include <QOpenGLWidget>
 #include <QSize>
+#include <QVector3D>
 
 #include <libcamera/formats.h>
 #include <libcamera/framebuffer.h>
@@ -44,8 +46,16 @@ public:
 	void render(libcamera::FrameBuffer *buffer, Image *image) override;
 	void stop() override;
 
+	void setColourGains(float red, float blue) override;
+
 	QImage getCurrentImage() override;
 
+	/* Histogram of the last raw frame, for the R, G, B and Y channels */
+	static constexpr unsigned int kHistogramBins = 64;
+	using Histogram = std::array<std::array<unsigned int, kHistogramBins>, 4>;
+
+	const Histogram &histogram() const { return histogram_; }
+
 Q_SIGNALS:
 	void renderComplete(libcamera::FrameBuffer *buffer);
 
@@ -64,6 +74,11 @@ private:
 	bool createVertexShader();
 	void removeShader();
 	void doRender();
+	void setupVertexAttributes(QOpenGLBuffer &buffer);
+
+	bool createHistogramProgram();
+	void computeHistogram();
+	void drawHistogram();
 
 	/* Captured image size, format and buffer */
 	libcamera::FrameBuffer *buffer_;
@@ -102,7 +117,25 @@ private:
 	GLuint textureUniformSize_;
 	GLuint textureUniformStrideFactor_;
 	GLuint textureUniformBayerFirstRed_;
+	GLuint textureUniformWbGains_;
+	GLuint textureUniformGamma_;
 	QPointF firstRed_;
+	QVector3D wbGains_;
+	bool raw_;
+
+	/* Histogram computation for raw Bayer formats */
+	static constexpr int kStatsWidth = 128;
+	static constexpr unsigned int kHistogramInterval = 4;
+	static constexpr float kRawGamma = 1.0f / 2.2f;
+
+	bool histogramSupported_;
+	QOpenGLShaderProgram histogramProgram_;
+	QOpenGLBuffer statsVertexBuffer_;
+	QOpenGLBuffer histogramVertexBuffer_;
+	std::unique_ptr<QOpenGLFramebufferObject> statsFbo_;
+	std::unique_ptr<QOpenGLFramebufferObject> histogramFbo_;
+	unsigned int histogramFrame_;
+	Histogram histogram_;
 
 	QMutex mutex_; /* Prevent concurrent access to image_ */
 };
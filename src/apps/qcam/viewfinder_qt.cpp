@@ -39,7 +39,7 @@ static const QMap<libcamera::PixelFormat, QImage::Format> nativeFormats
 };
 
 ViewFinderQt::ViewFinderQt(QWidget *parent)
-	: QWidget(parent), buffer_(nullptr)
+	: QWidget(parent), buffer_(nullptr), source_(nullptr), sourceSize_(0)
 {
 	icon_ = QIcon(":camera-off.svg");
 }
@@ -109,10 +109,26 @@ void ViewFinderQt::render(libcamera::FrameBuffer *buffer, Image *image)
 			std::swap(buffer, buffer_);
 		} else {
 			/*
-			 * Otherwise, convert the format and release the frame
-			 * buffer immediately.
+			 * Otherwise, convert the format. Downscale the image
+			 * to the widget size during conversion, as converting
+			 * pixels that would then be discarded by the painter
+			 * is a waste of CPU time. The frame buffer is kept
+			 * until the next frame, to convert it at full
+			 * resolution if the current image is retrieved.
 			 */
+			QSize outputSize = size_.scaled(QWidget::size() * devicePixelRatio(),
+							Qt::KeepAspectRatio);
+			converter_.setOutputSize(outputSize);
+
+			if (image_.size() != converter_.outputSize())
+				image_ = QImage(converter_.outputSize(),
+						QImage::Format_RGB32);
+
 			converter_.convert(image, size, &image_);
+
+			source_ = image;
+			sourceSize_ = size;
+			std::swap(buffer, buffer_);
 		}
 	}
 
@@ -125,6 +141,7 @@ void ViewFinderQt::render(libcamera::FrameBuffer *buffer, Image *image)
 void ViewFinderQt::stop()
 {
 	image_ = QImage();
+	source_ = nullptr;
 
 	if (buffer_) {
 		renderComplete(buffer_);
@@ -138,6 +155,21 @@ QImage ViewFinderQt::getCurrentImage()
 {
 	QMutexLocker locker(&mutex_);
 
+	/*
+	 * The displayed image may have been downscaled, convert the current
+	 * frame again at full resolution.
+	 */
+	if (source_ && image_.size() != size_) {
+		QSize outputSize = converter_.outputSize();
+		QImage image(size_, QImage::Format_RGB32);
+
+		converter_.setOutputSize(size_);
+		converter_.convert(source_, sourceSize_, &image);
+		converter_.setOutputSize(outputSize);
+
+		return image;
+	}
+
 	return image_.copy();
 }
 
@@ -59,6 +59,8 @@ private:
 
 	/* Buffer and render image */
 	libcamera::FrameBuffer *buffer_;
+	Image *source_;
+	size_t sourceSize_;
 	QImage image_;
 	QMutex mutex_; /* Prevent concurrent access to image_ */
 };
@@ -53,9 +53,6 @@ static constexpr double kMinAnalogueGain = 1.0;
 /* \todo Honour the FrameDurationLimits control instead of hardcoding a limit */
 static constexpr utils::Duration kMaxShutterSpeed = 60ms;
 
-/* Histogram constants */
-static constexpr uint32_t knumHistogramBins = 256;
-
 /* Target value to reach for the top 2% of the histogram */
 static constexpr double kEvGainTarget = 0.5;
 
@@ -89,8 +86,6 @@ int Agc::configure(IPAContext &context,
 	const IPASessionConfiguration &configuration = context.configuration;
 	IPAActiveState &activeState = context.activeState;
 
-	stride_ = configuration.grid.stride;
-
 	minShutterSpeed_ = configuration.agc.minShutterSpeed;
 	maxShutterSpeed_ = std::min(configuration.agc.maxShutterSpeed,
 				    kMaxShutterSpeed);
@@ -108,38 +103,18 @@ int Agc::configure(IPAContext &context,
 
 /**
  * \brief Estimate the mean value of the top 2% of the histogram
- * \param[in] stats The statistics computed by the ImgU
- * \param[in] grid The grid used to store the statistics in the IPU3
+ * \param[in] frameContext The current frame context
  * \return The mean value of the top 2% of the histogram
+ *
+ * The histogram is computed from the average green value of all cells, which
+ * estimates the brightness. Even the overexposed pixels are taken into account.
  */
-double Agc::measureBrightness(const ipu3_uapi_stats_3a *stats,
-			      const ipu3_uapi_grid_config &grid) const
+double Agc::measureBrightness(const IPAFrameContext &frameContext)
 {
-	/* Initialise the histogram array */
-	uint32_t hist[knumHistogramBins] = { 0 };
-
-	for (unsigned int cellY = 0; cellY < grid.height; cellY++) {
-		for (unsigned int cellX = 0; cellX < grid.width; cellX++) {
-			uint32_t cellPosition = cellY * stride_ + cellX;
-
-			const ipu3_uapi_awb_set_item *cell =
-				reinterpret_cast<const ipu3_uapi_awb_set_item *>(
-					&stats->awb_raw_buffer.meta_data[cellPosition]
-				);
-
-			uint8_t gr = cell->Gr_avg;
-			uint8_t gb = cell->Gb_avg;
-			/*
-			 * Store the average green value to estimate the
-			 * brightness. Even the overexposed pixels are
-			 * taken into account.
-			 */
-			hist[(gr + gb) / 2]++;
-		}
-	}
+	histogram_.update(frameContext.stats.greenHistogram);
 
 	/* Estimate the quantile mean of the top 2% of the histogram. */
-	return Histogram(Span<uint32_t>(hist)).interQuantileMean(0.98, 1.0);
+	return histogram_.interQuantileMean(0.98, 1.0);
 }
 
 /**
@@ -256,9 +231,9 @@ void Agc::computeExposure(IPAContext &context, IPAFrameContext &frameContext,
 
 /**
  * \brief Estimate the relative luminance of the frame with a given gain
- * \param[in] frameContext The shared IPA frame context
+ * \param[in] activeState The active state of the IPA algorithms
  * \param[in] grid The grid used to store the statistics in the IPU3
- * \param[in] stats The IPU3 statistics and ISP results
+ * \param[in] frameContext The current frame context
  * \param[in] gain The gain to apply to the frame
  * \return The relative luminance
  *
@@ -269,7 +244,9 @@ void Agc::computeExposure(IPAContext &context, IPAFrameContext &frameContext,
  * green and blue averages for all cells are first multiplied by the gain, and
  * then saturated to approximate the sensor behaviour at high brightness
  * values. The approximation is quite rough, as it doesn't take into account
- * non-linearities when approaching saturation.
+ * non-linearities when approaching saturation. The sums are computed from the
+ * per-channel histograms of the cell averages, which is cheaper than walking
+ * the whole grid for every gain value.
  *
  * The relative luminance (Y) is computed from the linear RGB components using
  * the Rec. 601 formula. The values are normalized to the [0.0, 1.0] range,
@@ -281,26 +258,19 @@ void Agc::computeExposure(IPAContext &context, IPAFrameContext &frameContext,
  */
 double Agc::estimateLuminance(IPAActiveState &activeState,
 			      const ipu3_uapi_grid_config &grid,
-			      const ipu3_uapi_stats_3a *stats,
+			      const IPAFrameContext &frameContext,
 			      double gain)
 {
+	const auto &stats = frameContext.stats;
 	double redSum = 0, greenSum = 0, blueSum = 0;
 
 	/* Sum the per-channel averages, saturated to 255. */
-	for (unsigned int cellY = 0; cellY < grid.height; cellY++) {
-		for (unsigned int cellX = 0; cellX < grid.width; cellX++) {
-			uint32_t cellPosition = cellY * stride_ + cellX;
-
-			const ipu3_uapi_awb_set_item *cell =
-				reinterpret_cast<const ipu3_uapi_awb_set_item *>(
-					&stats->awb_raw_buffer.meta_data[cellPosition]
-				);
-			const uint8_t G_avg = (cell->Gr_avg + cell->Gb_avg) / 2;
-
-			redSum += std::min(cell->R_avg * gain, 255.0);
-			greenSum += std::min(G_avg * gain, 255.0);
-			blueSum += std::min(cell->B_avg * gain, 255.0);
-		}
+	for (unsigned int value = 0; value < kNumHistogramBins; value++) {
+		double saturated = std::min(value * gain, 255.0);
+
+		redSum += stats.redHistogram[value] * saturated;
+		greenSum += stats.greenHistogram[value] * saturated;
+		blueSum += stats.blueHistogram[value] * saturated;
 	}
 
 	/*
@@ -327,7 +297,7 @@ double Agc::estimateLuminance(IPAActiveState &activeState,
  */
 void Agc::process(IPAContext &context, [[maybe_unused]] const uint32_t frame,
 		  IPAFrameContext &frameContext,
-		  const ipu3_uapi_stats_3a *stats,
+		  [[maybe_unused]] const ipu3_uapi_stats_3a *stats,
 		  ControlList &metadata)
 {
 	/*
@@ -336,8 +306,8 @@ void Agc::process(IPAContext &context, [[maybe_unused]] const uint32_t frame,
 	 * cumulative histogram, and we want it to be as close as possible to a
 	 * configured target.
 	 */
-	double iqMean = measureBrightness(stats, context.configuration.grid.bdsGrid);
-	double iqMeanGain = kEvGainTarget * knumHistogramBins / iqMean;
+	double iqMean = measureBrightness(frameContext);
+	double iqMeanGain = kEvGainTarget * kNumHistogramBins / iqMean;
 
 	/*
 	 * Estimate the gain needed to achieve a relative luminance target. To
@@ -352,7 +322,7 @@ void Agc::process(IPAContext &context, [[maybe_unused]] const uint32_t frame,
 	for (unsigned int i = 0; i < 8; i++) {
 		double yValue = estimateLuminance(context.activeState,
 						  context.configuration.grid.bdsGrid,
-						  stats, yGain);
+						  frameContext, yGain);
 		double extraGain = std::min(10.0, yTarget / (yValue + .001));
 
 		yGain *= extraGain;
@@ -13,6 +13,8 @@
 
 #include <libcamera/geometry.h>
 
+#include "libipa/histogram.h"
+
 #include "algorithm.h"
 
 namespace libcamera {
@@ -34,14 +36,13 @@ public:
 		     ControlList &metadata) override;
 
 private:
-	double measureBrightness(const ipu3_uapi_stats_3a *stats,
-				 const ipu3_uapi_grid_config &grid) const;
+	double measureBrightness(const IPAFrameContext &frameContext);
 	utils::Duration filterExposure(utils::Duration currentExposure);
 	void computeExposure(IPAContext &context, IPAFrameContext &frameContext,
 			     double yGain, double iqMeanGain);
 	double estimateLuminance(IPAActiveState &activeState,
 				 const ipu3_uapi_grid_config &grid,
-				 const ipu3_uapi_stats_3a *stats,
+				 const IPAFrameContext &frameContext,
 				 double gain);
 
 	uint64_t frameCount_;
@@ -54,7 +55,7 @@ private:
 
 	utils::Duration filteredExposure_;
 
-	uint32_t stride_;
+	Histogram histogram_;
 };
 
 } /* namespace ipa::ipu3::algorithms */
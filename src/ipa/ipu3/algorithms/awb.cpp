@@ -7,7 +7,6 @@
 #include "awb.h"
 
 #include <algorithm>
-#include <cmath>
 
 #include <libcamera/base/log.h>
 
@@ -38,40 +37,6 @@ static constexpr uint32_t kMinGreenLevelInZone = 16;
  */
 static constexpr double kMaxCellSaturationRatio = 0.8;
 
-/*
- * Maximum ratio of saturated pixels in a cell for the cell to be considered
- * non-saturated and counted by the AWB algorithm.
- */
-static constexpr uint32_t kMinCellsPerZoneRatio = 255 * 90 / 100;
-
-/**
- * \struct Accumulator
- * \brief RGB statistics for a given zone
- *
- * Accumulate red, green and blue values for each non-saturated item over a
- * zone. Items can for instance be pixels, but also the average of groups of
- * pixels, depending on who uses the accumulator.
- * \todo move this description and structure into a common header
- *
- * Zones which are saturated beyond the threshold defined in
- * ipu3_uapi_awb_config_s are not included in the average.
- *
- * \var Accumulator::counted
- * \brief Number of unsaturated cells used to calculate the sums
- *
- * \var Accumulator::sum
- * \brief A structure containing the average red, green and blue sums
- *
- * \var Accumulator::sum.red
- * \brief Sum of the average red values of each unsaturated cell in the zone
- *
- * \var Accumulator::sum.green
- * \brief Sum of the average green values of each unsaturated cell in the zone
- *
- * \var Accumulator::sum.blue
- * \brief Sum of the average blue values of each unsaturated cell in the zone
- */
-
 /**
  * \struct Awb::AwbStatus
  * \brief AWB parameters calculated
@@ -170,13 +135,13 @@ static const struct ipu3_uapi_ccm_mat_config imguCssCcmDefault = {
  * cells of [16x16] pixels and 16x12 zones of [5x4] cells each
  * (\a kAwbStatsSizeX=16 and \a kAwbStatsSizeY=12). If the number of cells isn't
  * an exact multiple of the number of zones, the right-most and bottom-most
- * cells are ignored. The grid configuration is computed by
- * IPAIPU3::calculateBdsGrid().
+ * cells are ignored, or the right-most and bottom-most zones are smaller. The
+ * grid configuration is computed by IPAIPU3::calculateBdsGrid().
  *
- * Before calculating the gains, the algorithm aggregates the cell averages for
- * each zone in generateAwbStats(). Cells that have a too high ratio of
- * saturated pixels are ignored, and only zones that contain enough
- * non-saturated cells are then used by the algorithm.
+ * The cell averages are aggregated for each zone by the IPA module when it
+ * parses the statistics, and stored in IPAFrameContext::stats. Cells that have
+ * a too high ratio of saturated pixels are ignored, and only zones that contain
+ * enough non-saturated cells are then used by the algorithm.
  *
  * The Grey World algorithm will then estimate the red and blue gains to apply, and
  * store the results in the metadata. The green gain is always set to 1.
@@ -201,18 +166,15 @@ Awb::~Awb() = default;
 int Awb::configure(IPAContext &context,
 		   [[maybe_unused]] const IPAConfigInfo &configInfo)
 {
-	const ipu3_uapi_grid_config &grid = context.configuration.grid.bdsGrid;
-	stride_ = context.configuration.grid.stride;
-
-	cellsPerZoneX_ = std::round(grid.width / static_cast<double>(kAwbStatsSizeX));
-	cellsPerZoneY_ = std::round(grid.height / static_cast<double>(kAwbStatsSizeY));
+	const auto &grid = context.configuration.grid;
 
 	/*
 	 * Configure the minimum proportion of cells counted within a zone
 	 * for it to be relevant for the grey world algorithm.
 	 * \todo This proportion could be configured.
 	 */
-	cellsPerZoneThreshold_ = cellsPerZoneX_ * cellsPerZoneY_ * kMaxCellSaturationRatio;
+	cellsPerZoneThreshold_ = grid.cellsPerZoneX * grid.cellsPerZoneY
+			       * kMaxCellSaturationRatio;
 	LOG(IPU3Awb, Debug) << "Threshold for AWB is set to " << cellsPerZoneThreshold_;
 
 	return 0;
@@ -332,77 +294,24 @@ uint32_t Awb::estimateCCT(double red, double green, double blue)
 }
 
 /* Generate an RGB vector with the average values for each zone */
-void Awb::generateZones()
+void Awb::generateZones(const IPAFrameContext &frameContext)
 {
 	zones_.clear();
 
-	for (unsigned int i = 0; i < kAwbStatsSizeX * kAwbStatsSizeY; i++) {
+	for (const Accumulator &stats : frameContext.stats.zones) {
 		RGB zone;
-		double counted = awbStats_[i].counted;
+		double counted = stats.counted;
 		if (counted >= cellsPerZoneThreshold_) {
-			zone.G = awbStats_[i].sum.green / counted;
+			zone.G = stats.sum.green / counted;
 			if (zone.G >= kMinGreenLevelInZone) {
-				zone.R = awbStats_[i].sum.red / counted;
-				zone.B = awbStats_[i].sum.blue / counted;
+				zone.R = stats.sum.red / counted;
+				zone.B = stats.sum.blue / counted;
 				zones_.push_back(zone);
 			}
 		}
 	}
 }
 
-/* Translate the IPU3 statistics into the default statistics zone array */
-void Awb::generateAwbStats(const ipu3_uapi_stats_3a *stats)
-{
-	/*
-	 * Generate a (kAwbStatsSizeX x kAwbStatsSizeY) array from the IPU3 grid which is
-	 * (grid.width x grid.height).
-	 */
-	for (unsigned int cellY = 0; cellY < kAwbStatsSizeY * cellsPerZoneY_; cellY++) {
-		for (unsigned int cellX = 0; cellX < kAwbStatsSizeX * cellsPerZoneX_; cellX++) {
-			uint32_t cellPosition = cellY * stride_ + cellX;
-			uint32_t zoneX = cellX / cellsPerZoneX_;
-			uint32_t zoneY = cellY / cellsPerZoneY_;
-
-			uint32_t awbZonePosition = zoneY * kAwbStatsSizeX + zoneX;
-
-			/* Cast the initial IPU3 structure to simplify the reading */
-			const ipu3_uapi_awb_set_item *currentCell =
-				reinterpret_cast<const ipu3_uapi_awb_set_item *>(
-					&stats->awb_raw_buffer.meta_data[cellPosition]
-				);
-
-			/*
-			 * Use cells which have less than 90%
-			 * saturation as an initial means to include
-			 * otherwise bright cells which are not fully
-			 * saturated.
-			 *
-			 * \todo The 90% saturation rate may require
-			 * further empirical measurements and
-			 * optimisation during camera tuning phases.
-			 */
-			if (currentCell->sat_ratio <= kMinCellsPerZoneRatio) {
-				/* The cell is not saturated, use the current cell */
-				awbStats_[awbZonePosition].counted++;
-				uint32_t greenValue = currentCell->Gr_avg + currentCell->Gb_avg;
-				awbStats_[awbZonePosition].sum.green += greenValue / 2;
-				awbStats_[awbZonePosition].sum.red += currentCell->R_avg;
-				awbStats_[awbZonePosition].sum.blue += currentCell->B_avg;
-			}
-		}
-	}
-}
-
-void Awb::clearAwbStats()
-{
-	for (unsigned int i = 0; i < kAwbStatsSizeX * kAwbStatsSizeY; i++) {
-		awbStats_[i].sum.blue = 0;
-		awbStats_[i].sum.red = 0;
-		awbStats_[i].sum.green = 0;
-		awbStats_[i].counted = 0;
-	}
-}
-
 void Awb::awbGreyWorld()
 {
 	LOG(IPU3Awb, Debug) << "Grey world AWB";
@@ -452,13 +361,9 @@ void Awb::awbGreyWorld()
 	asyncResults_.blueGain = blueGain;
 }
 
-void Awb::calculateWBGains(const ipu3_uapi_stats_3a *stats)
+void Awb::calculateWBGains(const IPAFrameContext &frameContext)
 {
-	ASSERT(stats->stats_3a_status.awb_en);
-
-	clearAwbStats();
-	generateAwbStats(stats);
-	generateZones();
+	generateZones(frameContext);
 
 	LOG(IPU3Awb, Debug) << "Valid zones: " << zones_.size();
 
@@ -473,11 +378,13 @@ void Awb::calculateWBGains(const ipu3_uapi_stats_3a *stats)
  * \copydoc libcamera::ipa::Algorithm::process
  */
 void Awb::process(IPAContext &context, [[maybe_unused]] const uint32_t frame,
-		  [[maybe_unused]] IPAFrameContext &frameContext,
+		  IPAFrameContext &frameContext,
 		  const ipu3_uapi_stats_3a *stats,
 		  [[maybe_unused]] ControlList &metadata)
 {
-	calculateWBGains(stats);
+	ASSERT(stats->stats_3a_status.awb_en);
+
+	calculateWBGains(frameContext);
 
 	/*
 	 * Gains are only recalculated if enough zones were detected.
@@ -19,19 +19,6 @@ namespace libcamera {
 
 namespace ipa::ipu3::algorithms {
 
-/* Region size for the statistics generation algorithm */
-static constexpr uint32_t kAwbStatsSizeX = 16;
-static constexpr uint32_t kAwbStatsSizeY = 12;
-
-struct Accumulator {
-	unsigned int counted;
-	struct {
-		uint64_t red;
-		uint64_t green;
-		uint64_t blue;
-	} sum;
-};
-
 class Awb : public Algorithm
 {
 public:
@@ -70,22 +57,16 @@ private:
 	};
 
 private:
-	void calculateWBGains(const ipu3_uapi_stats_3a *stats);
-	void generateZones();
-	void generateAwbStats(const ipu3_uapi_stats_3a *stats);
-	void clearAwbStats();
+	void calculateWBGains(const IPAFrameContext &frameContext);
+	void generateZones(const IPAFrameContext &frameContext);
 	void awbGreyWorld();
 	uint32_t estimateCCT(double red, double green, double blue);
 	static constexpr uint16_t threshold(float value);
 	static constexpr uint16_t gainValue(double gain);
 
 	std::vector<RGB> zones_;
-	Accumulator awbStats_[kAwbStatsSizeX * kAwbStatsSizeY];
 	AwbStatus asyncResults_;
 
-	uint32_t stride_;
-	uint32_t cellsPerZoneX_;
-	uint32_t cellsPerZoneY_;
 	uint32_t cellsPerZoneThreshold_;
 };
 
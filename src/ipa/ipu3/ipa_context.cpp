@@ -14,6 +14,49 @@
 
 namespace libcamera::ipa::ipu3 {
 
+/**
+ * \var kAwbStatsSizeX
+ * \brief Number of horizontal zones of the AWB statistics
+ */
+
+/**
+ * \var kAwbStatsSizeY
+ * \brief Number of vertical zones of the AWB statistics
+ */
+
+/**
+ * \var kNumHistogramBins
+ * \brief Number of bins of the per-channel statistics histograms
+ */
+
+/**
+ * \struct Accumulator
+ * \brief RGB statistics for a given zone
+ *
+ * Accumulate red, green and blue values for each non-saturated item over a
+ * zone. Items can for instance be pixels, but also the average of groups of
+ * pixels, depending on who uses the accumulator.
+ * \todo move this description and structure into a common header
+ *
+ * Zones which are saturated beyond the threshold defined in
+ * ipu3_uapi_awb_config_s are not included in the average.
+ *
+ * \var Accumulator::counted
+ * \brief Number of unsaturated cells used to calculate the sums
+ *
+ * \var Accumulator::sum
+ * \brief A structure containing the average red, green and blue sums
+ *
+ * \var Accumulator::sum.red
+ * \brief Sum of the average red values of each unsaturated cell in the zone
+ *
+ * \var Accumulator::sum.green
+ * \brief Sum of the average green values of each unsaturated cell in the zone
+ *
+ * \var Accumulator::sum.blue
+ * \brief Sum of the average blue values of each unsaturated cell in the zone
+ */
+
 /**
  * \struct IPASessionConfiguration
  * \brief Session configuration for the IPA module
@@ -61,6 +104,12 @@ namespace libcamera::ipa::ipu3 {
  *
  * \var IPASessionConfiguration::grid.stride
  * \brief Number of cells on one line including the ImgU padding
+ *
+ * \var IPASessionConfiguration::grid.cellsPerZoneX
+ * \brief Number of horizontal cells in each of the kAwbStatsSizeX AWB zones
+ *
+ * \var IPASessionConfiguration::grid.cellsPerZoneY
+ * \brief Number of vertical cells in each of the kAwbStatsSizeY AWB zones
  */
 
 /**
@@ -178,6 +227,31 @@ namespace libcamera::ipa::ipu3 {
  *
  * \var IPAFrameContext::sensor.gain
  * \brief Analogue gain multiplier
+ *
+ * \var IPAFrameContext::stats
+ * \brief Statistics of the frame, pre-processed for the algorithms
+ *
+ * The ImgU statistics grid is parsed once per frame, before the algorithms
+ * process the statistics, and the results are stored here. Algorithms shall
+ * use them instead of walking the statistics grid themselves.
+ *
+ * \var IPAFrameContext::stats.zones
+ * \brief Accumulated RGB values of the non-saturated cells of each AWB zone
+ *
+ * The zones are stored in raster order, kAwbStatsSizeX per line. Cells that
+ * have more than 90% of saturated pixels are not accumulated.
+ *
+ * \var IPAFrameContext::stats.redHistogram
+ * \brief Histogram of the red average of all cells in the grid
+ *
+ * \var IPAFrameContext::stats.greenHistogram
+ * \brief Histogram of the green average of all cells in the grid
+ *
+ * The green average of a cell is the mean of its Gr and Gb averages, rounded
+ * down.
+ *
+ * \var IPAFrameContext::stats.blueHistogram
+ * \brief Histogram of the blue average of all cells in the grid
  */
 
 } /* namespace libcamera::ipa::ipu3 */
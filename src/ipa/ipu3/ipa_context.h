@@ -8,6 +8,9 @@
 
 #pragma once
 
+#include <array>
+#include <stdint.h>
+
 #include <linux/intel-ipu3.h>
 
 #include <libcamera/base/utils.h>
@@ -20,11 +23,29 @@ namespace libcamera {
 
 namespace ipa::ipu3 {
 
+/* Region size for the statistics generation algorithm */
+static constexpr uint32_t kAwbStatsSizeX = 16;
+static constexpr uint32_t kAwbStatsSizeY = 12;
+
+/* Number of bins of the statistics histograms */
+static constexpr uint32_t kNumHistogramBins = 256;
+
+struct Accumulator {
+	unsigned int counted;
+	struct {
+		uint64_t red;
+		uint64_t green;
+		uint64_t blue;
+	} sum;
+};
+
 struct IPASessionConfiguration {
 	struct {
 		ipu3_uapi_grid_config bdsGrid;
 		Size bdsOutputSize;
 		uint32_t stride;
+		uint32_t cellsPerZoneX;
+		uint32_t cellsPerZoneY;
 	} grid;
 
 	struct {
@@ -78,6 +99,13 @@ struct IPAFrameContext : public FrameContext {
 		uint32_t exposure;
 		double gain;
 	} sensor;
+
+	struct {
+		std::array<Accumulator, kAwbStatsSizeX * kAwbStatsSizeY> zones;
+		std::array<uint32_t, kNumHistogramBins> redHistogram;
+		std::array<uint32_t, kNumHistogramBins> greenHistogram;
+		std::array<uint32_t, kNumHistogramBins> blueHistogram;
+	} stats;
 };
 
 struct IPAContext {
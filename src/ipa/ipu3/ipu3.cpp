@@ -58,6 +58,12 @@ static constexpr uint32_t kMaxCellSizeLog2 = 6;
 /* Maximum number of frame contexts to be held */
 static constexpr uint32_t kMaxFrameContexts = 16;
 
+/*
+ * Maximum ratio of saturated pixels in a cell for the cell to be considered
+ * non-saturated and accumulated in the AWB zones.
+ */
+static constexpr uint32_t kMinCellsPerZoneRatio = 255 * 90 / 100;
+
 namespace libcamera {
 
 LOG_DEFINE_CATEGORY(IPAIPU3)
@@ -173,6 +179,8 @@ private:
 
 	void setControls(unsigned int frame);
 	void calculateBdsGrid(const Size &bdsOutputSize);
+	void parseStatistics(const ipu3_uapi_stats_3a *stats,
+			     IPAFrameContext &frameContext);
 
 	std::map<unsigned int, MappedFrameBuffer> buffers_;
 
@@ -438,11 +446,88 @@ void IPAIPU3::calculateBdsGrid(const Size &bdsOutputSize)
 	/* The ImgU pads the lines to a multiple of 4 cells. */
 	context_.configuration.grid.stride = utils::alignUp(bdsGrid.width, 4);
 
+	/* Group the cells in zones for the AWB statistics. */
+	context_.configuration.grid.cellsPerZoneX =
+		std::round(bdsGrid.width / static_cast<double>(kAwbStatsSizeX));
+	context_.configuration.grid.cellsPerZoneY =
+		std::round(bdsGrid.height / static_cast<double>(kAwbStatsSizeY));
+
 	LOG(IPAIPU3, Debug) << "Best grid found is: ("
 			    << (int)bdsGrid.width << " << " << (int)bdsGrid.block_width_log2 << ") x ("
 			    << (int)bdsGrid.height << " << " << (int)bdsGrid.block_height_log2 << ")";
 }
 
+/**
+ * \brief Pre-process the statistics generated by the ImgU
+ * \param[in] stats The IPU3 statistics and ISP results
+ * \param[out] frameContext The frame context to store the results in
+ *
+ * Walk the statistics grid once to accumulate the AWB zones and the
+ * per-channel histograms of the cell averages used by the algorithms, and
+ * store them in the \a frameContext stats.
+ */
+void IPAIPU3::parseStatistics(const ipu3_uapi_stats_3a *stats,
+			      IPAFrameContext &frameContext)
+{
+	const auto &grid = context_.configuration.grid;
+	auto &results = frameContext.stats;
+
+	results.zones = {};
+	results.redHistogram = {};
+	results.greenHistogram = {};
+	results.blueHistogram = {};
+
+	for (unsigned int cellY = 0; cellY < grid.bdsGrid.height; cellY++) {
+		const ipu3_uapi_awb_set_item *cells =
+			&stats->awb_raw_buffer.meta_data[cellY * grid.stride];
+
+		/*
+		 * Cells past the last zone, when the grid size isn't a multiple
+		 * of the number of zones, are only used for the histograms.
+		 */
+		unsigned int zoneY = cellY / grid.cellsPerZoneY;
+		unsigned int zonesX = zoneY < kAwbStatsSizeY ? kAwbStatsSizeX : 0;
+		Accumulator *zone = &results.zones[std::min(zoneY, kAwbStatsSizeY - 1)
+						   * kAwbStatsSizeX];
+		unsigned int zoneX = 0;
+		unsigned int zoneCells = 0;
+
+		for (unsigned int cellX = 0; cellX < grid.bdsGrid.width; cellX++) {
+			const ipu3_uapi_awb_set_item &cell = cells[cellX];
+			uint8_t green = (cell.Gr_avg + cell.Gb_avg) / 2;
+
+			results.redHistogram[cell.R_avg]++;
+			results.greenHistogram[green]++;
+			results.blueHistogram[cell.B_avg]++;
+
+			if (zoneX >= zonesX)
+				continue;
+
+			/*
+			 * Use cells which have less than 90% saturation as an
+			 * initial means to include otherwise bright cells
+			 * which are not fully saturated.
+			 *
+			 * \todo The 90% saturation rate may require further
+			 * empirical measurements and optimisation during
+			 * camera tuning phases.
+			 */
+			if (cell.sat_ratio <= kMinCellsPerZoneRatio) {
+				zone->counted++;
+				zone->sum.green += green;
+				zone->sum.red += cell.R_avg;
+				zone->sum.blue += cell.B_avg;
+			}
+
+			if (++zoneCells == grid.cellsPerZoneX) {
+				zoneCells = 0;
+				zoneX++;
+				zone++;
+			}
+		}
+	}
+}
+
 /**
  * \brief Configure the IPU3 IPA
  * \param[in] configInfo The IPA configuration data, received from the pipeline
@@ -578,8 +663,9 @@ void IPAIPU3::fillParamsBuffer(const uint32_t frame, const uint32_t bufferId)
  * \param[in] sensorControls Sensor controls
  *
  * Parse the most recently processed image statistics from the ImgU. The
- * statistics are passed to each algorithm module to run their calculations and
- * update their state accordingly.
+ * statistics are pre-processed once in the frame context, and passed to each
+ * algorithm module to run their calculations and update their state
+ * accordingly.
  */
 void IPAIPU3::processStatsBuffer(const uint32_t frame,
 				 [[maybe_unused]] const int64_t frameTimestamp,
@@ -600,6 +686,8 @@ void IPAIPU3::processStatsBuffer(const uint32_t frame,
 	frameContext.sensor.exposure = sensorControls.get(V4L2_CID_EXPOSURE).get<int32_t>();
 	frameContext.sensor.gain = camHelper_->gain(sensorControls.get(V4L2_CID_ANALOGUE_GAIN).get<int32_t>());
 
+	parseStatistics(stats, frameContext);
+
 	ControlList metadata(controls::controls);
 
 	for (auto const &algo : algorithms())
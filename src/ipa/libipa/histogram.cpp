@@ -6,6 +6,7 @@
  */
 #include "histogram.h"
 
+#include <array>
 #include <cmath>
 
 #include <libcamera/base/log.h>
@@ -26,6 +27,17 @@ namespace ipa {
  * This class stores a cumulative frequency histogram, which is a mapping that
  * counts the cumulative number of observations in all of the bins up to the
  * specified bin. It can be used to find quantiles and averages between quantiles.
+ *
+ * The cumulative frequencies are stored in a buffer that is reused when the
+ * histogram is updated with new data, either with update(), or with reset()
+ * and accumulate(). An IPA algorithm that keeps a Histogram instance across
+ * frames thus doesn't allocate memory when processing statistics, once the
+ * first frame has been processed.
+ */
+
+/**
+ * \fn Histogram::Histogram()
+ * \brief Create an empty histogram with zero bins
  */
 
 /**
@@ -34,10 +46,78 @@ namespace ipa {
  */
 Histogram::Histogram(Span<const uint32_t> data)
 {
-	cumulative_.reserve(data.size());
-	cumulative_.push_back(0);
-	for (const uint32_t &value : data)
-		cumulative_.push_back(cumulative_.back() + value);
+	update(data);
+}
+
+/**
+ * \fn Histogram::Histogram(Span<const uint32_t> data, Transform transform)
+ * \brief Create a cumulative histogram with a transformation of the bin values
+ * \tparam Transform The type of the transformation function
+ * \param[in] data A pre-sorted histogram to be passed
+ * \param[in] transform The transformation function to apply to every bin
+ *
+ * The \a transform function is applied to the value of every bin of \a data
+ * before it is accumulated. It can be used to weight the bins, or to ignore
+ * some of them by returning 0.
+ */
+
+/**
+ * \brief Replace the histogram data
+ * \param[in] data A pre-sorted histogram to be passed
+ *
+ * The histogram is recomputed from \a data, reusing the memory of the
+ * cumulative frequencies when the number of bins doesn't grow.
+ */
+void Histogram::update(Span<const uint32_t> data)
+{
+	cumulative_.resize(data.size() + 1);
+	cumulative_[0] = 0;
+	for (size_t i = 0; i < data.size(); i++)
+		cumulative_[i + 1] = cumulative_[i] + data[i];
+}
+
+/**
+ * \fn Histogram::update(Span<const uint32_t> data, Transform transform)
+ * \brief Replace the histogram data with a transformation of the bin values
+ * \tparam Transform The type of the transformation function
+ * \param[in] data A pre-sorted histogram to be passed
+ * \param[in] transform The transformation function to apply to every bin
+ *
+ * \sa Histogram(Span<const uint32_t> data, Transform transform)
+ */
+
+/**
+ * \brief Clear the histogram
+ * \param[in] bins The number of bins
+ *
+ * Set the number of bins of the histogram to \a bins and set all bins to 0.
+ * This is typically followed by calls to accumulate() to combine the
+ * histograms of multiple zones of an image.
+ */
+void Histogram::reset(size_t bins)
+{
+	cumulative_.assign(bins + 1, 0);
+}
+
+/**
+ * \brief Add a weighted histogram to the histogram
+ * \param[in] data A pre-sorted histogram with the same number of bins
+ * \param[in] weight The weight of \a data
+ *
+ * Every bin of \a data is multiplied by \a weight and added to the
+ * corresponding bin of the histogram. This allows building a histogram from
+ * the histograms of a subset of the zones of an image, possibly weighted
+ * differently, without having to sum them in a separate buffer first.
+ */
+void Histogram::accumulate(Span<const uint32_t> data, uint32_t weight)
+{
+	ASSERT(data.size() == bins());
+
+	uint64_t sum = 0;
+	for (size_t i = 0; i < data.size(); i++) {
+		sum += static_cast<uint64_t>(data[i]) * weight;
+		cumulative_[i + 1] += sum;
+	}
 }
 
 /**
@@ -93,16 +173,7 @@ double Histogram::quantile(double q, uint32_t first, uint32_t last) const
 	ASSERT(first <= last);
 
 	uint64_t item = q * total();
-	/* Binary search to find the right bin */
-	while (first < last) {
-		int middle = (first + last) / 2;
-		/* Is it between first and middle ? */
-		if (cumulative_[middle + 1] > item)
-			last = middle;
-		else
-			first = middle + 1;
-	}
-	ASSERT(item >= cumulative_[first] && item <= cumulative_[last + 1]);
+	first = findBin(item, first, last);
 
 	double frac;
 	if (cumulative_[first + 1] == cumulative_[first])
@@ -112,6 +183,37 @@ double Histogram::quantile(double q, uint32_t first, uint32_t last) const
 	return first + frac;
 }
 
+/**
+ * \brief Compute multiple quantiles in a single pass
+ * \param[in] q The desired points, sorted in ascending order (0 <= q <= 1)
+ * \param[out] points The (fractional) bins of the points
+ *
+ * This function is equivalent to calling quantile() for every element of \a q,
+ * and stores the results in the corresponding element of \a points. As the
+ * quantiles are sorted, the search for each of them starts from the bin of the
+ * previous one, which makes it cheaper than separate calls to quantile().
+ */
+void Histogram::quantiles(Span<const double> q, Span<double> points) const
+{
+	ASSERT(q.size() == points.size());
+
+	uint32_t last = cumulative_.size() - 2;
+	uint32_t first = 0;
+	double prev = 0.0;
+
+	for (size_t i = 0; i < q.size(); i++) {
+		ASSERT(q[i] >= prev);
+		prev = q[i];
+
+		uint64_t item = q[i] * total();
+		first = findBin(item, first, last);
+
+		uint64_t freq = cumulative_[first + 1] - cumulative_[first];
+		double frac = freq ? (item - cumulative_[first]) / freq : 0;
+		points[i] = first + frac;
+	}
+}
+
 /**
  * \brief Calculate the mean between two quantiles
  * \param[in] lowQuantile low Quantile
@@ -126,10 +228,16 @@ double Histogram::quantile(double q, uint32_t first, uint32_t last) const
 double Histogram::interQuantileMean(double lowQuantile, double highQuantile) const
 {
 	ASSERT(highQuantile > lowQuantile);
-	/* Proportion of pixels which lies below lowQuantile */
-	double lowPoint = quantile(lowQuantile);
-	/* Proportion of pixels which lies below highQuantile */
-	double highPoint = quantile(highQuantile, static_cast<uint32_t>(lowPoint));
+	/*
+	 * Proportion of pixels which lies below lowQuantile and highQuantile
+	 * respectively.
+	 */
+	const std::array<double, 2> q{ lowQuantile, highQuantile };
+	std::array<double, 2> points;
+	quantiles(q, points);
+
+	double lowPoint = points[0];
+	double highPoint = points[1];
 	double sumBinFreq = 0, cumulFreq = 0;
 
 	for (double p_next = floor(lowPoint) + 1.0;
@@ -148,6 +256,30 @@ double Histogram::interQuantileMean(double lowQuantile, double highQuantile) con
 	return sumBinFreq / cumulFreq + 0.5;
 }
 
+/**
+ * \brief Find the bin that contains an item
+ * \param[in] item The item index in the cumulative frequencies
+ * \param[in] first The low limit of the search
+ * \param[in] last The high limit of the search
+ * \return The first bin between \a first and \a last whose cumulative
+ * frequency is larger than \a item, or \a last if there's none
+ */
+uint32_t Histogram::findBin(uint64_t item, uint32_t first, uint32_t last) const
+{
+	/* Binary search to find the right bin */
+	while (first < last) {
+		int middle = (first + last) / 2;
+		/* Is it between first and middle ? */
+		if (cumulative_[middle + 1] > item)
+			last = middle;
+		else
+			first = middle + 1;
+	}
+	ASSERT(item >= cumulative_[first] && item <= cumulative_[last + 1]);
+
+	return first;
+}
+
 } /* namespace ipa */
 
 } /* namespace libcamera */
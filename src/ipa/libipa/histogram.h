@@ -11,6 +11,7 @@
 #include <limits.h>
 #include <stdint.h>
 
+#include <type_traits>
 #include <vector>
 
 #include <libcamera/base/span.h>
@@ -22,14 +23,41 @@ namespace ipa {
 class Histogram
 {
 public:
+	Histogram() { cumulative_.push_back(0); }
 	Histogram(Span<const uint32_t> data);
+
+	template<typename Transform,
+		 std::enable_if_t<std::is_invocable_v<Transform, uint32_t>> * = nullptr>
+	Histogram(Span<const uint32_t> data, Transform transform)
+	{
+		update(data, transform);
+	}
+
+	void update(Span<const uint32_t> data);
+
+	template<typename Transform,
+		 std::enable_if_t<std::is_invocable_v<Transform, uint32_t>> * = nullptr>
+	void update(Span<const uint32_t> data, Transform transform)
+	{
+		cumulative_.resize(data.size() + 1);
+		cumulative_[0] = 0;
+		for (size_t i = 0; i < data.size(); i++)
+			cumulative_[i + 1] = cumulative_[i] + transform(data[i]);
+	}
+
+	void reset(size_t bins);
+	void accumulate(Span<const uint32_t> data, uint32_t weight = 1);
+
 	size_t bins() const { return cumulative_.size() - 1; }
 	uint64_t total() const { return cumulative_[cumulative_.size() - 1]; }
 	uint64_t cumulativeFrequency(double bin) const;
 	double quantile(double q, uint32_t first = 0, uint32_t last = UINT_MAX) const;
+	void quantiles(Span<const double> q, Span<double> points) const;
 	double interQuantileMean(double lowQuantile, double hiQuantile) const;
 
 private:
+	uint32_t findBin(uint64_t item, uint32_t first, uint32_t last) const;
+
 	std::vector<uint64_t> cumulative_;
 };
 
@@ -83,6 +83,13 @@ namespace ipa {
  * \return The list of instantiated algorithms
  */
 
+/**
+ * \fn Module::algorithmNames()
+ * \brief Retrieve the names of the instantiated algorithms
+ * \return The names of the instantiated algorithms, in the same order as the
+ * algorithms() list
+ */
+
 /**
  * \fn Module::createAlgorithms()
  * \brief Create algorithms from YAML configuration data
@@ -43,6 +43,11 @@ public:
 		return algorithms_;
 	}
 
+	const std::vector<std::string> &algorithmNames() const
+	{
+		return algorithmNames_;
+	}
+
 	int createAlgorithms(Context &context, const YamlObject &algorithms)
 	{
 		const auto &list = algorithms.asList();
@@ -52,12 +57,14 @@ public:
 				LOG(IPAModuleAlgo, Error)
 					<< "Invalid YAML syntax for algorithm " << i;
 				algorithms_.clear();
+				algorithmNames_.clear();
 				return -EINVAL;
 			}
 
 			int ret = createAlgorithm(context, algo);
 			if (ret) {
 				algorithms_.clear();
+				algorithmNames_.clear();
 				return ret;
 			}
 		}
@@ -92,6 +99,7 @@ private:
 			<< "Instantiated algorithm '" << name << "'";
 
 		algorithms_.push_back(std::move(algo));
+		algorithmNames_.push_back(name);
 		return 0;
 	}
 
@@ -117,6 +125,7 @@ private:
 	}
 
 	std::list<std::unique_ptr<Algorithm<Module>>> algorithms_;
+	std::vector<std::string> algorithmNames_;
 };
 
 } /* namespace ipa */
@@ -361,11 +361,11 @@ double Agc::estimateLuminance(const rkisp1_cif_isp_ae_stat *ae,
  * \param[in] hist The histogram statistics computed by the ImgU
  * \return The mean value of the top 2% of the histogram
  */
-double Agc::measureBrightness(const rkisp1_cif_isp_hist_stat *hist) const
+double Agc::measureBrightness(const rkisp1_cif_isp_hist_stat *hist)
 {
-	Histogram histogram{ Span<const uint32_t>(hist->hist_bins, numHistBins_) };
+	histogram_.update({ hist->hist_bins, numHistBins_ });
 	/* Estimate the quantile mean of the top 2% of the histogram. */
-	return histogram.interQuantileMean(0.98, 1.0);
+	return histogram_.interQuantileMean(0.98, 1.0);
 }
 
 void Agc::fillMetadata(IPAContext &context, IPAFrameContext &frameContext,
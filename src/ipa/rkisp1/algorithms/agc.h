@@ -13,6 +13,8 @@
 
 #include <libcamera/geometry.h>
 
+#include "libipa/histogram.h"
+
 #include "algorithm.h"
 
 namespace libcamera {
@@ -43,7 +45,7 @@ private:
 			     double yGain, double iqMeanGain);
 	utils::Duration filterExposure(utils::Duration exposureValue);
 	double estimateLuminance(const rkisp1_cif_isp_ae_stat *ae, double gain);
-	double measureBrightness(const rkisp1_cif_isp_hist_stat *hist) const;
+	double measureBrightness(const rkisp1_cif_isp_hist_stat *hist);
 	void fillMetadata(IPAContext &context, IPAFrameContext &frameContext,
 			  ControlList &metadata);
 
@@ -52,6 +54,8 @@ private:
 	uint32_t numCells_;
 	uint32_t numHistBins_;
 
+	Histogram histogram_;
+
 	utils::Duration filteredExposure_;
 };
 
@@ -0,0 +1,206 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+/*
+ * Copyright (C) 2026, Ideas on Board Oy
+ *
+ * recorder.cpp - RkISP1 IPA interface recorder
+ */
+
+#include "recorder.h"
+
+#include <string.h>
+
+#include <libcamera/base/log.h>
+#include <libcamera/base/utils.h>
+
+#include <libcamera/ipa/rkisp1_ipa_serializer.h>
+
+/**
+ * \file recorder.h
+ * \brief Recording of the RkISP1 IPA interface calls
+ */
+
+namespace libcamera {
+
+LOG_DEFINE_CATEGORY(RkISP1Recorder)
+
+namespace ipa::rkisp1 {
+
+/**
+ * \class Recorder
+ * \brief Record the IPA interface calls and statistics to a file
+ *
+ * The Recorder stores the calls received by the IPA module, along with the
+ * contents of the statistics buffers, in the format described in
+ * ipa_recording.h. Recording is enabled by setting the
+ * LIBCAMERA_RKISP1_RECORD_FILE environment variable to the path of the output
+ * file. The recording can be replayed offline with the ipa-replay tool.
+ *
+ * Recording is meant for tuning and debugging sessions. All data is written
+ * synchronously from the IPA thread.
+ */
+
+Recorder::Recorder()
+	: serializer_(ControlSerializer::Role::Proxy)
+{
+}
+
+/**
+ * \brief Create a recorder if recording is enabled
+ * \return A new Recorder, or nullptr if recording is disabled or the output
+ * file can't be created
+ */
+std::unique_ptr<Recorder> Recorder::create()
+{
+	const char *path = utils::secure_getenv("LIBCAMERA_RKISP1_RECORD_FILE");
+	if (!path)
+		return nullptr;
+
+	std::unique_ptr<Recorder> recorder{ new Recorder() };
+
+	recorder->file_.open(path, std::ios::binary | std::ios::trunc);
+	if (!recorder->file_) {
+		LOG(RkISP1Recorder, Error)
+			<< "Failed to create recording file " << path;
+		return nullptr;
+	}
+
+	struct ipa_recording_header header = {};
+	memcpy(header.magic, IPA_RECORDING_MAGIC, sizeof(header.magic));
+	header.version = IPA_RECORDING_FORMAT_VERSION;
+	utils::strlcpy(header.pipeline, "rkisp1", sizeof(header.pipeline));
+
+	recorder->file_.write(reinterpret_cast<const char *>(&header),
+			      sizeof(header));
+
+	LOG(RkISP1Recorder, Info) << "Recording IPA calls to " << path;
+
+	return recorder;
+}
+
+/**
+ * \brief Record the init() call
+ * \param[in] settings The IPA settings
+ * \param[in] hwRevision The ISP hardware revision
+ * \param[in] sensorInfo The camera sensor information
+ * \param[in] sensorControls The camera sensor controls
+ */
+void Recorder::init(const IPASettings &settings, unsigned int hwRevision,
+		    const IPACameraSensorInfo &sensorInfo,
+		    const ControlInfoMap &sensorControls)
+{
+	serializer_.reset();
+	sensorControls_ = sensorControls;
+
+	appendChunk(std::get<0>(IPADataSerializer<IPASettings>::serialize(settings)));
+	appendChunk(std::get<0>(IPADataSerializer<uint32_t>::serialize(hwRevision)));
+	appendChunk(std::get<0>(IPADataSerializer<IPACameraSensorInfo>::serialize(sensorInfo)));
+	appendChunk(std::get<0>(IPADataSerializer<ControlInfoMap>::serialize(sensorControls_,
+									       &serializer_)));
+
+	writeRecord(IPA_RECORD_INIT, 0);
+}
+
+/**
+ * \brief Record the configure() call
+ * \param[in] ipaConfig The IPA configuration information
+ * \param[in] streamConfig The stream configuration
+ */
+void Recorder::configure(const IPAConfigInfo &ipaConfig,
+			 const std::map<uint32_t, IPAStream> &streamConfig)
+{
+	serializer_.reset();
+	sensorControls_ = {};
+	ipaConfig_ = ipaConfig;
+
+	appendChunk(std::get<0>(IPADataSerializer<IPAConfigInfo>::serialize(ipaConfig_,
+									      &serializer_)));
+	appendChunk(std::get<0>(IPADataSerializer<std::map<uint32_t, IPAStream>>::serialize(streamConfig)));
+
+	writeRecord(IPA_RECORD_CONFIGURE, 0);
+}
+
+/**
+ * \brief Record the start() call
+ */
+void Recorder::start()
+{
+	writeRecord(IPA_RECORD_START, 0);
+}
+
+/**
+ * \brief Record the stop() call
+ */
+void Recorder::stop()
+{
+	writeRecord(IPA_RECORD_STOP, 0);
+	file_.flush();
+}
+
+/**
+ * \brief Record the queueRequest() call
+ * \param[in] frame The frame number
+ * \param[in] controls The request controls
+ */
+void Recorder::queueRequest(uint32_t frame, const ControlList &controls)
+{
+	appendChunk(std::get<0>(IPADataSerializer<ControlList>::serialize(controls,
+									    &serializer_)));
+
+	writeRecord(IPA_RECORD_QUEUE_REQUEST, frame);
+}
+
+/**
+ * \brief Record the fillParamsBuffer() call
+ * \param[in] frame The frame number
+ */
+void Recorder::fillParamsBuffer(uint32_t frame)
+{
+	writeRecord(IPA_RECORD_FILL_PARAMS, frame);
+}
+
+/**
+ * \brief Record the processStatsBuffer() call
+ * \param[in] frame The frame number
+ * \param[in] stats The statistics buffer contents, empty in raw mode
+ * \param[in] sensorControls The sensor controls applied to the frame
+ */
+void Recorder::processStatsBuffer(uint32_t frame, Span<const uint8_t> stats,
+				  const ControlList &sensorControls)
+{
+	appendChunk(stats);
+	appendChunk(std::get<0>(IPADataSerializer<ControlList>::serialize(sensorControls,
+									    &serializer_)));
+
+	writeRecord(IPA_RECORD_PROCESS_STATS, frame);
+}
+
+void Recorder::appendChunk(Span<const uint8_t> data)
+{
+	uint32_t size = data.size();
+	const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&size);
+
+	payload_.insert(payload_.end(), bytes, bytes + sizeof(size));
+	payload_.insert(payload_.end(), data.begin(), data.end());
+}
+
+void Recorder::writeRecord(enum ipa_record_type type, uint32_t frame)
+{
+	struct ipa_record_header header = {};
+	header.type = type;
+	header.frame = frame;
+	header.size = payload_.size();
+
+	file_.write(reinterpret_cast<const char *>(&header), sizeof(header));
+	file_.write(reinterpret_cast<const char *>(payload_.data()),
+		    payload_.size());
+
+	if (!file_)
+		LOG(RkISP1Recorder, Error) << "Failed to write record";
+
+	/* Keep the memory allocated for the next record. */
+	payload_.clear();
+}
+
+} /* namespace ipa::rkisp1 */
+
+} /* namespace libcamera */
@@ -0,0 +1,67 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+/*
+ * Copyright (C) 2026, Ideas on Board Oy
+ *
+ * recorder.h - RkISP1 IPA interface recorder
+ */
+
+#pragma once
+
+#include <fstream>
+#include <map>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include <libcamera/base/span.h>
+
+#include <libcamera/controls.h>
+#include <libcamera/ipa/rkisp1_ipa_interface.h>
+
+#include "libcamera/internal/control_serializer.h"
+#include "libcamera/internal/ipa_recording.h"
+
+namespace libcamera {
+
+namespace ipa::rkisp1 {
+
+class Recorder
+{
+public:
+	static std::unique_ptr<Recorder> create();
+
+	void init(const IPASettings &settings, unsigned int hwRevision,
+		  const IPACameraSensorInfo &sensorInfo,
+		  const ControlInfoMap &sensorControls);
+	void configure(const IPAConfigInfo &ipaConfig,
+		       const std::map<uint32_t, IPAStream> &streamConfig);
+	void start();
+	void stop();
+
+	void queueRequest(uint32_t frame, const ControlList &controls);
+	void fillParamsBuffer(uint32_t frame);
+	void processStatsBuffer(uint32_t frame, Span<const uint8_t> stats,
+				const ControlList &sensorControls);
+
+private:
+	Recorder();
+
+	void appendChunk(Span<const uint8_t> data);
+	void writeRecord(enum ipa_record_type type, uint32_t frame);
+
+	std::ofstream file_;
+	ControlSerializer serializer_;
+	std::vector<uint8_t> payload_;
+
+	/*
+	 * The serializer caches the ControlInfoMap instances by address, keep
+	 * the ones it has serialized alive until it gets reset.
+	 */
+	ControlInfoMap sensorControls_;
+	IPAConfigInfo ipaConfig_;
+};
+
+} /* namespace ipa::rkisp1 */
+
+} /* namespace libcamera */
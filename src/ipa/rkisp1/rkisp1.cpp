@@ -6,6 +6,7 @@
  */
 
 #include <algorithm>
+#include <chrono>
 #include <math.h>
 #include <queue>
 #include <stdint.h>
@@ -16,6 +17,7 @@
 
 #include <libcamera/base/file.h>
 #include <libcamera/base/log.h>
+#include <libcamera/base/utils.h>
 
 #include <libcamera/control_ids.h>
 #include <libcamera/framebuffer.h>
@@ -32,6 +34,7 @@
 #include "libipa/camera_sensor_helper.h"
 
 #include "ipa_context.h"
+#include "recorder.h"
 
 namespace libcamera {
 
@@ -75,6 +78,7 @@ private:
 			    const ControlInfoMap &sensorControls,
 			    ControlInfoMap *ipaControls);
 	void setControls(unsigned int frame);
+	void reportTimings();
 
 	std::map<unsigned int, FrameBuffer> buffers_;
 	std::map<unsigned int, MappedFrameBuffer> mappedBuffers_;
@@ -92,6 +96,19 @@ private:
 
 	/* Local parameter storage */
 	struct IPAContext context_;
+
+	/* Recording of the interface calls, if enabled */
+	std::unique_ptr<Recorder> recorder_;
+
+	/* Per-algorithm processing time, if profiling is enabled */
+	struct AlgorithmTimings {
+		utils::Duration prepare;
+		utils::Duration process;
+	};
+
+	bool profile_;
+	unsigned int profiledFrames_;
+	std::vector<AlgorithmTimings> timings_;
 };
 
 namespace {
@@ -111,8 +128,10 @@ const ControlInfoMap::Map rkisp1Controls{
 } /* namespace */
 
 IPARkISP1::IPARkISP1()
-	: context_({ {}, {}, { kMaxFrameContexts } })
+	: context_({ {}, {}, { kMaxFrameContexts } }), profiledFrames_(0)
 {
+	recorder_ = Recorder::create();
+	profile_ = recorder_ || utils::secure_getenv("LIBCAMERA_RKISP1_PROFILE");
 }
 
 std::string IPARkISP1::logPrefix() const
@@ -146,6 +165,9 @@ int IPARkISP1::init(const IPASettings &settings, unsigned int hwRevision,
 
 	LOG(IPARkISP1, Debug) << "Hardware revision is " << hwRevision;
 
+	if (recorder_)
+		recorder_->init(settings, hwRevision, sensorInfo, sensorControls);
+
 	/* Cache the value to set it in configure. */
 	hwRevision_ = static_cast<rkisp1_cif_isp_version>(hwRevision);
 
@@ -191,6 +213,8 @@ int IPARkISP1::init(const IPASettings &settings, unsigned int hwRevision,
 	if (ret)
 		return ret;
 
+	timings_.resize(algorithms().size());
+
 	/* Initialize controls. */
 	updateControls(sensorInfo, sensorControls, ipaControls);
 
@@ -199,6 +223,9 @@ int IPARkISP1::init(const IPASettings &settings, unsigned int hwRevision,
 
 int IPARkISP1::start()
 {
+	if (recorder_)
+		recorder_->start();
+
 	setControls(0);
 
 	return 0;
@@ -206,6 +233,12 @@ int IPARkISP1::start()
 
 void IPARkISP1::stop()
 {
+	if (recorder_)
+		recorder_->stop();
+
+	if (profile_)
+		reportTimings();
+
 	context_.frameContexts.clear();
 }
 
@@ -213,6 +246,9 @@ int IPARkISP1::configure(const IPAConfigInfo &ipaConfig,
 			 const std::map<uint32_t, IPAStream> &streamConfig,
 			 ControlInfoMap *ipaControls)
 {
+	if (recorder_)
+		recorder_->configure(ipaConfig, streamConfig);
+
 	sensorControls_ = ipaConfig.sensorControls;
 
 	const auto itExp = sensorControls_.find(V4L2_CID_EXPOSURE);
@@ -313,6 +349,9 @@ void IPARkISP1::unmapBuffers(const std::vector<unsigned int> &ids)
 
 void IPARkISP1::queueRequest(const uint32_t frame, const ControlList &controls)
 {
+	if (recorder_)
+		recorder_->queueRequest(frame, controls);
+
 	IPAFrameContext &frameContext = context_.frameContexts.alloc(frame);
 
 	for (auto const &a : algorithms()) {
@@ -325,6 +364,9 @@ void IPARkISP1::queueRequest(const uint32_t frame, const ControlList &controls)
 
 void IPARkISP1::fillParamsBuffer(const uint32_t frame, const uint32_t bufferId)
 {
+	if (recorder_)
+		recorder_->fillParamsBuffer(frame);
+
 	IPAFrameContext &frameContext = context_.frameContexts.get(frame);
 
 	rkisp1_params_cfg *params =
@@ -334,8 +376,17 @@ void IPARkISP1::fillParamsBuffer(const uint32_t frame, const uint32_t bufferId)
 	/* Prepare parameters buffer. */
 	memset(params, 0, sizeof(*params));
 
-	for (auto const &algo : algorithms())
+	unsigned int index = 0;
+	for (auto const &algo : algorithms()) {
+		if (!profile_) {
+			algo->prepare(context_, frame, frameContext, params);
+			continue;
+		}
+
+		auto begin = std::chrono::steady_clock::now();
 		algo->prepare(context_, frame, frameContext, params);
+		timings_[index++].prepare += std::chrono::steady_clock::now() - begin;
+	}
 
 	paramsBufferReady.emit(frame);
 }
@@ -354,6 +405,13 @@ void IPARkISP1::processStatsBuffer(const uint32_t frame, const uint32_t bufferId
 		stats = reinterpret_cast<rkisp1_stat_buffer *>(
 			mappedBuffers_.at(bufferId).planes()[0].data());
 
+	if (recorder_) {
+		Span<const uint8_t> data;
+		if (stats)
+			data = { reinterpret_cast<const uint8_t *>(stats), sizeof(*stats) };
+		recorder_->processStatsBuffer(frame, data, sensorControls);
+	}
+
 	frameContext.sensor.exposure =
 		sensorControls.get(V4L2_CID_EXPOSURE).get<int32_t>();
 	frameContext.sensor.gain =
@@ -361,13 +419,25 @@ void IPARkISP1::processStatsBuffer(const uint32_t frame, const uint32_t bufferId
 
 	ControlList metadata(controls::controls);
 
+	unsigned int index = 0;
 	for (auto const &a : algorithms()) {
 		Algorithm *algo = static_cast<Algorithm *>(a.get());
+		AlgorithmTimings &timings = timings_[index++];
 		if (algo->disabled_)
 			continue;
+
+		if (!profile_) {
+			algo->process(context_, frame, frameContext, stats, metadata);
+			continue;
+		}
+
+		auto begin = std::chrono::steady_clock::now();
 		algo->process(context_, frame, frameContext, stats, metadata);
+		timings.process += std::chrono::steady_clock::now() - begin;
 	}
 
+	profiledFrames_++;
+
 	setControls(frame);
 
 	metadataReady.emit(frame, metadata);
@@ -449,6 +519,32 @@ void IPARkISP1::setControls(unsigned int frame)
 	setSensorControls.emit(frame, ctrls);
 }
 
+void IPARkISP1::reportTimings()
+{
+	if (!profiledFrames_)
+		return;
+
+	LOG(IPARkISP1, Info)
+		<< "Average algorithm processing time over "
+		<< profiledFrames_ << " frames:";
+
+	unsigned int index = 0;
+	for (const std::string &name : algorithmNames()) {
+		AlgorithmTimings &timings = timings_[index++];
+
+		LOG(IPARkISP1, Info)
+			<< "  " << name << ": prepare "
+			<< timings.prepare.get<std::micro>() / profiledFrames_
+			<< "us, process "
+			<< timings.process.get<std::micro>() / profiledFrames_
+			<< "us";
+
+		timings = {};
+	}
+
+	profiledFrames_ = 0;
+}
+
 } /* namespace ipa::rkisp1 */
 
 /*
@@ -13,6 +13,8 @@
 
 #include "libcamera/internal/v4l2_videodevice.h"
 
+#include "controller/metadata_tags.h"
+
 #include "cam_helper.h"
 #include "md_parser.h"
 
@@ -235,8 +237,8 @@ void CamHelper::parseEmbeddedData(Span<const uint8_t> buffer,
 	 * Fetch it first in case any other fields were set meaningfully.
 	 */
 	DeviceStatus deviceStatus, parsedDeviceStatus;
-	if (metadata.get("device.status", deviceStatus) ||
-	    parsedMetadata.get("device.status", parsedDeviceStatus)) {
+	if (metadata.get(DeviceStatusTag, deviceStatus) ||
+	    parsedMetadata.get(DeviceStatusTag, parsedDeviceStatus)) {
 		LOG(IPARPI, Error) << "DeviceStatus not found";
 		return;
 	}
@@ -250,7 +252,7 @@ void CamHelper::parseEmbeddedData(Span<const uint8_t> buffer,
 
 	LOG(IPARPI, Debug) << "Metadata updated - " << deviceStatus;
 
-	metadata.set("device.status", deviceStatus);
+	metadata.set(DeviceStatusTag, deviceStatus);
 }
 
 void CamHelper::populateMetadata([[maybe_unused]] const MdParser::RegisterMap &registers,
@@ -16,6 +16,8 @@
  */
 #define ENABLE_EMBEDDED_DATA 0
 
+#include "controller/metadata_tags.h"
+
 #include "cam_helper.h"
 #if ENABLE_EMBEDDED_DATA
 #include "md_parser.h"
@@ -104,7 +106,7 @@ void CamHelperImx219::populateMetadata(const MdParser::RegisterMap &registers,
 	deviceStatus.analogueGain = gain(registers.at(gainReg));
 	deviceStatus.frameLength = registers.at(frameLengthHiReg) * 256 + registers.at(frameLengthLoReg);
 
-	metadata.set("device.status", deviceStatus);
+	metadata.set(DeviceStatusTag, deviceStatus);
 }
 
 static CamHelper *create()
@@ -15,6 +15,8 @@
 
 #include <libcamera/base/log.h>
 
+#include "controller/metadata_tags.h"
+
 #include "cam_helper.h"
 #include "md_parser.h"
 
@@ -90,7 +92,7 @@ void CamHelperImx519::prepare(libcamera::Span<const uint8_t> buffer, Metadata &m
 	MdParser::RegisterMap registers;
 	DeviceStatus deviceStatus;
 
-	if (metadata.get("device.status", deviceStatus)) {
+	if (metadata.get(DeviceStatusTag, deviceStatus)) {
 		LOG(IPARPI, Error) << "DeviceStatus not found from DelayedControls";
 		return;
 	}
@@ -111,10 +113,10 @@ void CamHelperImx519::prepare(libcamera::Span<const uint8_t> buffer, Metadata &m
 	if (deviceStatus.frameLength > frameLengthMax) {
 		DeviceStatus parsedDeviceStatus;
 
-		metadata.get("device.status", parsedDeviceStatus);
+		metadata.get(DeviceStatusTag, parsedDeviceStatus);
 		parsedDeviceStatus.shutterSpeed = deviceStatus.shutterSpeed;
 		parsedDeviceStatus.frameLength = deviceStatus.frameLength;
-		metadata.set("device.status", parsedDeviceStatus);
+		metadata.set(DeviceStatusTag, parsedDeviceStatus);
 
 		LOG(IPARPI, Debug) << "Metadata updated for long exposure: "
 				   << parsedDeviceStatus;
@@ -185,7 +187,7 @@ void CamHelperImx519::populateMetadata(const MdParser::RegisterMap &registers,
 	deviceStatus.analogueGain = gain(registers.at(gainHiReg) * 256 + registers.at(gainLoReg));
 	deviceStatus.frameLength = registers.at(frameLengthHiReg) * 256 + registers.at(frameLengthLoReg);
 
-	metadata.set("device.status", deviceStatus);
+	metadata.set(DeviceStatusTag, deviceStatus);
 }
 
 static CamHelper *create()
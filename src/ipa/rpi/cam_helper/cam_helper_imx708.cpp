@@ -12,6 +12,7 @@
 
 #include <libcamera/base/log.h>
 
+#include "controller/metadata_tags.h"
 #include "controller/pdaf_data.h"
 
 #include "cam_helper.h"
@@ -112,7 +113,7 @@ void CamHelperImx708::prepare(libcamera::Span<const uint8_t> buffer, Metadata &m
 
 	LOG(IPARPI, Debug) << "Embedded buffer size: " << buffer.size();
 
-	if (metadata.get("device.status", deviceStatus)) {
+	if (metadata.get(DeviceStatusTag, deviceStatus)) {
 		LOG(IPARPI, Error) << "DeviceStatus not found from DelayedControls";
 		return;
 	}
@@ -130,7 +131,7 @@ void CamHelperImx708::prepare(libcamera::Span<const uint8_t> buffer, Metadata &m
 		if (parsePdafData(&buffer[2 * bytesPerLine],
 				  buffer.size() - 2 * bytesPerLine,
 				  mode_.bitdepth, pdaf))
-			metadata.set("pdaf.regions", pdaf);
+			metadata.set(PdafRegionsTag, pdaf);
 	}
 
 	/* Parse AE-HIST data where present */
@@ -154,10 +155,10 @@ void CamHelperImx708::prepare(libcamera::Span<const uint8_t> buffer, Metadata &m
 	if (deviceStatus.frameLength > frameLengthMax) {
 		DeviceStatus parsedDeviceStatus;
 
-		metadata.get("device.status", parsedDeviceStatus);
+		metadata.get(DeviceStatusTag, parsedDeviceStatus);
 		parsedDeviceStatus.shutterSpeed = deviceStatus.shutterSpeed;
 		parsedDeviceStatus.frameLength = deviceStatus.frameLength;
-		metadata.set("device.status", parsedDeviceStatus);
+		metadata.set(DeviceStatusTag, parsedDeviceStatus);
 
 		LOG(IPARPI, Debug) << "Metadata updated for long exposure: "
 				   << parsedDeviceStatus;
@@ -261,7 +262,7 @@ void CamHelperImx708::populateMetadata(const MdParser::RegisterMap &registers,
 	deviceStatus.frameLength = registers.at(frameLengthHiReg) * 256 + registers.at(frameLengthLoReg);
 	deviceStatus.sensorTemperature = std::clamp<int8_t>(registers.at(temperatureReg), -20, 80);
 
-	metadata.set("device.status", deviceStatus);
+	metadata.set(DeviceStatusTag, deviceStatus);
 }
 
 bool CamHelperImx708::parsePdafData(const uint8_t *ptr, size_t len,
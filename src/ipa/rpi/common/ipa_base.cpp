@@ -25,6 +25,7 @@
 #include "controller/contrast_algorithm.h"
 #include "controller/denoise_algorithm.h"
 #include "controller/lux_status.h"
+#include "controller/metadata_tags.h"
 #include "controller/sharpen_algorithm.h"
 #include "controller/statistics.h"
 
@@ -287,7 +288,7 @@ void IpaBase::start(const ControlList &controls, StartResult *result)
 	agcStatus.shutterTime = 0.0s;
 	agcStatus.analogueGain = 0.0;
 
-	metadata.get("agc.status", agcStatus);
+	metadata.get(RPiController::AgcStatusTag, agcStatus);
 	if (agcStatus.shutterTime && agcStatus.analogueGain) {
 		ControlList ctrls(sensorCtrls_);
 		applyAGC(&agcStatus, ctrls);
@@ -398,8 +399,8 @@ void IpaBase::prepareIsp(const PrepareParams &params)
 	 */
 	AgcStatus agcStatus;
 	RPiController::Metadata &delayedMetadata = rpiMetadata_[params.delayContext];
-	if (!delayedMetadata.get<AgcStatus>("agc.status", agcStatus))
-		rpiMetadata.set("agc.delayed_status", agcStatus);
+	if (!delayedMetadata.get(RPiController::AgcStatusTag, agcStatus))
+		rpiMetadata.set(RPiController::AgcDelayedStatusTag, agcStatus);
 
 	/*
 	 * This may overwrite the DeviceStatus using values from the sensor
@@ -463,13 +464,13 @@ void IpaBase::processStats(const ProcessParams &params)
 		RPiController::StatisticsPtr statistics = platformProcessStats(it->second.planes()[0]);
 
 		/* reportMetadata() will pick this up and set the FocusFoM metadata */
-		rpiMetadata.set("focus.status", statistics->focusRegions);
+		rpiMetadata.set(RPiController::FocusStatusTag, statistics->focusRegions);
 
 		helper_->process(statistics, rpiMetadata);
 		controller_.process(statistics, &rpiMetadata);
 
 		struct AgcStatus agcStatus;
-		if (rpiMetadata.get("agc.status", agcStatus) == 0) {
+		if (rpiMetadata.get(RPiController::AgcStatusTag, agcStatus) == 0) {
 			ControlList ctrls(sensorCtrls_);
 			applyAGC(&agcStatus, ctrls);
 			setDelayedControls.emit(ctrls, ipaContext);
@@ -1190,7 +1191,7 @@ void IpaBase::fillDeviceStatus(const ControlList &sensorControls, unsigned int i
 
 	LOG(IPARPI, Debug) << "Metadata - " << deviceStatus;
 
-	rpiMetadata_[ipaContext].set("device.status", deviceStatus);
+	rpiMetadata_[ipaContext].set(RPiController::DeviceStatusTag, deviceStatus);
 }
 
 void IpaBase::reportMetadata(unsigned int ipaContext)
@@ -1203,7 +1204,7 @@ void IpaBase::reportMetadata(unsigned int ipaContext)
 	 * processed can be extracted and placed into the libcamera metadata
 	 * buffer, where an application could query it.
 	 */
-	DeviceStatus *deviceStatus = rpiMetadata.getLocked<DeviceStatus>("device.status");
+	DeviceStatus *deviceStatus = rpiMetadata.getLocked(RPiController::DeviceStatusTag);
 	if (deviceStatus) {
 		libcameraMetadata_.set(controls::ExposureTime,
 				       deviceStatus->shutterSpeed.get<std::micro>());
@@ -1216,24 +1217,24 @@ void IpaBase::reportMetadata(unsigned int ipaContext)
 			libcameraMetadata_.set(controls::LensPosition, *deviceStatus->lensPosition);
 	}
 
-	AgcStatus *agcStatus = rpiMetadata.getLocked<AgcStatus>("agc.status");
+	AgcStatus *agcStatus = rpiMetadata.getLocked(RPiController::AgcStatusTag);
 	if (agcStatus) {
 		libcameraMetadata_.set(controls::AeLocked, agcStatus->locked);
 		libcameraMetadata_.set(controls::DigitalGain, agcStatus->digitalGain);
 	}
 
-	LuxStatus *luxStatus = rpiMetadata.getLocked<LuxStatus>("lux.status");
+	LuxStatus *luxStatus = rpiMetadata.getLocked(RPiController::LuxStatusTag);
 	if (luxStatus)
 		libcameraMetadata_.set(controls::Lux, luxStatus->lux);
 
-	AwbStatus *awbStatus = rpiMetadata.getLocked<AwbStatus>("awb.status");
+	AwbStatus *awbStatus = rpiMetadata.getLocked(RPiController::AwbStatusTag);
 	if (awbStatus) {
 		libcameraMetadata_.set(controls::ColourGains, { static_cast<float>(awbStatus->gainR),
 								static_cast<float>(awbStatus->gainB) });
 		libcameraMetadata_.set(controls::ColourTemperature, awbStatus->temperatureK);
 	}
 
-	BlackLevelStatus *blackLevelStatus = rpiMetadata.getLocked<BlackLevelStatus>("black_level.status");
+	BlackLevelStatus *blackLevelStatus = rpiMetadata.getLocked(RPiController::BlackLevelStatusTag);
 	if (blackLevelStatus)
 		libcameraMetadata_.set(controls::SensorBlackLevels,
 				       { static_cast<int32_t>(blackLevelStatus->blackLevelR),
@@ -1242,7 +1243,7 @@ void IpaBase::reportMetadata(unsigned int ipaContext)
 					 static_cast<int32_t>(blackLevelStatus->blackLevelB) });
 
 	RPiController::FocusRegions *focusStatus =
-		rpiMetadata.getLocked<RPiController::FocusRegions>("focus.status");
+		rpiMetadata.getLocked(RPiController::FocusStatusTag);
 	if (focusStatus) {
 		/*
 		 * Calculate the average FoM over the central (symmetric) positions
@@ -1266,7 +1267,7 @@ void IpaBase::reportMetadata(unsigned int ipaContext)
 		libcameraMetadata_.set(controls::FocusFoM, focusFoM);
 	}
 
-	CcmStatus *ccmStatus = rpiMetadata.getLocked<CcmStatus>("ccm.status");
+	CcmStatus *ccmStatus = rpiMetadata.getLocked(RPiController::CcmStatusTag);
 	if (ccmStatus) {
 		float m[9];
 		for (unsigned int i = 0; i < 9; i++)
@@ -1274,7 +1275,7 @@ void IpaBase::reportMetadata(unsigned int ipaContext)
 		libcameraMetadata_.set(controls::ColourCorrectionMatrix, m);
 	}
 
-	const AfStatus *afStatus = rpiMetadata.getLocked<AfStatus>("af.status");
+	const AfStatus *afStatus = rpiMetadata.getLocked(RPiController::AfStatusTag);
 	if (afStatus) {
 		int32_t s, p;
 		switch (afStatus->state) {
@@ -49,6 +49,14 @@ public:
 	{
 		return controller_->getHardwareConfig();
 	}
+	TaskScheduler &getTaskScheduler() const
+	{
+		return controller_->getTaskScheduler();
+	}
+	uint64_t getFrameCount() const
+	{
+		return controller_->getFrameCount();
+	}
 
 private:
 	Controller *controller_;
@@ -5,7 +5,9 @@
  * controller.cpp - ISP controller
  */
 
+#include <algorithm>
 #include <assert.h>
+#include <thread>
 
 #include <libcamera/base/file.h>
 #include <libcamera/base/log.h>
@@ -39,8 +41,17 @@ static const std::map<std::string, Controller::HardwareConfig> HardwareConfigMap
 	},
 };
 
+/*
+ * Maximum number of worker threads running asynchronous algorithm tasks for
+ * each camera. This matches the number of algorithms (ALSC and AWB) that
+ * currently use asynchronous tasks.
+ */
+static constexpr unsigned int MaxAsyncThreads = 2;
+
 Controller::Controller()
-	: switchModeCalled_(false)
+	: taskScheduler_(std::min(std::max(std::thread::hardware_concurrency(), 1u),
+				  MaxAsyncThreads)),
+	  switchModeCalled_(false), frameCount_(0)
 {
 }
 
@@ -136,6 +147,7 @@ void Controller::process(StatisticsPtr stats, Metadata *imageMetadata)
 	assert(switchModeCalled_);
 	for (auto &algo : algorithms_)
 		algo->process(stats, imageMetadata);
+	frameCount_++;
 }
 
 Metadata &Controller::getGlobalMetadata()
@@ -168,6 +180,16 @@ const std::string &Controller::getTarget() const
 	return target_;
 }
 
+TaskScheduler &Controller::getTaskScheduler()
+{
+	return taskScheduler_;
+}
+
+uint64_t Controller::getFrameCount() const
+{
+	return frameCount_;
+}
+
 const Controller::HardwareConfig &Controller::getHardwareConfig() const
 {
 	auto cfg = HardwareConfigMap.find(getTarget());
@@ -21,6 +21,7 @@
 #include "device_status.h"
 #include "metadata.h"
 #include "statistics.h"
+#include "task_scheduler.h"
 
 namespace RPiController {
 
@@ -58,13 +59,19 @@ public:
 	Algorithm *getAlgorithm(std::string const &name) const;
 	const std::string &getTarget() const;
 	const HardwareConfig &getHardwareConfig() const;
+	TaskScheduler &getTaskScheduler();
+	uint64_t getFrameCount() const;
 
 protected:
 	int createAlgorithm(const std::string &name, const libcamera::YamlObject &params);
 
 	Metadata globalMetadata_;
+	/* Must outlive the algorithms, which own tasks submitted to it */
+	TaskScheduler taskScheduler_;
 	std::vector<AlgorithmPtr> algorithms_;
 	bool switchModeCalled_;
+	/* Number of frames processed so far, used to tag asynchronous tasks */
+	uint64_t frameCount_;
 
 private:
 	std::string target_;
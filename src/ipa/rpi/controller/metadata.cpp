@@ -0,0 +1,25 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+/*
+ * Copyright (C) 2026, Ideas on Board Oy
+ *
+ * metadata.cpp - general metadata class
+ */
+#include <unordered_map>
+
+#include "metadata.h"
+
+using namespace RPiController;
+
+/*
+ * Return the slot of the given tag, registering it if not seen before. Slots
+ * are shared by all the Metadata instances, and never released.
+ */
+unsigned int Metadata::tagId(std::string const &tag)
+{
+	static std::mutex mutex;
+	static std::unordered_map<std::string, unsigned int> tags;
+
+	std::scoped_lock lock(mutex);
+	auto [it, inserted] = tags.try_emplace(tag, tags.size());
+	return it->second;
+}
@@ -9,14 +9,31 @@
 /* A simple class for carrying arbitrary metadata, for example about an image. */
 
 #include <any>
-#include <map>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <typeinfo>
+#include <vector>
 
 #include <libcamera/base/thread_annotations.h>
 
 namespace RPiController {
 
+template<typename T>
+class MetadataTag;
+
+/*
+ * Tags are registered once, the first time they are used, and mapped to a
+ * compact integer slot. Each Metadata instance stores its values in a vector
+ * indexed by slot, and keeps the storage of a value when it is cleared or
+ * overwritten with a value of the same type. Once a Metadata instance has
+ * seen all the tags it carries, setting, getting, copying and merging values
+ * therefore don't allocate memory (other than what the values themselves may
+ * need).
+ *
+ * Values can be accessed with string tags, or more efficiently with typed
+ * MetadataTag instances that skip the tag lookup.
+ */
 class LIBCAMERA_TSA_CAPABILITY("mutex") Metadata
 {
 public:
@@ -25,59 +42,84 @@ public:
 	Metadata(Metadata const &other)
 	{
 		std::scoped_lock otherLock(other.mutex_);
-		data_ = other.data_;
+		copyFrom(other);
 	}
 
 	Metadata(Metadata &&other)
 	{
 		std::scoped_lock otherLock(other.mutex_);
-		data_ = std::move(other.data_);
-		other.data_.clear();
+		slots_ = std::move(other.slots_);
+		other.slots_.clear();
 	}
 
+	static unsigned int tagId(std::string const &tag);
+
 	template<typename T>
 	void set(std::string const &tag, T const &value)
 	{
 		std::scoped_lock lock(mutex_);
-		data_[tag] = value;
+		setSlot(tagId(tag), value);
+	}
+
+	template<typename T>
+	void set(MetadataTag<T> const &tag,
+		 typename MetadataTag<T>::ValueType const &value)
+	{
+		std::scoped_lock lock(mutex_);
+		setSlot(tag.id(), value);
 	}
 
 	template<typename T>
 	int get(std::string const &tag, T &value) const
 	{
 		std::scoped_lock lock(mutex_);
-		auto it = data_.find(tag);
-		if (it == data_.end())
-			return -1;
-		value = std::any_cast<T>(it->second);
-		return 0;
+		return getSlot(tagId(tag), value);
+	}
+
+	template<typename T>
+	int get(MetadataTag<T> const &tag,
+		typename MetadataTag<T>::ValueType &value) const
+	{
+		std::scoped_lock lock(mutex_);
+		return getSlot(tag.id(), value);
 	}
 
 	void clear()
 	{
 		std::scoped_lock lock(mutex_);
-		data_.clear();
+		for (auto &slot : slots_) {
+			if (slot)
+				slot->valid = false;
+		}
 	}
 
 	Metadata &operator=(Metadata const &other)
 	{
 		std::scoped_lock lock(mutex_, other.mutex_);
-		data_ = other.data_;
+		copyFrom(other);
 		return *this;
 	}
 
 	Metadata &operator=(Metadata &&other)
 	{
 		std::scoped_lock lock(mutex_, other.mutex_);
-		data_ = std::move(other.data_);
-		other.data_.clear();
+		slots_ = std::move(other.slots_);
+		other.slots_.clear();
 		return *this;
 	}
 
 	void merge(Metadata &other)
 	{
 		std::scoped_lock lock(mutex_, other.mutex_);
-		data_.merge(other.data_);
+		/*
+		 * Move the values whose tag doesn't exist here, leaving the
+		 * others in place, as std::map::merge() does.
+		 */
+		resize(other.slots_.size());
+		for (unsigned int id = 0; id < other.slots_.size(); id++) {
+			if (isValid(other.slots_[id]) && !isValid(slots_[id]))
+				std::swap(slots_[id], other.slots_[id]);
+		}
 	}
 
 	void mergeCopy(const Metadata &other)
@@ -87,7 +129,11 @@ public:
 		 * If the metadata key exists, ignore this item and copy only
 		 * unique key/value pairs.
 		 */
-		data_.insert(other.data_.begin(), other.data_.end());
+		resize(other.slots_.size());
+		for (unsigned int id = 0; id < other.slots_.size(); id++) {
+			if (isValid(other.slots_[id]) && !isValid(slots_[id]))
+				copySlot(slots_[id], *other.slots_[id]);
+		}
 	}
 
 	template<typename T>
@@ -97,17 +143,27 @@ public:
 		 * This allows in-place access to the Metadata contents,
 		 * for which you should be holding the lock.
 		 */
-		auto it = data_.find(tag);
-		if (it == data_.end())
-			return nullptr;
-		return std::any_cast<T>(&it->second);
+		return findSlot<T>(tagId(tag));
+	}
+
+	template<typename T>
+	T *getLocked(MetadataTag<T> const &tag)
+	{
+		return findSlot<T>(tag.id());
 	}
 
 	template<typename T>
 	void setLocked(std::string const &tag, T const &value)
 	{
 		/* Use this only if you're holding the lock yourself. */
-		data_[tag] = value;
+		setSlot(tagId(tag), value);
+	}
+
+	template<typename T>
+	void setLocked(MetadataTag<T> const &tag,
+		       typename MetadataTag<T>::ValueType const &value)
+	{
+		setSlot(tag.id(), value);
 	}
 
 	/*
@@ -119,8 +175,153 @@ public:
 	void unlock() LIBCAMERA_TSA_RELEASE() { mutex_.unlock(); }
 
 private:
+	struct SlotBase {
+		SlotBase(std::type_info const &t)
+			: type(t)
+		{
+		}
+
+		virtual ~SlotBase() = default;
+		virtual std::unique_ptr<SlotBase> clone() const = 0;
+		/* Copy the value of other in place, if of the same type. */
+		virtual bool assign(SlotBase const &other) = 0;
+
+		std::type_info const &type;
+		bool valid = false;
+	};
+
+	template<typename T>
+	struct Slot final : public SlotBase {
+		Slot()
+			: SlotBase(typeid(T))
+		{
+		}
+
+		std::unique_ptr<SlotBase> clone() const override
+		{
+			return std::make_unique<Slot<T>>(*this);
+		}
+
+		bool assign(SlotBase const &other) override
+		{
+			if (other.type != type)
+				return false;
+
+			const Slot<T> *typed = static_cast<const Slot<T> *>(&other);
+
+			value = typed->value;
+			valid = typed->valid;
+			return true;
+		}
+
+		T value;
+	};
+
+	/*
+	 * Compare the type of the slot before casting it, as a tag can be set
+	 * with a different type through its name. This is cheaper than a
+	 * dynamic_cast, which walks the class hierarchy.
+	 */
+	template<typename T>
+	static Slot<T> *slotCast(SlotBase *slot)
+	{
+		if (!slot || slot->type != typeid(T))
+			return nullptr;
+
+		return static_cast<Slot<T> *>(slot);
+	}
+
+	static bool isValid(std::unique_ptr<SlotBase> const &slot)
+	{
+		return slot && slot->valid;
+	}
+
+	static void copySlot(std::unique_ptr<SlotBase> &slot, SlotBase const &other)
+	{
+		if (!slot || !slot->assign(other))
+			slot = other.clone();
+	}
+
+	void resize(unsigned int size)
+	{
+		if (slots_.size() < size)
+			slots_.resize(size);
+	}
+
+	void copyFrom(Metadata const &other)
+	{
+		resize(other.slots_.size());
+		for (unsigned int id = 0; id < slots_.size(); id++) {
+			if (id < other.slots_.size() && isValid(other.slots_[id]))
+				copySlot(slots_[id], *other.slots_[id]);
+			else if (slots_[id])
+				slots_[id]->valid = false;
+		}
+	}
+
+	template<typename T>
+	void setSlot(unsigned int id, T const &value)
+	{
+		resize(id + 1);
+
+		std::unique_ptr<SlotBase> &slot = slots_[id];
+		Slot<T> *typed = slotCast<T>(slot.get());
+		if (!typed) {
+			slot = std::make_unique<Slot<T>>();
+			typed = static_cast<Slot<T> *>(slot.get());
+		}
+
+		typed->value = value;
+		typed->valid = true;
+	}
+
+	template<typename T>
+	T *findSlot(unsigned int id) const
+	{
+		if (id >= slots_.size() || !isValid(slots_[id]))
+			return nullptr;
+
+		Slot<T> *typed = slotCast<T>(slots_[id].get());
+		return typed ? &typed->value : nullptr;
+	}
+
+	template<typename T>
+	int getSlot(unsigned int id, T &value) const
+	{
+		if (id >= slots_.size() || !isValid(slots_[id]))
+			return -1;
+
+		T *typed = findSlot<T>(id);
+		if (!typed)
+			throw std::bad_any_cast();
+
+		value = *typed;
+		return 0;
+	}
+
 	mutable std::mutex mutex_;
-	std::map<std::string, std::any> data_;
+	std::vector<std::unique_ptr<SlotBase>> slots_;
+};
+
+/*
+ * A tag with a statically known value type, registered once at construction
+ * time. Tags are usually defined as global constants, see metadata_tags.h.
+ */
+template<typename T>
+class MetadataTag
+{
+public:
+	using ValueType = T;
+
+	explicit MetadataTag(std::string const &name)
+		: id_(Metadata::tagId(name))
+	{
+	}
+
+	unsigned int id() const { return id_; }
+
+private:
+	unsigned int id_;
 };
 
 } /* namespace RPiController */
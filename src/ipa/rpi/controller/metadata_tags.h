@@ -0,0 +1,51 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+/*
+ * Copyright (C) 2026, Ideas on Board Oy
+ *
+ * metadata_tags.h - typed tags for the metadata exchanged by the algorithms
+ */
+#pragma once
+
+#include "af_status.h"
+#include "agc_status.h"
+#include "alsc_status.h"
+#include "awb_status.h"
+#include "black_level_status.h"
+#include "ccm_status.h"
+#include "contrast_status.h"
+#include "denoise_status.h"
+#include "device_status.h"
+#include "dpc_status.h"
+#include "geq_status.h"
+#include "lux_status.h"
+#include "metadata.h"
+#include "noise_status.h"
+#include "pdaf_data.h"
+#include "sharpen_status.h"
+#include "statistics.h"
+
+namespace RPiController {
+
+/*
+ * Each tag is equivalent to the string it is constructed with, which can still
+ * be used to access the same values.
+ */
+inline const MetadataTag<AfStatus> AfStatusTag("af.status");
+inline const MetadataTag<AgcStatus> AgcStatusTag("agc.status");
+inline const MetadataTag<AgcStatus> AgcDelayedStatusTag("agc.delayed_status");
+inline const MetadataTag<AlscStatus> AlscStatusTag("alsc.status");
+inline const MetadataTag<AwbStatus> AwbStatusTag("awb.status");
+inline const MetadataTag<BlackLevelStatus> BlackLevelStatusTag("black_level.status");
+inline const MetadataTag<CcmStatus> CcmStatusTag("ccm.status");
+inline const MetadataTag<ContrastStatus> ContrastStatusTag("contrast.status");
+inline const MetadataTag<DenoiseStatus> DenoiseStatusTag("denoise.status");
+inline const MetadataTag<DeviceStatus> DeviceStatusTag("device.status");
+inline const MetadataTag<DpcStatus> DpcStatusTag("dpc.status");
+inline const MetadataTag<FocusRegions> FocusStatusTag("focus.status");
+inline const MetadataTag<GeqStatus> GeqStatusTag("geq.status");
+inline const MetadataTag<LuxStatus> LuxStatusTag("lux.status");
+inline const MetadataTag<NoiseStatus> NoiseStatusTag("noise.status");
+inline const MetadataTag<PdafRegions> PdafRegionsTag("pdaf.regions");
+inline const MetadataTag<SharpenStatus> SharpenStatusTag("sharpen.status");
+
+} /* namespace RPiController */
@@ -72,6 +72,22 @@ double Pwl::eval(double x, int *spanPtr, bool updateSpan) const
 	int span = findSpan(x, spanPtr && *spanPtr != -1 ? *spanPtr : points_.size() / 2 - 1);
 	if (spanPtr && updateSpan)
 		*spanPtr = span;
+	return interpolate(x, span);
+}
+
+void Pwl::eval(libcamera::Span<const double> x, libcamera::Span<double> y) const
+{
+	assert(x.size() == y.size());
+
+	int span = points_.size() / 2 - 1;
+	for (unsigned int i = 0; i < x.size(); i++) {
+		span = findSpan(x[i], span);
+		y[i] = interpolate(x[i], span);
+	}
+}
+
+double Pwl::interpolate(double x, int span) const
+{
 	return points_[span].y +
 	       (x - points_[span].x) * (points_[span + 1].y - points_[span].y) /
 		       (points_[span + 1].x - points_[span].x);
@@ -10,6 +10,8 @@
 #include <math.h>
 #include <vector>
 
+#include <libcamera/base/span.h>
+
 #include "libcamera/internal/yaml_parser.h"
 
 namespace RPiController {
@@ -72,6 +74,13 @@ public:
 	 */
 	double eval(double x, int *spanPtr = nullptr,
 		    bool updateSpan = true) const;
+	/*
+	 * Evaluate Pwl at all the x values, storing the results in y, which
+	 * must be the same size. The span found for each value is the initial
+	 * guess for the next one, so this is most efficient when the x values
+	 * are sorted.
+	 */
+	void eval(libcamera::Span<const double> x, libcamera::Span<double> y) const;
 	/*
 	 * Find perpendicular closest to xy, starting from span+1 so you can
 	 * call it repeatedly to check for multiple closest points (set span to
@@ -121,6 +130,7 @@ public:
 
 private:
 	int findSpan(double x, int span) const;
+	double interpolate(double x, int span) const;
 	std::vector<Point> points_;
 };
 
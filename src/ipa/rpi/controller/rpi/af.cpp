@@ -15,6 +15,8 @@
 
 #include <libcamera/control_ids.h>
 
+#include "../metadata_tags.h"
+
 using namespace RPiController;
 using namespace libcamera;
 
@@ -631,7 +633,7 @@ void Af::prepare(Metadata *imageMetadata)
 		double oldFs = fsmooth_;
 		ScanState oldSs = scanState_;
 		uint32_t oldSt = stepCount_;
-		if (imageMetadata->get("pdaf.regions", regions) == 0)
+		if (imageMetadata->get(PdafRegionsTag, regions) == 0)
 			getPhase(regions, phase, conf);
 		doAF(prevContrast_, phase, conf);
 		updateLensPosition();
@@ -660,7 +662,7 @@ void Af::prepare(Metadata *imageMetadata)
 		status.state = reportState_;
 	status.lensSetting = initted_ ? std::optional<int>(cfg_.map.eval(fsmooth_))
 				      : std::nullopt;
-	imageMetadata->set("af.status", status);
+	imageMetadata->set(AfStatusTag, status);
 }
 
 void Af::process(StatisticsPtr &stats, [[maybe_unused]] Metadata *imageMetadata)
@@ -16,6 +16,7 @@
 #include "../histogram.h"
 #include "../lux_status.h"
 #include "../metadata.h"
+#include "../metadata_tags.h"
 
 #include "agc.h"
 
@@ -420,7 +421,7 @@ void Agc::prepare(Metadata *imageMetadata)
 	Duration totalExposureValue = status_.totalExposureValue;
 	AgcStatus delayedStatus;
 
-	if (!imageMetadata->get("agc.delayed_status", delayedStatus))
+	if (!imageMetadata->get(AgcDelayedStatusTag, delayedStatus))
 		totalExposureValue = delayedStatus.totalExposureValue;
 
 	status_.digitalGain = 1.0;
@@ -429,7 +430,7 @@ void Agc::prepare(Metadata *imageMetadata)
 	if (status_.totalExposureValue) {
 		/* Process has run, so we have meaningful values. */
 		DeviceStatus deviceStatus;
-		if (imageMetadata->get("device.status", deviceStatus) == 0) {
+		if (imageMetadata->get(DeviceStatusTag, deviceStatus) == 0) {
 			Duration actualExposure = deviceStatus.shutterSpeed *
 						  deviceStatus.analogueGain;
 			if (actualExposure) {
@@ -449,7 +450,7 @@ void Agc::prepare(Metadata *imageMetadata)
 			}
 		} else
 			LOG(RPiAgc, Warning) << name() << ": no device metadata";
-		imageMetadata->set("agc.status", status_);
+		imageMetadata->set(AgcStatusTag, status_);
 	}
 }
 
@@ -578,13 +579,13 @@ void Agc::fetchCurrentExposure(Metadata *imageMetadata)
 {
 	std::unique_lock<Metadata> lock(*imageMetadata);
 	DeviceStatus *deviceStatus =
-		imageMetadata->getLocked<DeviceStatus>("device.status");
+		imageMetadata->getLocked(DeviceStatusTag);
 	if (!deviceStatus)
 		LOG(RPiAgc, Fatal) << "No device metadata";
 	current_.shutter = deviceStatus->shutterSpeed;
 	current_.analogueGain = deviceStatus->analogueGain;
 	AgcStatus *agcStatus =
-		imageMetadata->getLocked<AgcStatus>("agc.status");
+		imageMetadata->getLocked(AgcStatusTag);
 	current_.totalExposure = agcStatus ? agcStatus->totalExposureValue : 0s;
 	current_.totalExposureNoDG = current_.shutter * current_.analogueGain;
 }
@@ -594,7 +595,7 @@ void Agc::fetchAwbStatus(Metadata *imageMetadata)
 	awb_.gainR = 1.0; /* in case not found in metadata */
 	awb_.gainG = 1.0;
 	awb_.gainB = 1.0;
-	if (imageMetadata->get("awb.status", awb_) != 0)
+	if (imageMetadata->get(AwbStatusTag, awb_) != 0)
 		LOG(RPiAgc, Debug) << "No AWB status found";
 }
 
@@ -651,7 +652,7 @@ void Agc::computeGain(StatisticsPtr &statistics, Metadata *imageMetadata,
 {
 	struct LuxStatus lux = {};
 	lux.lux = 400; /* default lux level to 400 in case no metadata found */
-	if (imageMetadata->get("lux.status", lux) != 0)
+	if (imageMetadata->get(LuxStatusTag, lux) != 0)
 		LOG(RPiAgc, Warning) << "No lux level found";
 	const Histogram &h = statistics->yHist;
 	double evGain = status_.ev * config_.baseEv;
@@ -885,7 +886,7 @@ void Agc::writeAndFinish(Metadata *imageMetadata, bool desaturate)
 	 * Write to metadata as well, in case anyone wants to update the camera
 	 * immediately.
 	 */
-	imageMetadata->set("agc.status", status_);
+	imageMetadata->set(AgcStatusTag, status_);
 	LOG(RPiAgc, Debug) << "Output written, total exposure requested is "
 			   << filtered_.totalExposure;
 	LOG(RPiAgc, Debug) << "Camera exposure update: shutter time " << filtered_.shutter
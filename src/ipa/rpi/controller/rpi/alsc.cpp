@@ -6,6 +6,7 @@
  */
 
 #include <algorithm>
+#include <chrono>
 #include <functional>
 #include <math.h>
 #include <numeric>
@@ -14,6 +15,7 @@
 #include <libcamera/base/span.h>
 
 #include "../awb_status.h"
+#include "../metadata_tags.h"
 #include "alsc.h"
 
 /* Raspberry Pi ALSC (Auto Lens Shading Correction) algorithm. */
@@ -28,20 +30,14 @@ LOG_DEFINE_CATEGORY(RPiAlsc)
 static const double InsufficientData = -1.0;
 
 Alsc::Alsc(Controller *controller)
-	: Algorithm(controller)
+	: Algorithm(controller),
+	  asyncTask_(getTaskScheduler(), std::bind(&Alsc::doAlsc, this))
 {
-	asyncAbort_ = asyncStart_ = asyncStarted_ = asyncFinished_ = false;
-	asyncThread_ = std::thread(std::bind(&Alsc::asyncFunc, this));
 }
 
 Alsc::~Alsc()
 {
-	{
-		std::lock_guard<std::mutex> lock(mutex_);
-		asyncAbort_ = true;
-	}
-	asyncSignal_.notify_one();
-	asyncThread_.join();
+	asyncTask_.abort();
 }
 
 char const *Alsc::name() const
@@ -193,6 +189,9 @@ static void getCalTable(double ct, std::vector<AlscCalibration> const &calibrati
 			Array2D<double> &calTable);
 static void resampleCalTable(const Array2D<double> &calTableIn, CameraMode const &cameraMode,
 			     Array2D<double> &calTableOut);
+static void resampleCalibrations(const std::vector<AlscCalibration> &calibrationsIn,
+				 CameraMode const &cameraMode,
+				 std::vector<AlscCalibration> &calibrationsOut);
 static void compensateLambdasForCal(const Array2D<double> &calTable,
 				    const Array2D<double> &oldLambdas,
 				    Array2D<double> &newLambdas);
@@ -208,8 +207,6 @@ void Alsc::initialise()
 	firstTime_ = true;
 	ct_ = config_.defaultCt;
 
-	const size_t XY = config_.tableSize.width * config_.tableSize.height;
-
 	for (auto &r : syncResults_)
 		r.resize(config_.tableSize);
 	for (auto &r : prevSyncResults_)
@@ -227,20 +224,16 @@ void Alsc::initialise()
 	/* Temporaries for the computations, but sensible to allocate this up-front! */
 	for (auto &c : tmpC_)
 		c.resize(config_.tableSize);
-	for (auto &m : tmpM_)
-		m.resize(XY);
+	for (auto &m : tmpM_) {
+		for (auto &c : m)
+			c.resize(config_.tableSize);
+	}
 }
 
-void Alsc::waitForAysncThread()
+void Alsc::waitForAsyncTask()
 {
-	if (asyncStarted_) {
-		asyncStarted_ = false;
-		std::unique_lock<std::mutex> lock(mutex_);
-		syncSignal_.wait(lock, [&] {
-			return asyncFinished_;
-		});
-		asyncFinished_ = false;
-	}
+	/* Wait for any running computation, discarding its results. */
+	asyncTask_.reset();
 }
 
 static bool compareModes(CameraMode const &cm0, CameraMode const &cm1)
@@ -280,8 +273,8 @@ void Alsc::switchMode(CameraMode const &cameraMode,
 	/* Believe the colour temperature from the AWB, if there is one. */
 	ct_ = getCt(metadata, ct_);
 
-	/* Ensure the other thread isn't running while we do this. */
-	waitForAysncThread();
+	/* Ensure the async task isn't running while we do this. */
+	waitForAsyncTask();
 
 	cameraMode_ = cameraMode;
 
@@ -291,6 +284,15 @@ void Alsc::switchMode(CameraMode const &cameraMode,
 	 */
 	resampleCalTable(config_.luminanceLut, cameraMode_, luminanceTable_);
 
+	/*
+	 * The calibration tables are fixed too. Resampling is linear, so
+	 * resampling them all here and interpolating between the resampled
+	 * tables gives the same result as resampling the interpolated table,
+	 * without doing so on every run of the algorithm.
+	 */
+	resampleCalibrations(config_.calibrationsCr, cameraMode_, calibrationsCr_);
+	resampleCalibrations(config_.calibrationsCb, cameraMode_, calibrationsCb_);
+
 	if (resetTables) {
 		/*
 		 * Upon every "table reset", arrange for something sensible to be
@@ -301,11 +303,9 @@ void Alsc::switchMode(CameraMode const &cameraMode,
 		 */
 		std::fill(lambdaR_.begin(), lambdaR_.end(), 1.0);
 		std::fill(lambdaB_.begin(), lambdaB_.end(), 1.0);
-		Array2D<double> &calTableR = tmpC_[0], &calTableB = tmpC_[1], &calTableTmp = tmpC_[2];
-		getCalTable(ct_, config_.calibrationsCr, calTableTmp);
-		resampleCalTable(calTableTmp, cameraMode_, calTableR);
-		getCalTable(ct_, config_.calibrationsCb, calTableTmp);
-		resampleCalTable(calTableTmp, cameraMode_, calTableB);
+		Array2D<double> &calTableR = tmpC_[0], &calTableB = tmpC_[1];
+		getCalTable(ct_, calibrationsCr_, calTableR);
+		getCalTable(ct_, calibrationsCb_, calTableB);
 		compensateLambdasForCal(calTableR, lambdaR_, asyncLambdaR_);
 		compensateLambdasForCal(calTableB, lambdaB_, asyncLambdaB_);
 		addLuminanceToTables(syncResults_, asyncLambdaR_, 1.0, asyncLambdaB_,
@@ -318,17 +318,18 @@ void Alsc::switchMode(CameraMode const &cameraMode,
 
 void Alsc::fetchAsyncResults()
 {
-	LOG(RPiAlsc, Debug) << "Fetch ALSC results";
-	asyncFinished_ = false;
-	asyncStarted_ = false;
+	LOG(RPiAlsc, Debug)
+		<< "Fetch ALSC results started at frame " << asyncTask_.frame()
+		<< ", " << getFrameCount() - asyncTask_.frame() << " frames ago";
 	syncResults_ = asyncResults_;
+	asyncTask_.reset();
 }
 
 double getCt(Metadata *metadata, double defaultCt)
 {
 	AwbStatus awbStatus;
 	awbStatus.temperatureK = defaultCt; /* in case nothing found */
-	if (metadata->get("awb.status", awbStatus) != 0)
+	if (metadata->get(AwbStatusTag, awbStatus) != 0)
 		LOG(RPiAlsc, Debug) << "no AWB results found, using "
 				    << awbStatus.temperatureK;
 	else
@@ -368,7 +369,7 @@ void Alsc::restartAsync(StatisticsPtr &stats, Metadata *imageMetadata)
 	 * the LSC table that the pipeline applied to them.
 	 */
 	AlscStatus alscStatus;
-	if (imageMetadata->get("alsc.status", alscStatus) != 0) {
+	if (imageMetadata->get(AlscStatusTag, alscStatus) != 0) {
 		LOG(RPiAlsc, Warning)
 			<< "No ALSC status found for applied gains!";
 		alscStatus.r.resize(config_.tableSize.width * config_.tableSize.height, 1.0);
@@ -377,19 +378,14 @@ void Alsc::restartAsync(StatisticsPtr &stats, Metadata *imageMetadata)
 	}
 	copyStats(statistics_, stats, alscStatus);
 	framePhase_ = 0;
-	asyncStarted_ = true;
-	{
-		std::lock_guard<std::mutex> lock(mutex_);
-		asyncStart_ = true;
-	}
-	asyncSignal_.notify_one();
+	asyncTask_.start(getFrameCount());
 }
 
 void Alsc::prepare(Metadata *imageMetadata)
 {
 	/*
 	 * Count frames since we started, and since we last poked the async
-	 * thread.
+	 * task.
 	 */
 	if (frameCount_ < (int)config_.startupFrames)
 		frameCount_++;
@@ -398,11 +394,8 @@ void Alsc::prepare(Metadata *imageMetadata)
 			       : config_.speed;
 	LOG(RPiAlsc, Debug)
 		<< "frame count " << frameCount_ << " speed " << speed;
-	{
-		std::unique_lock<std::mutex> lock(mutex_);
-		if (asyncStarted_ && asyncFinished_)
-			fetchAsyncResults();
-	}
+	if (asyncTask_.finished())
+		fetchAsyncResults();
 	/* Apply IIR filter to results and program into the pipeline. */
 	for (unsigned int j = 0; j < syncResults_.size(); j++) {
 		for (unsigned int i = 0; i < syncResults_[j].size(); i++)
@@ -413,14 +406,14 @@ void Alsc::prepare(Metadata *imageMetadata)
 	status.r = prevSyncResults_[0].data();
 	status.g = prevSyncResults_[1].data();
 	status.b = prevSyncResults_[2].data();
-	imageMetadata->set("alsc.status", status);
+	imageMetadata->set(AlscStatusTag, status);
 }
 
 void Alsc::process(StatisticsPtr &stats, Metadata *imageMetadata)
 {
 	/*
 	 * Count frames since we started, and since we last poked the async
-	 * thread.
+	 * task.
 	 */
 	if (framePhase_ < (int)config_.framePeriod)
 		framePhase_++;
@@ -429,32 +422,11 @@ void Alsc::process(StatisticsPtr &stats, Metadata *imageMetadata)
 	LOG(RPiAlsc, Debug) << "frame_phase " << framePhase_;
 	if (framePhase_ >= (int)config_.framePeriod ||
 	    frameCount2_ < (int)config_.startupFrames) {
-		if (asyncStarted_ == false)
+		if (!asyncTask_.busy())
 			restartAsync(stats, imageMetadata);
 	}
 }
 
-void Alsc::asyncFunc()
-{
-	while (true) {
-		{
-			std::unique_lock<std::mutex> lock(mutex_);
-			asyncSignal_.wait(lock, [&] {
-				return asyncStart_ || asyncAbort_;
-			});
-			asyncStart_ = false;
-			if (asyncAbort_)
-				break;
-		}
-		doAlsc();
-		{
-			std::lock_guard<std::mutex> lock(mutex_);
-			asyncFinished_ = true;
-		}
-		syncSignal_.notify_one();
-	}
-}
-
 void getCalTable(double ct, std::vector<AlscCalibration> const &calibrations,
 		 Array2D<double> &calTable)
 {
@@ -541,6 +513,19 @@ void resampleCalTable(const Array2D<double> &calTableIn,
 	}
 }
 
+void resampleCalibrations(const std::vector<AlscCalibration> &calibrationsIn,
+			  CameraMode const &cameraMode,
+			  std::vector<AlscCalibration> &calibrationsOut)
+{
+	calibrationsOut.resize(calibrationsIn.size());
+	for (unsigned int i = 0; i < calibrationsIn.size(); i++) {
+		calibrationsOut[i].ct = calibrationsIn[i].ct;
+		calibrationsOut[i].table.resize(calibrationsIn[i].table.dimensions());
+		resampleCalTable(calibrationsIn[i].table, cameraMode,
+				 calibrationsOut[i].table);
+	}
+}
+
 /* Calculate chrominance statistics (R/G and B/G) for each region. */
 static void calculateCrCb(const RgbyRegions &awbRegion, Array2D<double> &cr,
 			  Array2D<double> &cb, uint32_t minCount, uint16_t minG)
@@ -605,19 +590,33 @@ static double computeWeight(double Ci, double Cj, double sigma)
 	return exp(-diff * diff / 2);
 }
 
+namespace RPiController {
+
 /* Compute all weights. */
-static void computeW(const Array2D<double> &C, double sigma,
-		     SparseArray<double> &W)
+void computeW(const Array2D<double> &C, double sigma, SparseArray<double> &W)
 {
 	size_t XY = C.size();
 	size_t X = C.dimensions().width;
 
+	for (auto &w : W)
+		std::fill(w.begin(), w.end(), 0.0);
+
+	/*
+	 * The weights are symmetrical, compute them once for every pair of
+	 * neighbours. W[0] to W[3] hold the weights of the neighbours above,
+	 * to the right, below and to the left.
+	 */
 	for (unsigned int i = 0; i < XY; i++) {
-		/* Start with neighbour above and go clockwise. */
-		W[i][0] = i >= X ? computeWeight(C[i], C[i - X], sigma) : 0;
-		W[i][1] = i % X < X - 1 ? computeWeight(C[i], C[i + 1], sigma) : 0;
-		W[i][2] = i < XY - X ? computeWeight(C[i], C[i + X], sigma) : 0;
-		W[i][3] = i % X ? computeWeight(C[i], C[i - 1], sigma) : 0;
+		if (i % X < X - 1) {
+			double w = computeWeight(C[i], C[i + 1], sigma);
+			W[1][i] = w;
+			W[3][i + 1] = w;
+		}
+		if (i < XY - X) {
+			double w = computeWeight(C[i], C[i + X], sigma);
+			W[2][i] = w;
+			W[0][i + X] = w;
+		}
 	}
 }
 
@@ -638,98 +637,75 @@ static void constructM(const Array2D<double> &C,
 		int m = !!(i >= X) + !!(i % X < X - 1) + !!(i < XY - X) +
 			!!(i % X); /* total number of neighbours */
 		/* we'll divide the diagonal out straight away */
-		double diagonal = (epsilon + W[i][0] + W[i][1] + W[i][2] + W[i][3]) * C[i];
-		M[i][0] = i >= X ? (W[i][0] * C[i - X] + epsilon / m * C[i]) / diagonal : 0;
-		M[i][1] = i % X < X - 1 ? (W[i][1] * C[i + 1] + epsilon / m * C[i]) / diagonal : 0;
-		M[i][2] = i < XY - X ? (W[i][2] * C[i + X] + epsilon / m * C[i]) / diagonal : 0;
-		M[i][3] = i % X ? (W[i][3] * C[i - 1] + epsilon / m * C[i]) / diagonal : 0;
+		double diagonal = (epsilon + W[0][i] + W[1][i] + W[2][i] + W[3][i]) * C[i];
+		M[0][i] = i >= X ? (W[0][i] * C[i - X] + epsilon / m * C[i]) / diagonal : 0;
+		M[1][i] = i % X < X - 1 ? (W[1][i] * C[i + 1] + epsilon / m * C[i]) / diagonal : 0;
+		M[2][i] = i < XY - X ? (W[2][i] * C[i + X] + epsilon / m * C[i]) / diagonal : 0;
+		M[3][i] = i % X ? (W[3][i] * C[i - 1] + epsilon / m * C[i]) / diagonal : 0;
 	}
 }
 
 /*
- * In the compute_lambda_ functions, note that the matrix coefficients for the
- * left/right neighbours are zero down the left/right edges, so we don't need
- * need to test the i value to exclude them.
+ * Gauss-Seidel iteration with over-relaxation.
+ *
+ * The lambdas are updated a row at a time, with the matrix coefficients for
+ * each neighbour stored in separate arrays. The value computed for the
+ * previous element of the row is kept at hand, as it is the only one the
+ * computation of the next element depends on. The neighbours that don't exist
+ * along the edges of the table have zero coefficients, so they are replaced by
+ * any valid value instead of being special-cased.
  */
-static double computeLambdaBottom(int i, const SparseArray<double> &M,
-				  Array2D<double> &lambda)
-{
-	return M[i][1] * lambda[i + 1] + M[i][2] * lambda[i + lambda.dimensions().width] +
-	       M[i][3] * lambda[i - 1];
-}
-static double computeLambdaBottomStart(int i, const SparseArray<double> &M,
-				       Array2D<double> &lambda)
-{
-	return M[i][1] * lambda[i + 1] + M[i][2] * lambda[i + lambda.dimensions().width];
-}
-static double computeLambdaInterior(int i, const SparseArray<double> &M,
-				    Array2D<double> &lambda)
-{
-	return M[i][0] * lambda[i - lambda.dimensions().width] + M[i][1] * lambda[i + 1] +
-	       M[i][2] * lambda[i + lambda.dimensions().width] + M[i][3] * lambda[i - 1];
-}
-static double computeLambdaTop(int i, const SparseArray<double> &M,
-			       Array2D<double> &lambda)
-{
-	return M[i][0] * lambda[i - lambda.dimensions().width] + M[i][1] * lambda[i + 1] +
-	       M[i][3] * lambda[i - 1];
-}
-static double computeLambdaTopEnd(int i, const SparseArray<double> &M,
-				  Array2D<double> &lambda)
-{
-	return M[i][0] * lambda[i - lambda.dimensions().width] + M[i][3] * lambda[i - 1];
-}
-
-/* Gauss-Seidel iteration with over-relaxation. */
 static double gaussSeidel2Sor(const SparseArray<double> &M, double omega,
-			      Array2D<double> &lambda, double lambdaBound)
+			      Array2D<double> &lambda, Array2D<double> &oldLambda,
+			      double lambdaBound)
 {
-	int XY = lambda.size();
-	int X = lambda.dimensions().width;
+	const int X = lambda.dimensions().width;
+	const int Y = lambda.dimensions().height;
 	const double min = 1 - lambdaBound, max = 1 + lambdaBound;
-	Array2D<double> oldLambda = lambda;
-	int i;
-	lambda[0] = computeLambdaBottomStart(0, M, lambda);
-	lambda[0] = std::clamp(lambda[0], min, max);
-	for (i = 1; i < X; i++) {
-		lambda[i] = computeLambdaBottom(i, M, lambda);
-		lambda[i] = std::clamp(lambda[i], min, max);
-	}
-	for (; i < XY - X; i++) {
-		lambda[i] = computeLambdaInterior(i, M, lambda);
-		lambda[i] = std::clamp(lambda[i], min, max);
-	}
-	for (; i < XY - 1; i++) {
-		lambda[i] = computeLambdaTop(i, M, lambda);
-		lambda[i] = std::clamp(lambda[i], min, max);
+	const double *above = M[0].ptr(), *right = M[1].ptr();
+	const double *below = M[2].ptr(), *left = M[3].ptr();
+	double *l = lambda.ptr();
+
+	std::copy(lambda.begin(), lambda.end(), oldLambda.begin());
+
+	for (int y = 0; y < Y; y++) {
+		const int rowStart = y * X, rowEnd = rowStart + X;
+		const int up = y > 0 ? -X : 0;
+		const int down = y < Y - 1 ? X : 0;
+		double prev = 0;
+
+		for (int i = rowStart; i < rowEnd; i++) {
+			double next = i + 1 < rowEnd ? l[i + 1] : 0;
+			double value = above[i] * l[i + up] + right[i] * next +
+				       below[i] * l[i + down] + left[i] * prev;
+			prev = std::clamp(value, min, max);
+			l[i] = prev;
+		}
 	}
-	lambda[i] = computeLambdaTopEnd(i, M, lambda);
-	lambda[i] = std::clamp(lambda[i], min, max);
+
 	/*
 	 * Also solve the system from bottom to top, to help spread the updates
 	 * better.
 	 */
-	lambda[i] = computeLambdaTopEnd(i, M, lambda);
-	lambda[i] = std::clamp(lambda[i], min, max);
-	for (i = XY - 2; i >= XY - X; i--) {
-		lambda[i] = computeLambdaTop(i, M, lambda);
-		lambda[i] = std::clamp(lambda[i], min, max);
-	}
-	for (; i >= X; i--) {
-		lambda[i] = computeLambdaInterior(i, M, lambda);
-		lambda[i] = std::clamp(lambda[i], min, max);
-	}
-	for (; i >= 1; i--) {
-		lambda[i] = computeLambdaBottom(i, M, lambda);
-		lambda[i] = std::clamp(lambda[i], min, max);
+	for (int y = Y - 1; y >= 0; y--) {
+		const int rowStart = y * X, rowEnd = rowStart + X;
+		const int up = y > 0 ? -X : 0;
+		const int down = y < Y - 1 ? X : 0;
+		double prev = 0;
+
+		for (int i = rowEnd - 1; i >= rowStart; i--) {
+			double next = i > rowStart ? l[i - 1] : 0;
+			double value = above[i] * l[i + up] + right[i] * prev +
+				       below[i] * l[i + down] + left[i] * next;
+			prev = std::clamp(value, min, max);
+			l[i] = prev;
+		}
 	}
-	lambda[0] = computeLambdaBottomStart(0, M, lambda);
-	lambda[0] = std::clamp(lambda[0], min, max);
+
 	double maxDiff = 0;
-	for (i = 0; i < XY; i++) {
-		lambda[i] = oldLambda[i] + (lambda[i] - oldLambda[i]) * omega;
-		if (fabs(lambda[i] - oldLambda[i]) > fabs(maxDiff))
-			maxDiff = lambda[i] - oldLambda[i];
+	for (unsigned int i = 0; i < lambda.size(); i++) {
+		l[i] = oldLambda[i] + (l[i] - oldLambda[i]) * omega;
+		maxDiff = std::max(maxDiff, fabs(l[i] - oldLambda[i]));
 	}
 	return maxDiff;
 }
@@ -751,16 +727,16 @@ static void reaverage(Array2D<double> &data)
 		      [ratio](double val) { return val * ratio; });
 }
 
-static void runMatrixIterations(const Array2D<double> &C,
-				Array2D<double> &lambda,
-				const SparseArray<double> &W,
-				SparseArray<double> &M, double omega,
-				unsigned int nIter, double threshold, double lambdaBound)
+void runMatrixIterations(const Array2D<double> &C, Array2D<double> &lambda,
+			 const SparseArray<double> &W, SparseArray<double> &M,
+			 double omega, unsigned int nIter, double threshold,
+			 double lambdaBound, Array2D<double> &oldLambda)
 {
 	constructM(C, W, M);
 	double lastMaxDiff = std::numeric_limits<double>::max();
 	for (unsigned int i = 0; i < nIter; i++) {
-		double maxDiff = fabs(gaussSeidel2Sor(M, omega, lambda, lambdaBound));
+		double maxDiff = gaussSeidel2Sor(M, omega, lambda, oldLambda,
+						 lambdaBound);
 		if (maxDiff < threshold) {
 			LOG(RPiAlsc, Debug)
 				<< "Stop after " << i + 1 << " iterations";
@@ -780,6 +756,8 @@ static void runMatrixIterations(const Array2D<double> &C,
 	reaverage(lambda);
 }
 
+} /* namespace RPiController */
+
 static void addLuminanceRb(Array2D<double> &result, const Array2D<double> &lambda,
 			   const Array2D<double> &luminanceLut,
 			   double luminanceStrength)
@@ -812,8 +790,9 @@ void addLuminanceToTables(std::array<Array2D<double>, 3> &results,
 void Alsc::doAlsc()
 {
 	Array2D<double> &cr = tmpC_[0], &cb = tmpC_[1], &calTableR = tmpC_[2],
-			&calTableB = tmpC_[3], &calTableTmp = tmpC_[4];
+			&calTableB = tmpC_[3], &oldLambda = tmpC_[4];
 	SparseArray<double> &wr = tmpM_[0], &wb = tmpM_[1], &M = tmpM_[2];
+	auto begin = std::chrono::steady_clock::now();
 
 	/*
 	 * Calculate our R/B ("Cr"/"Cb") colour statistics, and assess which are
@@ -821,13 +800,11 @@ void Alsc::doAlsc()
 	 */
 	calculateCrCb(statistics_, cr, cb, config_.minCount, config_.minG);
 	/*
-	 * Fetch the new calibrations (if any) for this CT. Resample them in
-	 * case the camera mode is not full-frame.
+	 * Fetch the new calibrations (if any) for this CT. They have been
+	 * resampled for the camera mode already.
 	 */
-	getCalTable(ct_, config_.calibrationsCr, calTableTmp);
-	resampleCalTable(calTableTmp, cameraMode_, calTableR);
-	getCalTable(ct_, config_.calibrationsCb, calTableTmp);
-	resampleCalTable(calTableTmp, cameraMode_, calTableB);
+	getCalTable(ct_, calibrationsCr_, calTableR);
+	getCalTable(ct_, calibrationsCb_, calTableB);
 	/*
 	 * You could print out the cal tables for this image here, if you're
 	 * tuning the algorithm...
@@ -841,9 +818,11 @@ void Alsc::doAlsc()
 	computeW(cb, config_.sigmaCb, wb);
 	/* Run Gauss-Seidel iterations over the resulting matrix, for R and B. */
 	runMatrixIterations(cr, lambdaR_, wr, M, config_.omega, config_.nIter,
-			    config_.threshold, config_.lambdaBound);
+			    config_.threshold, config_.lambdaBound,
+			    oldLambda);
 	runMatrixIterations(cb, lambdaB_, wb, M, config_.omega, config_.nIter,
-			    config_.threshold, config_.lambdaBound);
+			    config_.threshold, config_.lambdaBound,
+			    oldLambda);
 	/*
 	 * Fold the calibrated gains into our final lambda values. (Note that on
 	 * the next run, we re-start with the lambda values that don't have the
@@ -855,6 +834,10 @@ void Alsc::doAlsc()
 	addLuminanceToTables(asyncResults_, asyncLambdaR_, 1.0,
 			     asyncLambdaB_, luminanceTable_,
 			     config_.luminanceStrength);
+
+	std::chrono::duration<double, std::micro> duration =
+		std::chrono::steady_clock::now() - begin;
+	LOG(RPiAlsc, Debug) << "ALSC calculation took " << duration.count() << "us";
 }
 
 /* Register algorithm with the system. */
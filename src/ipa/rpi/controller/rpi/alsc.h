@@ -7,9 +7,6 @@
 #pragma once
 
 #include <array>
-#include <mutex>
-#include <condition_variable>
-#include <thread>
 #include <vector>
 
 #include <libcamera/geometry.h>
@@ -70,11 +67,13 @@ private:
 
 /*
  * We'll use the term SparseArray for the large sparse matrices that are
- * XY tall but have only 4 non-zero elements on each row.
+ * XY tall but have only 4 non-zero elements on each row. The elements are
+ * stored in one array per neighbour (above, right, below and left, in that
+ * order) so that they can be processed a whole row of the table at a time.
  */
 
 template<typename T>
-using SparseArray = std::vector<std::array<T, 4>>;
+using SparseArray = std::array<Array2D<T>, 4>;
 
 struct AlscCalibration {
 	double ct;
@@ -122,26 +121,14 @@ private:
 	bool firstTime_;
 	CameraMode cameraMode_;
 	Array2D<double> luminanceTable_;
-	std::thread asyncThread_;
-	void asyncFunc(); /* asynchronous thread function */
-	std::mutex mutex_;
-	/* condvar for async thread to wait on */
-	std::condition_variable asyncSignal_;
-	/* condvar for synchronous thread to wait on */
-	std::condition_variable syncSignal_;
-	/* for sync thread to check  if async thread finished (requires mutex) */
-	bool asyncFinished_;
-	/* for async thread to check if it's been told to run (requires mutex) */
-	bool asyncStart_;
-	/* for async thread to check if it's been told to quit (requires mutex) */
-	bool asyncAbort_;
-
-	/*
-	 * The following are only for the synchronous thread to use:
-	 * for sync thread to note its has asked async thread to run
-	 */
-	bool asyncStarted_;
-	/* counts up to framePeriod before restarting the async thread */
+	/* calibration tables resampled for the current camera mode */
+	std::vector<AlscCalibration> calibrationsCr_;
+	std::vector<AlscCalibration> calibrationsCb_;
+	/* asynchronous computation of the tables, running doAlsc() */
+	AsyncTask asyncTask_;
+
+	/* The following are only for the synchronous thread to use: */
+	/* counts up to framePeriod before restarting the async task */
 	int framePhase_;
 	/* counts up to startupFrames */
 	int frameCount_;
@@ -149,13 +136,13 @@ private:
 	int frameCount2_;
 	std::array<Array2D<double>, 3> syncResults_;
 	std::array<Array2D<double>, 3> prevSyncResults_;
-	void waitForAysncThread();
+	void waitForAsyncTask();
 	/*
-	 * The following are for the asynchronous thread to use, though the main
-	 * thread can set/reset them if the async thread is known to be idle:
+	 * The following are for the asynchronous task to use, though the main
+	 * thread can set/reset them if the async task is known to be idle:
 	 */
 	void restartAsync(StatisticsPtr &stats, Metadata *imageMetadata);
-	/* copy out the results from the async thread so that it can be restarted */
+	/* copy out the results from the async task so that it can be restarted */
 	void fetchAsyncResults();
 	double ct_;
 	RgbyRegions statistics_;
@@ -171,4 +158,16 @@ private:
 	std::array<SparseArray<double>, 3> tmpM_;
 };
 
+/*
+ * The adaptive part of the algorithm, exposed for testing purposes. computeW()
+ * computes the weights W between neighbouring regions of the colour statistics
+ * C, and runMatrixIterations() then solves for the lambdas that even out the
+ * colours, starting from the current lambdas. M and oldLambda are temporaries.
+ */
+void computeW(const Array2D<double> &C, double sigma, SparseArray<double> &W);
+void runMatrixIterations(const Array2D<double> &C, Array2D<double> &lambda,
+			 const SparseArray<double> &W, SparseArray<double> &M,
+			 double omega, unsigned int nIter, double threshold,
+			 double lambdaBound, Array2D<double> &oldLambda);
+
 } /* namespace RPiController */
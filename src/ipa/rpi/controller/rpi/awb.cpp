@@ -11,6 +11,7 @@
 #include <libcamera/base/log.h>
 
 #include "../lux_status.h"
+#include "../metadata_tags.h"
 
 #include "awb.h"
 
@@ -21,11 +22,6 @@ LOG_DEFINE_CATEGORY(RPiAwb)
 
 #define NAME "rpi.awb"
 
-/*
- * todo - the locking in this algorithm needs some tidying up as has been done
- * elsewhere (ALSC and AGC).
- */
-
 int AwbMode::read(const libcamera::YamlObject &params)
 {
 	auto value = params["lo"].get<double>();
@@ -169,22 +165,16 @@ int AwbConfig::read(const libcamera::YamlObject &params)
 }
 
 Awb::Awb(Controller *controller)
-	: AwbAlgorithm(controller)
+	: AwbAlgorithm(controller),
+	  asyncTask_(getTaskScheduler(), std::bind(&Awb::doAwb, this))
 {
-	asyncAbort_ = asyncStart_ = asyncStarted_ = asyncFinished_ = false;
 	mode_ = nullptr;
 	manualR_ = manualB_ = 0.0;
-	asyncThread_ = std::thread(std::bind(&Awb::asyncFunc, this));
 }
 
 Awb::~Awb()
 {
-	{
-		std::lock_guard<std::mutex> lock(mutex_);
-		asyncAbort_ = true;
-	}
-	asyncSignal_.notify_one();
-	asyncThread_.join();
+	asyncTask_.abort();
 }
 
 char const *Awb::name() const
@@ -278,7 +268,7 @@ void Awb::switchMode([[maybe_unused]] CameraMode const &cameraMode,
 		     Metadata *metadata)
 {
 	/* Let other algorithms know the current white balance values. */
-	metadata->set("awb.status", prevSyncResults_);
+	metadata->set(AwbStatusTag, prevSyncResults_);
 }
 
 bool Awb::isAutoEnabled() const
@@ -288,21 +278,22 @@ bool Awb::isAutoEnabled() const
 
 void Awb::fetchAsyncResults()
 {
-	LOG(RPiAwb, Debug) << "Fetch AWB results";
-	asyncFinished_ = false;
-	asyncStarted_ = false;
+	LOG(RPiAwb, Debug)
+		<< "Fetch AWB results started at frame " << asyncTask_.frame()
+		<< ", " << getFrameCount() - asyncTask_.frame() << " frames ago";
 	/*
 	 * It's possible manual gains could be set even while the async
-	 * thread was running, so only copy the results if still in auto mode.
+	 * task was running, so only copy the results if still in auto mode.
 	 */
 	if (isAutoEnabled())
 		syncResults_ = asyncResults_;
+	asyncTask_.reset();
 }
 
 void Awb::restartAsync(StatisticsPtr &stats, double lux)
 {
 	LOG(RPiAwb, Debug) << "Starting AWB calculation";
-	/* this makes a new reference which belongs to the asynchronous thread */
+	/* this makes a new reference which belongs to the asynchronous task */
 	statistics_ = stats;
 	/* store the mode as it could technically change */
 	auto m = config_.modes.find(modeName_);
@@ -311,15 +302,10 @@ void Awb::restartAsync(StatisticsPtr &stats, double lux)
 			: (mode_ == nullptr ? config_.defaultMode : mode_);
 	lux_ = lux;
 	framePhase_ = 0;
-	asyncStarted_ = true;
 	size_t len = modeName_.copy(asyncResults_.mode,
 				    sizeof(asyncResults_.mode) - 1);
 	asyncResults_.mode[len] = '\0';
-	{
-		std::lock_guard<std::mutex> lock(mutex_);
-		asyncStart_ = true;
-	}
-	asyncSignal_.notify_one();
+	asyncTask_.start(getFrameCount());
 }
 
 void Awb::prepare(Metadata *imageMetadata)
@@ -331,11 +317,8 @@ void Awb::prepare(Metadata *imageMetadata)
 			       : config_.speed;
 	LOG(RPiAwb, Debug)
 		<< "frame_count " << frameCount_ << " speed " << speed;
-	{
-		std::unique_lock<std::mutex> lock(mutex_);
-		if (asyncStarted_ && asyncFinished_)
-			fetchAsyncResults();
-	}
+	if (asyncTask_.finished())
+		fetchAsyncResults();
 	/* Finally apply IIR filter to results and put into metadata. */
 	memcpy(prevSyncResults_.mode, syncResults_.mode,
 	       sizeof(prevSyncResults_.mode));
@@ -347,7 +330,7 @@ void Awb::prepare(Metadata *imageMetadata)
 				 (1.0 - speed) * prevSyncResults_.gainG;
 	prevSyncResults_.gainB = speed * syncResults_.gainB +
 				 (1.0 - speed) * prevSyncResults_.gainB;
-	imageMetadata->set("awb.status", prevSyncResults_);
+	imageMetadata->set(AwbStatusTag, prevSyncResults_);
 	LOG(RPiAwb, Debug)
 		<< "Using AWB gains r " << prevSyncResults_.gainR << " g "
 		<< prevSyncResults_.gainG << " b "
@@ -356,47 +339,26 @@ void Awb::prepare(Metadata *imageMetadata)
 
 void Awb::process(StatisticsPtr &stats, Metadata *imageMetadata)
 {
-	/* Count frames since we last poked the async thread. */
+	/* Count frames since we last poked the async task. */
 	if (framePhase_ < (int)config_.framePeriod)
 		framePhase_++;
 	LOG(RPiAwb, Debug) << "frame_phase " << framePhase_;
-	/* We do not restart the async thread if we're not in auto mode. */
+	/* We do not restart the async task if we're not in auto mode. */
 	if (isAutoEnabled() &&
 	    (framePhase_ >= (int)config_.framePeriod ||
 	     frameCount_ < (int)config_.startupFrames)) {
 		/* Update any settings and any image metadata that we need. */
 		struct LuxStatus luxStatus = {};
 		luxStatus.lux = 400; /* in case no metadata */
-		if (imageMetadata->get("lux.status", luxStatus) != 0)
+		if (imageMetadata->get(LuxStatusTag, luxStatus) != 0)
 			LOG(RPiAwb, Debug) << "No lux metadata found";
 		LOG(RPiAwb, Debug) << "Awb lux value is " << luxStatus.lux;
 
-		if (asyncStarted_ == false)
+		if (!asyncTask_.busy())
 			restartAsync(stats, luxStatus.lux);
 	}
 }
 
-void Awb::asyncFunc()
-{
-	while (true) {
-		{
-			std::unique_lock<std::mutex> lock(mutex_);
-			asyncSignal_.wait(lock, [&] {
-				return asyncStart_ || asyncAbort_;
-			});
-			asyncStart_ = false;
-			if (asyncAbort_)
-				break;
-		}
-		doAwb();
-		{
-			std::lock_guard<std::mutex> lock(mutex_);
-			asyncFinished_ = true;
-		}
-		syncSignal_.notify_one();
-	}
-}
-
 static void generateStats(std::vector<Awb::RGB> &zones,
 			  RgbyRegions &stats, double minPixels,
 			  double minG)
@@ -438,17 +400,35 @@ double Awb::computeDelta2Sum(double gainR, double gainB)
 	/*
 	 * Compute the sum of the squared colour error (non-greyness) as it
 	 * appears in the log likelihood equation.
+	 *
+	 * This is evaluated for every candidate of the searches, so it is
+	 * worth some care. The zones are processed in pairs, accumulated in
+	 * separate sums, which lets the compiler use SIMD instructions.
 	 */
-	double delta2Sum = 0;
-	for (auto &z : zones_) {
-		double deltaR = gainR * z.R - 1 - config_.whitepointR;
-		double deltaB = gainB * z.B - 1 - config_.whitepointB;
-		double delta2 = deltaR * deltaR + deltaB * deltaB;
-		/* LOG(RPiAwb, Debug) << "deltaR " << deltaR << " deltaB " << deltaB << " delta2 " << delta2; */
-		delta2 = std::min(delta2, config_.deltaLimit);
-		delta2Sum += delta2;
+	const double *zoneR = zonesR_.data(), *zoneB = zonesB_.data();
+	const size_t numZones = zonesR_.size();
+	const double offsetR = 1 + config_.whitepointR;
+	const double offsetB = 1 + config_.whitepointB;
+	const double deltaLimit = config_.deltaLimit;
+	double delta2Sum0 = 0, delta2Sum1 = 0;
+	size_t i;
+
+	for (i = 0; i + 1 < numZones; i += 2) {
+		double deltaR0 = gainR * zoneR[i] - offsetR;
+		double deltaB0 = gainB * zoneB[i] - offsetB;
+		double deltaR1 = gainR * zoneR[i + 1] - offsetR;
+		double deltaB1 = gainB * zoneB[i + 1] - offsetB;
+		delta2Sum0 += std::min(deltaR0 * deltaR0 + deltaB0 * deltaB0, deltaLimit);
+		delta2Sum1 += std::min(deltaR1 * deltaR1 + deltaB1 * deltaB1, deltaLimit);
 	}
-	return delta2Sum;
+
+	if (i < numZones) {
+		double deltaR = gainR * zoneR[i] - offsetR;
+		double deltaB = gainB * zoneB[i] - offsetB;
+		delta2Sum0 += std::min(deltaR * deltaR + deltaB * deltaB, deltaLimit);
+	}
+
+	return delta2Sum0 + delta2Sum1;
 }
 
 Pwl Awb::interpolatePrior()
@@ -501,14 +481,14 @@ double Awb::coarseSearch(Pwl const &prior)
 	points_.clear(); /* assume doesn't deallocate memory */
 	size_t bestPoint = 0;
 	double t = mode_->ctLo;
-	int spanR = 0, spanB = 0;
+	int spanR = 0, spanB = 0, spanPrior = -1;
 	/* Step down the CT curve evaluating log likelihood. */
 	while (true) {
 		double r = config_.ctR.eval(t, &spanR);
 		double b = config_.ctB.eval(t, &spanB);
 		double gainR = 1 / r, gainB = 1 / b;
 		double delta2Sum = computeDelta2Sum(gainR, gainB);
-		double priorLogLikelihood = prior.eval(prior.domain().clip(t));
+		double priorLogLikelihood = prior.eval(prior.domain().clip(t), &spanPrior);
 		double finalLogLikelihood = delta2Sum - priorLogLikelihood;
 		LOG(RPiAwb, Debug)
 			<< "t: " << t << " gain R " << gainR << " gain B "
@@ -544,7 +524,7 @@ double Awb::coarseSearch(Pwl const &prior)
 
 void Awb::fineSearch(double &t, double &r, double &b, Pwl const &prior)
 {
-	int spanR = -1, spanB = -1;
+	int spanR = -1, spanB = -1, spanPrior = -1;
 	config_.ctR.eval(t, &spanR);
 	config_.ctB.eval(t, &spanB);
 	double step = t / 10 * config_.coarseStep * 0.1;
@@ -575,7 +555,7 @@ void Awb::fineSearch(double &t, double &r, double &b, Pwl const &prior)
 	for (int i = -nsteps; i <= nsteps; i++) {
 		double tTest = t + i * step;
 		double priorLogLikelihood =
-			prior.eval(prior.domain().clip(tTest));
+			prior.eval(prior.domain().clip(tTest), &spanPrior);
 		double rCurve = config_.ctR.eval(tTest, &spanR);
 		double bCurve = config_.ctB.eval(tTest, &spanB);
 		/* x will be distance off the curve, y the log likelihood there */
@@ -630,8 +610,12 @@ void Awb::awbBayes()
 	 * May as well divide out G to save computeDelta2Sum from doing it over
 	 * and over.
 	 */
-	for (auto &z : zones_)
-		z.R = z.R / (z.G + 1), z.B = z.B / (z.G + 1);
+	zonesR_.clear();
+	zonesB_.clear();
+	for (auto &z : zones_) {
+		zonesR_.push_back(z.R / (z.G + 1));
+		zonesB_.push_back(z.B / (z.G + 1));
+	}
 	/*
 	 * Get the current prior, and scale according to how many zones are
 	 * valid... not entirely sure about this.
@@ -6,10 +6,6 @@
  */
 #pragma once
 
-#include <mutex>
-#include <condition_variable>
-#include <thread>
-
 #include "../awb_algorithm.h"
 #include "../pwl.h"
 #include "../awb_status.h"
@@ -119,37 +115,22 @@ private:
 	bool isAutoEnabled() const;
 	/* configuration is read-only, and available to both threads */
 	AwbConfig config_;
-	std::thread asyncThread_;
-	void asyncFunc(); /* asynchronous thread function */
-	std::mutex mutex_;
-	/* condvar for async thread to wait on */
-	std::condition_variable asyncSignal_;
-	/* condvar for synchronous thread to wait on */
-	std::condition_variable syncSignal_;
-	/* for sync thread to check  if async thread finished (requires mutex) */
-	bool asyncFinished_;
-	/* for async thread to check if it's been told to run (requires mutex) */
-	bool asyncStart_;
-	/* for async thread to check if it's been told to quit (requires mutex) */
-	bool asyncAbort_;
+	/* asynchronous computation of the gains, running doAwb() */
+	AsyncTask asyncTask_;
 
-	/*
-	 * The following are only for the synchronous thread to use:
-	 * for sync thread to note its has asked async thread to run
-	 */
-	bool asyncStarted_;
-	/* counts up to framePeriod before restarting the async thread */
+	/* The following are only for the synchronous thread to use: */
+	/* counts up to framePeriod before restarting the async task */
 	int framePhase_;
 	int frameCount_; /* counts up to startup_frames */
 	AwbStatus syncResults_;
 	AwbStatus prevSyncResults_;
 	std::string modeName_;
 	/*
-	 * The following are for the asynchronous thread to use, though the main
-	 * thread can set/reset them if the async thread is known to be idle:
+	 * The following are for the asynchronous task to use, though the main
+	 * thread can set/reset them if the async task is known to be idle:
 	 */
 	void restartAsync(StatisticsPtr &stats, double lux);
-	/* copy out the results from the async thread so that it can be restarted */
+	/* copy out the results from the async task so that it can be restarted */
 	void fetchAsyncResults();
 	StatisticsPtr statistics_;
 	AwbMode *mode_;
@@ -164,6 +145,12 @@ private:
 	double coarseSearch(Pwl const &prior);
 	void fineSearch(double &t, double &r, double &b, Pwl const &prior);
 	std::vector<RGB> zones_;
+	/*
+	 * The R/G and B/G ratios of the zones used by the Bayesian search,
+	 * stored in separate arrays for faster processing.
+	 */
+	std::vector<double> zonesR_;
+	std::vector<double> zonesB_;
 	std::vector<Pwl::Point> points_;
 	/* manual r setting */
 	double manualR_;
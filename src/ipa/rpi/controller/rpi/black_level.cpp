@@ -11,6 +11,7 @@
 #include <libcamera/base/log.h>
 
 #include "../black_level_status.h"
+#include "../metadata_tags.h"
 
 #include "black_level.h"
 
@@ -55,7 +56,7 @@ void BlackLevel::prepare(Metadata *imageMetadata)
 	status.blackLevelR = blackLevelR_;
 	status.blackLevelG = blackLevelG_;
 	status.blackLevelB = blackLevelB_;
-	imageMetadata->set("black_level.status", status);
+	imageMetadata->set(BlackLevelStatusTag, status);
 }
 
 /* Register algorithm with the system. */
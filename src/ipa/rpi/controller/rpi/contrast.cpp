@@ -10,6 +10,7 @@
 
 #include "../contrast_status.h"
 #include "../histogram.h"
+#include "../metadata_tags.h"
 
 #include "contrast.h"
 
@@ -78,7 +79,7 @@ void Contrast::initialise()
 
 void Contrast::prepare(Metadata *imageMetadata)
 {
-	imageMetadata->set("contrast.status", status_);
+	imageMetadata->set(ContrastStatusTag, status_);
 }
 
 Pwl computeStretchCurve(Histogram const &histogram,
@@ -7,6 +7,8 @@
 
 #include <libcamera/base/log.h>
 
+#include "../metadata_tags.h"
+
 #include "dpc.h"
 
 using namespace RPiController;
@@ -48,7 +50,7 @@ void Dpc::prepare(Metadata *imageMetadata)
 	/* Should we vary this with lux level or analogue gain? TBD. */
 	dpcStatus.strength = config_.strength;
 	LOG(RPiDpc, Debug) << "strength " << dpcStatus.strength;
-	imageMetadata->set("dpc.status", dpcStatus);
+	imageMetadata->set(DpcStatusTag, dpcStatus);
 }
 
 /* Register algorithm with the system. */
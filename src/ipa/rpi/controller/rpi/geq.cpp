@@ -9,6 +9,7 @@
 
 #include "../device_status.h"
 #include "../lux_status.h"
+#include "../metadata_tags.h"
 #include "../pwl.h"
 
 #include "geq.h"
@@ -57,11 +58,11 @@ void Geq::prepare(Metadata *imageMetadata)
 {
 	LuxStatus luxStatus = {};
 	luxStatus.lux = 400;
-	if (imageMetadata->get("lux.status", luxStatus))
+	if (imageMetadata->get(LuxStatusTag, luxStatus))
 		LOG(RPiGeq, Warning) << "no lux data found";
 	DeviceStatus deviceStatus;
 	deviceStatus.analogueGain = 1.0; /* in case not found */
-	if (imageMetadata->get("device.status", deviceStatus))
+	if (imageMetadata->get(DeviceStatusTag, deviceStatus))
 		LOG(RPiGeq, Warning)
 			<< "no device metadata - use analogue gain of 1x";
 	GeqStatus geqStatus = {};
@@ -78,7 +79,7 @@ void Geq::prepare(Metadata *imageMetadata)
 		<< geqStatus.slope << " (analogue gain "
 		<< deviceStatus.analogueGain << " lux "
 		<< luxStatus.lux << ")";
-	imageMetadata->set("geq.status", geqStatus);
+	imageMetadata->set(GeqStatusTag, geqStatus);
 }
 
 /* Register algorithm with the system. */
@@ -9,6 +9,7 @@
 #include <libcamera/base/log.h>
 
 #include "../device_status.h"
+#include "../metadata_tags.h"
 
 #include "lux.h"
 
@@ -72,13 +73,13 @@ void Lux::setCurrentAperture(double aperture)
 void Lux::prepare(Metadata *imageMetadata)
 {
 	std::unique_lock<std::mutex> lock(mutex_);
-	imageMetadata->set("lux.status", status_);
+	imageMetadata->set(LuxStatusTag, status_);
 }
 
 void Lux::process(StatisticsPtr &stats, Metadata *imageMetadata)
 {
 	DeviceStatus deviceStatus;
-	if (imageMetadata->get("device.status", deviceStatus) == 0) {
+	if (imageMetadata->get(DeviceStatusTag, deviceStatus) == 0) {
 		double currentGain = deviceStatus.analogueGain;
 		double currentAperture = deviceStatus.aperture.value_or(currentAperture_);
 		double currentY = stats->yHist.interQuantileMean(0, 1);
@@ -102,7 +103,7 @@ void Lux::process(StatisticsPtr &stats, Metadata *imageMetadata)
 		 * Overwrite the metadata here as well, so that downstream
 		 * algorithms get the latest value.
 		 */
-		imageMetadata->set("lux.status", status);
+		imageMetadata->set(LuxStatusTag, status);
 	} else
 		LOG(RPiLux, Warning) << ": no device metadata";
 }
@@ -8,6 +8,7 @@
 #include <libcamera/base/log.h>
 
 #include "../denoise_status.h"
+#include "../metadata_tags.h"
 #include "../noise_status.h"
 
 #include "sdn.h"
@@ -49,7 +50,7 @@ void Sdn::prepare(Metadata *imageMetadata)
 {
 	struct NoiseStatus noiseStatus = {};
 	noiseStatus.noiseSlope = 3.0; /* in case no metadata */
-	if (imageMetadata->get("noise.status", noiseStatus) != 0)
+	if (imageMetadata->get(NoiseStatusTag, noiseStatus) != 0)
 		LOG(RPiSdn, Warning) << "no noise profile found";
 	LOG(RPiSdn, Debug)
 		<< "Noise profile: constant " << noiseStatus.noiseConstant
@@ -59,7 +60,7 @@ void Sdn::prepare(Metadata *imageMetadata)
 	status.noiseSlope = noiseStatus.noiseSlope * deviation_;
 	status.strength = strength_;
 	status.mode = static_cast<std::underlying_type_t<DenoiseMode>>(mode_);
-	imageMetadata->set("denoise.status", status);
+	imageMetadata->set(DenoiseStatusTag, status);
 	LOG(RPiSdn, Debug)
 		<< "programmed constant " << status.noiseConstant
 		<< " slope " << status.noiseSlope
@@ -9,6 +9,7 @@
 
 #include <libcamera/base/log.h>
 
+#include "../metadata_tags.h"
 #include "../sharpen_status.h"
 
 #include "sharpen.h"
@@ -81,7 +82,7 @@ void Sharpen::prepare(Metadata *imageMetadata)
 	status.limit = limit_ / modeFactor_ * userStrengthSqrt;
 	/* Finally, report any application-supplied parameters that were used. */
 	status.userStrength = userStrength_;
-	imageMetadata->set("sharpen.status", status);
+	imageMetadata->set(SharpenStatusTag, status);
 }
 
 /* Register algorithm with the system. */
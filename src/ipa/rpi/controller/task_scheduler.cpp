@@ -0,0 +1,173 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+/*
+ * Copyright (C) 2026, Ideas on Board Oy
+ *
+ * task_scheduler.cpp - Worker pool for asynchronous algorithm computations
+ */
+
+#include <algorithm>
+#include <assert.h>
+
+#include <libcamera/base/log.h>
+
+#include "task_scheduler.h"
+
+using namespace RPiController;
+using namespace libcamera;
+
+LOG_DEFINE_CATEGORY(RPiTaskScheduler)
+
+AsyncTask::AsyncTask(TaskScheduler &scheduler, std::function<void()> func)
+	: scheduler_(scheduler), func_(std::move(func)), state_(State::Idle),
+	  busy_(false), frame_(0)
+{
+}
+
+AsyncTask::~AsyncTask()
+{
+	/* Don't leave the task behind in the queue, or running. */
+	abort();
+}
+
+void AsyncTask::start(uint64_t frame)
+{
+	assert(!busy_);
+
+	frame_ = frame;
+	busy_ = true;
+	scheduler_.queue(this);
+}
+
+bool AsyncTask::finished()
+{
+	return busy_ && scheduler_.finished(this);
+}
+
+void AsyncTask::wait()
+{
+	if (busy_)
+		scheduler_.wait(this);
+}
+
+void AsyncTask::reset()
+{
+	if (!busy_)
+		return;
+
+	scheduler_.reset(this);
+	busy_ = false;
+}
+
+void AsyncTask::abort()
+{
+	if (!busy_)
+		return;
+
+	scheduler_.cancel(this);
+	reset();
+}
+
+TaskScheduler::TaskScheduler(unsigned int maxThreads)
+	: maxThreads_(std::max(maxThreads, 1u)), idleThreads_(0), abort_(false)
+{
+}
+
+TaskScheduler::~TaskScheduler()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		/* All the tasks must have been destroyed by now. */
+		assert(queue_.empty());
+		abort_ = true;
+	}
+	workSignal_.notify_all();
+
+	for (std::thread &thread : threads_)
+		thread.join();
+}
+
+void TaskScheduler::queue(AsyncTask *task)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		task->state_ = AsyncTask::State::Queued;
+		queue_.push_back(task);
+
+		/*
+		 * Threads are only created when needed, so cameras whose
+		 * algorithms don't use asynchronous tasks don't pay for them.
+		 */
+		if (idleThreads_ < queue_.size() && threads_.size() < maxThreads_) {
+			threads_.emplace_back(&TaskScheduler::workerFunc, this);
+			LOG(RPiTaskScheduler, Debug)
+				<< "Started worker thread " << threads_.size()
+				<< "/" << maxThreads_;
+		}
+	}
+	workSignal_.notify_one();
+}
+
+void TaskScheduler::cancel(AsyncTask *task)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	if (task->state_ != AsyncTask::State::Queued)
+		return;
+
+	queue_.erase(std::find(queue_.begin(), queue_.end(), task));
+	task->state_ = AsyncTask::State::Idle;
+}
+
+void TaskScheduler::wait(AsyncTask *task)
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	doneSignal_.wait(lock, [&] {
+		return task->state_ == AsyncTask::State::Idle ||
+		       task->state_ == AsyncTask::State::Finished;
+	});
+}
+
+bool TaskScheduler::finished(AsyncTask *task)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return task->state_ == AsyncTask::State::Finished;
+}
+
+void TaskScheduler::reset(AsyncTask *task)
+{
+	/* Resetting a task that hasn't completed would lose track of it. */
+	wait(task);
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	task->state_ = AsyncTask::State::Idle;
+}
+
+void TaskScheduler::workerFunc()
+{
+	while (true) {
+		AsyncTask *task;
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			idleThreads_++;
+			workSignal_.wait(lock, [&] {
+				return !queue_.empty() || abort_;
+			});
+			idleThreads_--;
+			if (abort_)
+				break;
+
+			task = queue_.front();
+			queue_.pop_front();
+			task->state_ = AsyncTask::State::Running;
+		}
+
+		task->func_();
+
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			task->state_ = AsyncTask::State::Finished;
+		}
+		doneSignal_.notify_all();
+	}
+}
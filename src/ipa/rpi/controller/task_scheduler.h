@@ -0,0 +1,111 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+/*
+ * Copyright (C) 2026, Ideas on Board Oy
+ *
+ * task_scheduler.h - Worker pool for asynchronous algorithm computations
+ */
+#pragma once
+
+/*
+ * Some control algorithms (such as AWB and ALSC) perform computations that are
+ * too expensive to run synchronously for every frame. They submit them instead
+ * as asynchronous tasks to the TaskScheduler owned by the Controller, which
+ * runs them on a small pool of worker threads shared by all the algorithms of
+ * a camera. This lets computations from several algorithms overlap on
+ * different cores, while bounding the number of threads per camera.
+ */
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+namespace RPiController {
+
+class TaskScheduler;
+
+/*
+ * An AsyncTask wraps a computation that an algorithm runs repeatedly in the
+ * background. Each run is tagged with the frame it was started on. A task can
+ * only be started when idle, and becomes idle again once the algorithm has
+ * collected the results and called reset(). All the functions must be called
+ * from the synchronous (IPA) thread.
+ *
+ * As the task function usually accesses members of the algorithm, algorithms
+ * must abort() their tasks in their destructor.
+ */
+class AsyncTask
+{
+public:
+	AsyncTask(TaskScheduler &scheduler, std::function<void()> func);
+	~AsyncTask();
+
+	void start(uint64_t frame);
+	/* Has the task been started and not reset yet? */
+	bool busy() const { return busy_; }
+	/* Has the task run to completion? (requires busy()) */
+	bool finished();
+	/* Wait for the task to complete, if it has been started */
+	void wait();
+	/* Make the task idle again, after its results have been collected */
+	void reset();
+	/* Cancel the task if not running yet, or wait for it, and reset it */
+	void abort();
+
+	uint64_t frame() const { return frame_; }
+
+private:
+	friend class TaskScheduler;
+
+	enum class State {
+		Idle,
+		Queued,
+		Running,
+		Finished,
+	};
+
+	TaskScheduler &scheduler_;
+	std::function<void()> func_;
+	/* Protected by the scheduler mutex */
+	State state_;
+	/* Only accessed from the synchronous thread */
+	bool busy_;
+	uint64_t frame_;
+};
+
+class TaskScheduler
+{
+public:
+	TaskScheduler(unsigned int maxThreads);
+	~TaskScheduler();
+
+	unsigned int maxThreads() const { return maxThreads_; }
+
+private:
+	friend class AsyncTask;
+
+	void queue(AsyncTask *task);
+	void cancel(AsyncTask *task);
+	void wait(AsyncTask *task);
+	bool finished(AsyncTask *task);
+	void reset(AsyncTask *task);
+
+	void workerFunc();
+
+	unsigned int maxThreads_;
+
+	std::mutex mutex_;
+	/* condvar for the worker threads to wait on */
+	std::condition_variable workSignal_;
+	/* condvar for the synchronous thread to wait on */
+	std::condition_variable doneSignal_;
+	std::deque<AsyncTask *> queue_;
+	std::vector<std::thread> threads_;
+	unsigned int idleThreads_;
+	bool abort_;
+};
+
+} /* namespace RPiController */
@@ -5,6 +5,7 @@
  * rpi.cpp - Raspberry Pi VC4/BCM2835 ISP IPA.
  */
 
+#include <array>
 #include <string.h>
 #include <sys/mman.h>
 
@@ -26,6 +27,7 @@
 #include "controller/dpc_status.h"
 #include "controller/geq_status.h"
 #include "controller/lux_status.h"
+#include "controller/metadata_tags.h"
 #include "controller/noise_status.h"
 #include "controller/sharpen_status.h"
 
@@ -134,47 +136,47 @@ void IpaVc4::platformPrepareIsp([[maybe_unused]] const PrepareParams &params,
 	/* Lock the metadata buffer to avoid constant locks/unlocks. */
 	std::unique_lock<RPiController::Metadata> lock(rpiMetadata);
 
-	AwbStatus *awbStatus = rpiMetadata.getLocked<AwbStatus>("awb.status");
+	AwbStatus *awbStatus = rpiMetadata.getLocked(RPiController::AwbStatusTag);
 	if (awbStatus)
 		applyAWB(awbStatus, ctrls);
 
-	CcmStatus *ccmStatus = rpiMetadata.getLocked<CcmStatus>("ccm.status");
+	CcmStatus *ccmStatus = rpiMetadata.getLocked(RPiController::CcmStatusTag);
 	if (ccmStatus)
 		applyCCM(ccmStatus, ctrls);
 
-	AgcStatus *dgStatus = rpiMetadata.getLocked<AgcStatus>("agc.status");
+	AgcStatus *dgStatus = rpiMetadata.getLocked(RPiController::AgcStatusTag);
 	if (dgStatus)
 		applyDG(dgStatus, ctrls);
 
-	AlscStatus *lsStatus = rpiMetadata.getLocked<AlscStatus>("alsc.status");
+	AlscStatus *lsStatus = rpiMetadata.getLocked(RPiController::AlscStatusTag);
 	if (lsStatus)
 		applyLS(lsStatus, ctrls);
 
-	ContrastStatus *contrastStatus = rpiMetadata.getLocked<ContrastStatus>("contrast.status");
+	ContrastStatus *contrastStatus = rpiMetadata.getLocked(RPiController::ContrastStatusTag);
 	if (contrastStatus)
 		applyGamma(contrastStatus, ctrls);
 
-	BlackLevelStatus *blackLevelStatus = rpiMetadata.getLocked<BlackLevelStatus>("black_level.status");
+	BlackLevelStatus *blackLevelStatus = rpiMetadata.getLocked(RPiController::BlackLevelStatusTag);
 	if (blackLevelStatus)
 		applyBlackLevel(blackLevelStatus, ctrls);
 
-	GeqStatus *geqStatus = rpiMetadata.getLocked<GeqStatus>("geq.status");
+	GeqStatus *geqStatus = rpiMetadata.getLocked(RPiController::GeqStatusTag);
 	if (geqStatus)
 		applyGEQ(geqStatus, ctrls);
 
-	DenoiseStatus *denoiseStatus = rpiMetadata.getLocked<DenoiseStatus>("denoise.status");
+	DenoiseStatus *denoiseStatus = rpiMetadata.getLocked(RPiController::DenoiseStatusTag);
 	if (denoiseStatus)
 		applyDenoise(denoiseStatus, ctrls);
 
-	SharpenStatus *sharpenStatus = rpiMetadata.getLocked<SharpenStatus>("sharpen.status");
+	SharpenStatus *sharpenStatus = rpiMetadata.getLocked(RPiController::SharpenStatusTag);
 	if (sharpenStatus)
 		applySharpen(sharpenStatus, ctrls);
 
-	DpcStatus *dpcStatus = rpiMetadata.getLocked<DpcStatus>("dpc.status");
+	DpcStatus *dpcStatus = rpiMetadata.getLocked(RPiController::DpcStatusTag);
 	if (dpcStatus)
 		applyDPC(dpcStatus, ctrls);
 
-	const AfStatus *afStatus = rpiMetadata.getLocked<AfStatus>("af.status");
+	const AfStatus *afStatus = rpiMetadata.getLocked(RPiController::AfStatusTag);
 	if (afStatus) {
 		ControlList lensctrls(lensCtrls_);
 		applyAF(afStatus, lensctrls);
@@ -325,15 +327,22 @@ void IpaVc4::applyGamma(const struct ContrastStatus *contrastStatus, ControlList
 {
 	const unsigned int numGammaPoints = controller_.getHardwareConfig().numGammaPoints;
 	struct bcm2835_isp_gamma gamma;
+	std::array<double, BCM2835_NUM_GAMMA_PTS> x, y;
 
 	for (unsigned int i = 0; i < numGammaPoints - 1; i++) {
-		int x = i < 16 ? i * 1024
-			       : (i < 24 ? (i - 16) * 2048 + 16384
-					 : (i - 24) * 4096 + 32768);
-		gamma.x[i] = x;
-		gamma.y[i] = std::min<uint16_t>(65535, contrastStatus->gammaCurve.eval(x));
+		x[i] = i < 16 ? i * 1024
+			      : (i < 24 ? (i - 16) * 2048 + 16384
+					: (i - 24) * 4096 + 32768);
+		gamma.x[i] = x[i];
 	}
 
+	/* The points are sorted, evaluate them in one go. */
+	contrastStatus->gammaCurve.eval(Span<const double>(x.data(), numGammaPoints - 1),
+					Span<double>(y.data(), numGammaPoints - 1));
+
+	for (unsigned int i = 0; i < numGammaPoints - 1; i++)
+		gamma.y[i] = std::min<uint16_t>(65535, y[i]);
+
 	gamma.x[numGammaPoints - 1] = 65535;
 	gamma.y[numGammaPoints - 1] = 65535;
 	gamma.enabled = 1;
@@ -0,0 +1,221 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+/*
+ * Copyright (C) 2026, Ideas on Board Oy
+ *
+ * cache_file.cpp - Helpers for persistent cache files
+ */
+
+#include "libcamera/internal/cache_file.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <libcamera/base/unique_fd.h>
+#include <libcamera/base/utils.h>
+
+/**
+ * \file cache_file.h
+ * \brief Helpers for persistent cache files
+ */
+
+namespace libcamera {
+
+/**
+ * \class CacheFile
+ * \brief Read and write persistent cache files
+ *
+ * Several libcamera components cache the results of expensive operations on
+ * disk, to speed up the startup of subsequent processes. The CacheFile class
+ * groups the helpers they share to serialize the cached data, and to read and
+ * write the cache files safely.
+ *
+ * Cache files are private to the user that created them. As their contents
+ * influence the behaviour of libcamera, load() rejects files that are not
+ * owned by the effective user of the process or that are writable by other
+ * users. save() replaces the files atomically, so concurrent processes never
+ * read a partially written file.
+ */
+
+/**
+ * \var CacheFile::kMaxBlobSize
+ * \brief The maximum size of a blob or string stored in a cache file
+ */
+
+/**
+ * \class CacheFile::Writer
+ * \brief Serialize cache data to a memory buffer
+ *
+ * Values are stored in the native byte order and layout of the system, cache
+ * files are not meant to be portable.
+ */
+
+/**
+ * \fn CacheFile::Writer::write()
+ * \brief Append a trivially copyable value to the buffer
+ * \param[in] value The value to append
+ */
+
+/**
+ * \fn CacheFile::Writer::writeBlob()
+ * \brief Append a blob to the buffer, prefixed with its size
+ * \param[in] blob The blob to append
+ */
+
+/**
+ * \fn CacheFile::Writer::writeString()
+ * \brief Append a string to the buffer, prefixed with its size
+ * \param[in] str The string to append
+ */
+
+/**
+ * \fn CacheFile::Writer::data()
+ * \brief Retrieve the serialized data
+ * \return The serialized data
+ */
+
+/**
+ * \class CacheFile::Reader
+ * \brief Deserialize cache data from a memory buffer
+ *
+ * All read functions check the buffer bounds, and return false when the data
+ * is truncated or invalid.
+ */
+
+/**
+ * \fn CacheFile::Reader::Reader()
+ * \brief Construct a reader for \a data
+ * \param[in] data The serialized data
+ */
+
+/**
+ * \fn CacheFile::Reader::read()
+ * \brief Read a trivially copyable value
+ * \param[out] value The value
+ * \return True on success, false if the data is truncated
+ */
+
+/**
+ * \fn CacheFile::Reader::readBlob()
+ * \brief Read a blob written by Writer::writeBlob()
+ * \param[out] blob The blob
+ * \return True on success, false if the data is truncated or invalid
+ */
+
+/**
+ * \fn CacheFile::Reader::readString()
+ * \brief Read a string written by Writer::writeString()
+ * \param[out] str The string
+ * \return True on success, false if the data is truncated or invalid
+ */
+
+/**
+ * \fn CacheFile::Reader::atEnd()
+ * \brief Check if all the data has been read
+ * \return True if all the data has been read, false otherwise
+ */
+
+/**
+ * \brief Load the contents of a cache file
+ * \param[in] path The path to the cache file
+ * \param[out] data The file contents
+ *
+ * \return 0 on success, -EPERM if the file isn't owned by the effective user of
+ * the process or is writable by other users, or another negative error code
+ * otherwise
+ */
+int CacheFile::load(const std::string &path, std::vector<uint8_t> *data)
+{
+	UniqueFD fd(open(path.c_str(), O_RDONLY | O_CLOEXEC));
+	if (!fd.isValid())
+		return -errno;
+
+	struct stat st;
+	if (fstat(fd.get(), &st) < 0)
+		return -errno;
+
+	if (st.st_uid != geteuid() || st.st_mode & (S_IWGRP | S_IWOTH))
+		return -EPERM;
+
+	data->resize(st.st_size);
+	size_t pos = 0;
+	while (pos < data->size()) {
+		ssize_t ret = read(fd.get(), data->data() + pos, data->size() - pos);
+		if (ret < 0 && errno == EINTR)
+			continue;
+		if (ret <= 0)
+			return ret < 0 ? -errno : -EINVAL;
+
+		pos += ret;
+	}
+
+	return 0;
+}
+
+/**
+ * \brief Save data to a cache file
+ * \param[in] path The path to the cache file
+ * \param[in] data The file contents
+ *
+ * The data is written to a new temporary file, created with permissions
+ * restricted to the current user, which then atomically replaces the cache
+ * file. The parent directory of the cache file, and the parent of that
+ * directory, are created if they don't exist, to support the default locations
+ * in the XDG cache directory.
+ *
+ * \return 0 on success or a negative error code otherwise
+ */
+int CacheFile::save(const std::string &path, Span<const uint8_t> data)
+{
+	std::string dir = utils::dirname(path);
+	if (mkdir(dir.c_str(), 0700) < 0 && errno == ENOENT) {
+		mkdir(utils::dirname(dir).c_str(), 0700);
+		mkdir(dir.c_str(), 0700);
+	}
+
+	/*
+	 * Create the temporary file with a unique name, and fail if it exists,
+	 * to avoid following a symlink planted by another user when the cache
+	 * is stored in a shared directory.
+	 */
+	std::string tmpPath = path + ".tmp.XXXXXX";
+	UniqueFD fd(mkostemp(tmpPath.data(), O_CLOEXEC));
+	if (!fd.isValid())
+		return -errno;
+
+	if (fchmod(fd.get(), 0600) < 0) {
+		int ret = -errno;
+		unlink(tmpPath.c_str());
+		return ret;
+	}
+
+	while (!data.empty()) {
+		ssize_t ret = write(fd.get(), data.data(), data.size());
+		if (ret < 0) {
+			if (errno == EINTR)
+				continue;
+
+			ret = -errno;
+			unlink(tmpPath.c_str());
+			return ret;
+		}
+
+		data = data.subspan(ret);
+	}
+
+	fd.reset();
+
+	if (rename(tmpPath.c_str(), path.c_str()) < 0) {
+		int ret = -errno;
+		unlink(tmpPath.c_str());
+		return ret;
+	}
+
+	return 0;
+}
+
+} /* namespace libcamera */
@@ -492,6 +492,17 @@ Camera::Private::~Private()
  * over a single capture session.
  */
 
+/**
+ * \var Camera::Private::frameTiming_
+ * \brief The timing model of the frames captured by the camera
+ *
+ * The frame timing model predicts the frame sequence number that requests will
+ * be captured in when they are queued to the device. Pipeline handlers that
+ * have access to frame start events shall record them in the model with
+ * FrameTimingModel::frameStarted(). Completed requests are recorded by the
+ * PipelineHandler base class.
+ */
+
 static const char *const camera_state_names[] = {
 	"Available",
 	"Acquired",
@@ -814,6 +825,11 @@ int Camera::exportFrameBuffers(Stream *stream,
  * instances of libcamera can still list and examine the cameras but will fail
  * if they attempt to acquire() any of them.
  *
+ * When lazy camera initialization is enabled, acquiring the camera for the
+ * first time also completes its initialization, which may take some time. The
+ * camera controls that depend on that initialization are only available after
+ * the camera has been acquired.
+ *
  * Once exclusive access isn't needed anymore, the device should be released
  * with a call to the release() function.
  *
@@ -842,6 +858,13 @@ int Camera::acquire()
 		return -EBUSY;
 	}
 
+	ret = d->pipe_->invokeMethod(&PipelineHandler::acquireCamera,
+				     ConnectionTypeBlocking, this);
+	if (ret < 0) {
+		d->pipe_->release(this);
+		return ret;
+	}
+
 	d->setState(Private::CameraAcquired);
 
 	return 0;
@@ -1000,6 +1023,10 @@ std::unique_ptr<CameraConfiguration> Camera::generateConfiguration(Span<const St
  * Upon return the StreamConfiguration entries in \a config are associated with
  * Stream instances which can be retrieved with StreamConfiguration::stream().
  *
+ * Configuring the camera with a configuration identical to the one it is
+ * already configured with is cheap, as the pipeline handler skips the device
+ * configuration in that case.
+ *
  * \return 0 on success or a negative error code otherwise
  * \retval -ENODEV The camera has been disconnected from the system
  * \retval -EACCES The camera is not in a state where it can be configured
@@ -1032,7 +1059,7 @@ int Camera::configure(CameraConfiguration *config)
 
 	LOG(Camera, Info) << msg.str();
 
-	ret = d->pipe_->invokeMethod(&PipelineHandler::configure,
+	ret = d->pipe_->invokeMethod(&PipelineHandler::configureCamera,
 				     ConnectionTypeBlocking, this, config);
 	if (ret)
 		return ret;
@@ -1208,6 +1235,12 @@ int Camera::start(const ControlList *controls)
  * This function stops capturing and processing requests immediately. All
  * pending requests are cancelled and complete synchronously in an error state.
  *
+ * Stopping the camera doesn't release the resources allocated by configure().
+ * Pipeline handlers may keep their internal buffers allocated until the camera
+ * is reconfigured with a different configuration or released. Pausing capture
+ * is thus achieved by stopping the camera, and resuming it by starting the
+ * camera again, optionally after configuring it with the same configuration.
+ *
  * \context This function may be called in any camera state as defined in \ref
  * camera_operation, and shall be synchronized by the caller with other
  * functions that affect the camera state. If called when the camera isn't
@@ -0,0 +1,156 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+/*
+ * Copyright (C) 2026, Ideas on Board Oy
+ *
+ * camera_configuration_cache.cpp - Cache of camera configuration validation results
+ */
+
+#include "libcamera/internal/camera_configuration_cache.h"
+
+/**
+ * \file camera_configuration_cache.h
+ * \brief Cache of camera configuration validation results
+ */
+
+namespace libcamera {
+
+/**
+ * \class CameraConfigurationKey
+ * \brief Identify the parameters of a camera configuration
+ *
+ * The CameraConfigurationKey stores the parameters of a CameraConfiguration
+ * that applications can set: the transform, and the pixel format, size,
+ * stride, frame size, buffer count and color space of each stream
+ * configuration. Two keys compare equal if all those parameters are equal.
+ * The streams associated with the stream configurations are ignored.
+ *
+ * Keys are used to look up cached validation results in a
+ * CameraConfigurationCache, and to compare a configuration with the one that
+ * has been applied to a camera.
+ */
+
+/**
+ * \brief Construct an empty key
+ *
+ * The empty key corresponds to an empty camera configuration.
+ */
+CameraConfigurationKey::CameraConfigurationKey()
+	: transform_(Transform::Identity)
+{
+}
+
+/**
+ * \brief Construct a key for a camera configuration
+ * \param[in] config The camera configuration
+ */
+CameraConfigurationKey::CameraConfigurationKey(const CameraConfiguration &config)
+	: transform_(config.transform)
+{
+	streams_.reserve(config.size());
+
+	for (const StreamConfiguration &cfg : config)
+		streams_.push_back({ cfg.pixelFormat, cfg.size, cfg.stride,
+				     cfg.frameSize, cfg.bufferCount,
+				     cfg.colorSpace });
+}
+
+/**
+ * \brief Compare two keys for equality
+ * \param[in] other The other key
+ * \return True if the keys identify identical camera configurations, false
+ * otherwise
+ */
+bool CameraConfigurationKey::operator==(const CameraConfigurationKey &other) const
+{
+	return transform_ == other.transform_ && streams_ == other.streams_;
+}
+
+/**
+ * \fn CameraConfigurationKey::operator!=()
+ * \brief Compare two keys for inequality
+ * \param[in] other The other key
+ * \return True if the keys identify different camera configurations, false
+ * otherwise
+ */
+
+bool CameraConfigurationKey::StreamKey::operator==(const StreamKey &other) const
+{
+	return pixelFormat == other.pixelFormat && size == other.size &&
+	       stride == other.stride && frameSize == other.frameSize &&
+	       bufferCount == other.bufferCount &&
+	       colorSpace == other.colorSpace;
+}
+
+/**
+ * \class CameraConfigurationCache
+ * \brief Cache the results of camera configuration validation
+ * \tparam Value The type of the cached validation results
+ *
+ * Applications commonly validate the same camera configurations multiple times,
+ * when negotiating formats with other components or when configuring the
+ * camera with a configuration they have validated. Validation of a camera
+ * configuration can be expensive, as pipeline handlers select the sensor
+ * format and try formats on the devices of the pipeline.
+ *
+ * The CameraConfigurationCache stores validation results keyed by the
+ * configuration requested by the application. Pipeline handlers store a cache
+ * instance in their camera data, and define the \a Value type to hold the
+ * validation status, the adjusted configuration and all the internal data
+ * computed by their CameraConfiguration::validate() implementation. Validation
+ * then looks up the requested configuration in the cache with find() and
+ * restores the result from the cached value on a hit, or performs the
+ * validation and stores the result with insert() on a miss. As a consequence,
+ * validation results must only depend on the requested configuration and on
+ * the camera data that doesn't change after camera creation.
+ *
+ * The cache holds up to kMaxEntries entries, and evicts the least recently
+ * used entry when full.
+ *
+ * \context This class is \threadsafe.
+ */
+
+/**
+ * \var CameraConfigurationCache::kMaxEntries
+ * \brief The maximum number of entries stored in the cache
+ */
+
+/**
+ * \fn CameraConfigurationCache::CameraConfigurationCache()
+ * \brief Construct an empty cache
+ */
+
+/**
+ * \fn CameraConfigurationCache::find()
+ * \brief Look up a cached validation result
+ * \param[in] key The key of the requested camera configuration
+ * \return A copy of the cached value if found, or std::nullopt otherwise
+ */
+
+/**
+ * \fn CameraConfigurationCache::insert()
+ * \brief Store a validation result in the cache
+ * \param[in] key The key of the requested camera configuration
+ * \param[in] value The validation result
+ *
+ * The \a key shall be constructed from the camera configuration before it is
+ * validated. Any existing entry for the same \a key is replaced.
+ */
+
+/**
+ * \fn CameraConfigurationCache::clear()
+ * \brief Remove all entries from the cache
+ */
+
+/**
+ * \fn CameraConfigurationCache::hits()
+ * \brief Retrieve the number of lookups that found a cached result
+ * \return The number of cache hits
+ */
+
+/**
+ * \fn CameraConfigurationCache::misses()
+ * \brief Retrieve the number of lookups that didn't find a cached result
+ * \return The number of cache misses
+ */
+
+} /* namespace libcamera */
@@ -16,6 +16,7 @@
 #include "libcamera/internal/camera.h"
 #include "libcamera/internal/device_enumerator.h"
 #include "libcamera/internal/pipeline_handler.h"
+#include "libcamera/internal/v4l2_capability_cache.h"
 
 /**
  * \file libcamera/camera_manager.h
@@ -87,11 +88,34 @@ void CameraManager::Private::run()
 
 int CameraManager::Private::init()
 {
+	utils::time_point start = utils::clock::now();
+
+	std::string cachePath = V4L2CapabilityCache::defaultPath();
+	if (!cachePath.empty())
+		capabilityCache_ = std::make_unique<V4L2CapabilityCache>(cachePath);
+
 	enumerator_ = DeviceEnumerator::create();
 	if (!enumerator_ || enumerator_->enumerate())
 		return -ENODEV;
 
+	utils::time_point enumerated = utils::clock::now();
+
 	createPipelineHandlers();
+
+	LOG(Camera, Debug)
+		<< "Startup took "
+		<< utils::Duration(utils::clock::now() - start).get<std::milli>()
+		<< "ms, including "
+		<< utils::Duration(enumerated - start).get<std::milli>()
+		<< "ms of device enumeration";
+
+	if (capabilityCache_) {
+		LOG(Camera, Debug)
+			<< "V4L2 capability cache: " << capabilityCache_->hits()
+			<< " hits, " << capabilityCache_->misses() << " misses";
+
+		capabilityCache_->save();
+	}
 	enumerator_->devicesAdded.connect(this, &Private::createPipelineHandlers);
 
 	return 0;
@@ -116,7 +140,16 @@ void CameraManager::Private::createPipelineHandlers()
 		/*
 		 * Try each pipeline handler until it exhaust
 		 * all pipelines it can provide.
+		 *
+		 * \todo Match pipeline handlers concurrently, as camera
+		 * sensor initialization dominates the matching time. This
+		 * requires match() implementations to create their objects
+		 * in the camera manager thread, and the device enumerator to
+		 * support concurrent acquisition of media devices.
 		 */
+		utils::time_point start = utils::clock::now();
+		unsigned int matches = 0;
+
 		while (1) {
 			std::shared_ptr<PipelineHandler> pipe = factory->create(o);
 			if (!pipe->match(enumerator_.get()))
@@ -125,7 +158,13 @@ void CameraManager::Private::createPipelineHandlers()
 			LOG(Camera, Debug)
 				<< "Pipeline handler \"" << factory->name()
 				<< "\" matched";
+			matches++;
 		}
+
+		LOG(Camera, Debug)
+			<< "Pipeline handler \"" << factory->name() << "\" took "
+			<< utils::Duration(utils::clock::now() - start).get<std::milli>()
+			<< "ms for " << matches << " match(es)";
 	}
 }
 
@@ -148,6 +187,7 @@ void CameraManager::Private::cleanup()
 	dispatchMessages(Message::Type::DeferredDelete);
 
 	enumerator_.reset(nullptr);
+	capabilityCache_.reset();
 }
 
 /**
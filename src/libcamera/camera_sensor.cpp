@@ -24,6 +24,7 @@
 #include "libcamera/internal/camera_sensor_properties.h"
 #include "libcamera/internal/formats.h"
 #include "libcamera/internal/sysfs.h"
+#include "libcamera/internal/v4l2_capability_cache.h"
 
 /**
  * \file camera_sensor.h
@@ -119,8 +120,24 @@ int CameraSensor::init()
 		ctrls.set(V4L2_CID_VFLIP, 0);
 	subdev_->setControls(&ctrls);
 
-	/* Enumerate, sort and cache media bus codes and sizes. */
-	formats_ = subdev_->formats(pad_);
+	/*
+	 * Enumerate, sort and cache media bus codes and sizes. The enumeration
+	 * is performed with flips cleared and doesn't depend on the sensor
+	 * state, so it can be stored in the persistent capability cache.
+	 */
+	V4L2CapabilityCache *cache = V4L2CapabilityCache::instance();
+	const MediaDevice *media = entity_->device();
+	const std::string key = "sensor:" + media->driver() + ":" + media->model()
+			      + ":" + std::to_string(media->hwRevision())
+			      + ":" + std::to_string(media->version())
+			      + ":" + entity_->name() + ":" + std::to_string(pad_);
+
+	if (!cache || !cache->formats(key, &formats_)) {
+		formats_ = subdev_->formats(pad_);
+		if (cache && !formats_.empty())
+			cache->setFormats(key, formats_);
+	}
+
 	if (formats_.empty()) {
 		LOG(CameraSensor, Error) << "No image format found";
 		return -EINVAL;
@@ -45,19 +45,16 @@ LOG_DEFINE_CATEGORY(Converter)
  */
 Converter::Converter(MediaDevice *media)
 {
-	const std::vector<MediaEntity *> &entities = media->entities();
-	auto it = std::find_if(entities.begin(), entities.end(),
-			       [](MediaEntity *entity) {
-				       return entity->function() == MEDIA_ENT_F_IO_V4L;
-			       });
-	if (it == entities.end()) {
+	const std::vector<MediaEntity *> &entities =
+		media->entitiesByFunction(MEDIA_ENT_F_IO_V4L);
+	if (entities.empty()) {
 		LOG(Converter, Error)
 			<< "No entity suitable for implementing a converter in "
 			<< media->driver() << " entities list.";
 		return;
 	}
 
-	deviceNode_ = (*it)->deviceNode();
+	deviceNode_ = entities[0]->deviceNode();
 }
 
 Converter::~Converter()
@@ -7,6 +7,9 @@
 
 #include "libcamera/internal/delayed_controls.h"
 
+#include <algorithm>
+#include <string.h>
+
 #include <libcamera/base/log.h>
 
 #include <libcamera/controls.h>
@@ -36,6 +39,15 @@ LOG_DEFINE_CATEGORY(DelayedControls)
  * control depth the controls are guaranteed to take effect for the correct
  * request. The control depth is determined by the control with the greatest
  * delay.
+ *
+ * The controls are written to the device from the frame start handler, which
+ * has to complete within the vertical blanking period of the sensor for the
+ * controls to take effect at the expected frame. The write operations are
+ * prepared when the instance is constructed and reset, so that writing the
+ * controls at frame start doesn't allocate memory and issues at most two
+ * VIDIOC_S_EXT_CTRLS calls, one for the priority controls and one for all
+ * other controls. The time taken to write the controls is recorded in the
+ * statistics().
  */
 
 /**
@@ -57,6 +69,32 @@ LOG_DEFINE_CATEGORY(DelayedControls)
  * blanking bounds.
  */
 
+/**
+ * \struct DelayedControls::Statistics
+ * \brief Statistics about the control writes performed at frame start
+ *
+ * The write latency is measured from the frame start notification to the
+ * completion of the control writes. When it approaches the duration of the
+ * vertical blanking period of the sensor, controls risk being applied one frame
+ * late.
+ *
+ * \var Statistics::frames
+ * \brief Number of frame start notifications handled
+ *
+ * \var Statistics::writes
+ * \brief Number of frame start notifications that resulted in control writes
+ *
+ * \var Statistics::lastLatency
+ * \brief Write latency of the last frame that resulted in control writes
+ *
+ * \var Statistics::maxLatency
+ * \brief Maximum write latency
+ *
+ * \var Statistics::totalLatency
+ * \brief Sum of the write latencies of all frames that resulted in control
+ * writes
+ */
+
 /**
  * \brief Construct a DelayedControls instance
  * \param[in] device The V4L2 device the controls have to be applied to
@@ -78,8 +116,8 @@ DelayedControls::DelayedControls(V4L2Device *device,
 	const ControlInfoMap &controls = device_->controls();
 
 	/*
-	 * Create a map of control ids to delays for controls exposed by the
-	 * device.
+	 * Create the list of controls exposed by the device along with their
+	 * delays.
 	 */
 	for (auto const &param : controlParams) {
 		auto it = controls.find(param.first);
@@ -94,16 +132,24 @@ DelayedControls::DelayedControls(V4L2Device *device,
 
 		const ControlId *id = it->first;
 
-		controlParams_[id] = param.second;
+		Control &ctrl = controls_.emplace_back();
+		ctrl.id = id;
+		ctrl.params = param.second;
+		ctrl.type = id->type();
 
 		LOG(DelayedControls, Debug)
-			<< "Set a delay of " << controlParams_[id].delay
-			<< " and priority write flag " << controlParams_[id].priorityWrite
+			<< "Set a delay of " << ctrl.params.delay
+			<< " and priority write flag " << ctrl.params.priorityWrite
 			<< " for " << id->name();
 
-		maxDelay_ = std::max(maxDelay_, controlParams_[id].delay);
+		maxDelay_ = std::max(maxDelay_, ctrl.params.delay);
 	}
 
+	std::sort(controls_.begin(), controls_.end(),
+		  [](const Control &a, const Control &b) {
+			  return a.id->id() < b.id->id();
+		  });
+
 	reset();
 }
 
@@ -118,23 +164,41 @@ void DelayedControls::reset()
 	queueCount_ = 1;
 	writeCount_ = 0;
 
+	if (stats_.frames)
+		LOG(DelayedControls, Debug)
+			<< "Wrote controls for " << stats_.writes << " of "
+			<< stats_.frames << " frames, write latency max "
+			<< stats_.maxLatency.get<std::micro>() << "us, average "
+			<< (stats_.writes ? stats_.totalLatency.get<std::micro>() / stats_.writes : 0)
+			<< "us";
+
+	stats_ = {};
+
 	/* Retrieve control as reported by the device. */
 	std::vector<uint32_t> ids;
-	for (auto const &param : controlParams_)
-		ids.push_back(param.first->id());
+	for (const Control &ctrl : controls_)
+		ids.push_back(ctrl.id->id());
 
 	ControlList controls = device_->getControls(ids);
 
-	/* Seed the control queue with the controls reported by the device. */
-	values_.clear();
-	for (const auto &ctrl : controls) {
-		const ControlId *id = device_->controls().idmap().at(ctrl.first);
-		/*
-		 * Do not mark this control value as updated, it does not need
-		 * to be written to to device on startup.
-		 */
-		values_[id][0] = Info(ctrl.second, false);
+	/*
+	 * Seed the control queue with the controls reported by the device. Do
+	 * not mark the values as updated, they do not need to be written to
+	 * the device on startup.
+	 */
+	unsigned int priorityCount = 0;
+	for (Control &ctrl : controls_) {
+		ctrl.values = {};
+		if (controls.contains(ctrl.id->id()))
+			ctrl.values[0] = Info(controls.get(ctrl.id->id()), false);
+
+		if (ctrl.params.priorityWrite)
+			priorityCount++;
 	}
+
+	/* Size the write arrays to the worst case of all controls updated. */
+	priorityWrites_.resize(priorityCount);
+	writes_.resize(controls_.size() - priorityCount);
 }
 
 /**
@@ -149,9 +213,9 @@ void DelayedControls::reset()
 bool DelayedControls::push(const ControlList &controls)
 {
 	/* Copy state from previous frame. */
-	for (auto &ctrl : values_) {
-		Info &info = ctrl.second[queueCount_];
-		info = values_[ctrl.first][queueCount_ - 1];
+	for (Control &ctrl : controls_) {
+		Info &info = ctrl.values[queueCount_];
+		info = ctrl.values[queueCount_ - 1];
 		info.updated = false;
 	}
 
@@ -165,17 +229,16 @@ bool DelayedControls::push(const ControlList &controls)
 			return false;
 		}
 
-		const ControlId *id = it->second;
-
-		if (controlParams_.find(id) == controlParams_.end())
+		Control *ctrl = findControl(it->second);
+		if (!ctrl)
 			return false;
 
-		Info &info = values_[id][queueCount_];
+		Info &info = ctrl->values[queueCount_];
 
 		info = Info(control.second);
 
 		LOG(DelayedControls, Debug)
-			<< "Queuing " << id->name()
+			<< "Queuing " << ctrl->id->name()
 			<< " to " << info.toString()
 			<< " at index " << queueCount_;
 	}
@@ -205,9 +268,12 @@ ControlList DelayedControls::get(uint32_t sequence)
 	unsigned int index = std::max<int>(0, sequence - maxDelay_);
 
 	ControlList out(device_->controls());
-	for (const auto &ctrl : values_) {
-		const ControlId *id = ctrl.first;
-		const Info &info = ctrl.second[index];
+	for (const Control &ctrl : controls_) {
+		const ControlId *id = ctrl.id;
+		const Info &info = ctrl.values[index];
+
+		if (info.isNone())
+			continue;
 
 		out.set(id->id(), info);
 
@@ -231,44 +297,67 @@ ControlList DelayedControls::get(uint32_t sequence)
  */
 void DelayedControls::applyControls(uint32_t sequence)
 {
-	LOG(DelayedControls, Debug) << "frame " << sequence << " started";
+	utils::time_point start = utils::clock::now();
 
 	/*
-	 * Create control list peeking ahead in the value queue to ensure
-	 * values are set in time to satisfy the sensor delay.
+	 * Collect the updated controls, peeking ahead in the value queue to
+	 * ensure values are set in time to satisfy the sensor delay. Logging
+	 * is avoided here as it would allocate memory.
 	 */
-	ControlList out(device_->controls());
-	for (auto &ctrl : values_) {
-		const ControlId *id = ctrl.first;
-		unsigned int delayDiff = maxDelay_ - controlParams_[id].delay;
+	unsigned int priorityCount = 0;
+	unsigned int count = 0;
+
+	for (Control &ctrl : controls_) {
+		unsigned int delayDiff = maxDelay_ - ctrl.params.delay;
 		unsigned int index = std::max<int>(0, writeCount_ - delayDiff);
-		Info &info = ctrl.second[index];
-
-		if (info.updated) {
-			if (controlParams_[id].priorityWrite) {
-				/*
-				 * This control must be written now, it could
-				 * affect validity of the other controls.
-				 */
-				ControlList priority(device_->controls());
-				priority.set(id->id(), info);
-				device_->setControls(&priority);
-			} else {
-				/*
-				 * Batch up the list of controls and write them
-				 * at the end of the function.
-				 */
-				out.set(id->id(), info);
-			}
-
-			LOG(DelayedControls, Debug)
-				<< "Setting " << id->name()
-				<< " to " << info.toString()
-				<< " at index " << index;
-
-			/* Done with this update, so mark as completed. */
+		Info &info = ctrl.values[index];
+
+		if (!info.updated)
+			continue;
+
+		/*
+		 * Priority controls are written separately and first, they
+		 * could affect the validity of the other controls.
+		 */
+		v4l2_ext_control *v4l2Ctrl = ctrl.params.priorityWrite
+					   ? &priorityWrites_[priorityCount]
+					   : &writes_[count];
+		if (!fillV4L2Control(v4l2Ctrl, ctrl, info)) {
+			/*
+			 * Drop the invalid value to avoid retrying it on every
+			 * frame. This is an error path, logging is fine.
+			 */
+			LOG(DelayedControls, Error)
+				<< "Invalid value for control " << ctrl.id->name()
+				<< " on frame " << sequence;
 			info.updated = false;
+			continue;
 		}
+
+		if (ctrl.params.priorityWrite)
+			priorityCount++;
+		else
+			count++;
+
+		/* Done with this update, so mark as completed. */
+		info.updated = false;
+	}
+
+	if (priorityCount)
+		device_->setControls(Span<v4l2_ext_control>(priorityWrites_.data(),
+							    priorityCount));
+	if (count)
+		device_->setControls(Span<v4l2_ext_control>(writes_.data(), count));
+
+	stats_.frames++;
+
+	if (priorityCount || count) {
+		utils::Duration latency = utils::clock::now() - start;
+
+		stats_.writes++;
+		stats_.lastLatency = latency;
+		stats_.maxLatency = std::max(stats_.maxLatency, latency);
+		stats_.totalLatency += latency;
 	}
 
 	writeCount_ = sequence + 1;
@@ -278,8 +367,69 @@ void DelayedControls::applyControls(uint32_t sequence)
 			<< "Queue is empty, auto queue no-op.";
 		push({});
 	}
+}
+
+/**
+ * \fn DelayedControls::statistics()
+ * \brief Retrieve statistics about the control writes performed at frame start
+ *
+ * The statistics are reset by reset().
+ *
+ * \return The control write statistics
+ */
+
+/*
+ * Fill the V4L2 control structure to write the value \a info of \a ctrl. The
+ * structure references the value storage for array controls, \a info must
+ * thus stay valid until the write completes.
+ */
+bool DelayedControls::fillV4L2Control(v4l2_ext_control *v4l2Ctrl,
+				      const Control &ctrl, Info &info)
+{
+	memset(v4l2Ctrl, 0, sizeof(*v4l2Ctrl));
+	v4l2Ctrl->id = ctrl.id->id();
+
+	switch (ctrl.type) {
+	case ControlTypeInteger32:
+		if (info.isArray()) {
+			Span<uint8_t> data = info.data();
+			v4l2Ctrl->p_u32 = reinterpret_cast<uint32_t *>(data.data());
+			v4l2Ctrl->size = data.size();
+		} else {
+			v4l2Ctrl->value = info.get<int32_t>();
+		}
+		break;
+
+	case ControlTypeInteger64:
+		v4l2Ctrl->value64 = info.get<int64_t>();
+		break;
+
+	case ControlTypeByte: {
+		if (!info.isArray())
+			return false;
+
+		Span<uint8_t> data = info.data();
+		v4l2Ctrl->p_u8 = data.data();
+		v4l2Ctrl->size = data.size();
+		break;
+	}
+
+	default:
+		v4l2Ctrl->value = info.get<int32_t>();
+		break;
+	}
+
+	return true;
+}
+
+DelayedControls::Control *DelayedControls::findControl(const ControlId *id)
+{
+	auto it = std::find_if(controls_.begin(), controls_.end(),
+			       [id](const Control &ctrl) { return ctrl.id == id; });
+	if (it == controls_.end())
+		return nullptr;
 
-	device_->setControls(&out);
+	return &*it;
 }
 
 } /* namespace libcamera */
@@ -7,9 +7,14 @@
 
 #include "libcamera/internal/device_enumerator.h"
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
 #include <string.h>
+#include <thread>
 
 #include <libcamera/base/log.h>
+#include <libcamera/base/thread.h>
 
 #include "libcamera/internal/device_enumerator_sysfs.h"
 #include "libcamera/internal/device_enumerator_udev.h"
@@ -40,6 +45,31 @@ namespace libcamera {
 
 LOG_DEFINE_CATEGORY(DeviceEnumerator)
 
+namespace {
+
+/* Upper bound of the number of threads used to probe media devices. */
+constexpr unsigned int kMaxProbeThreads = 4;
+
+class MediaDeviceProbeThread : public Thread
+{
+public:
+	MediaDeviceProbeThread(const std::function<void()> &work)
+		: work_(work)
+	{
+	}
+
+protected:
+	void run() override
+	{
+		work_();
+	}
+
+private:
+	std::function<void()> work_;
+};
+
+} /* namespace */
+
 /**
  * \class DeviceMatch
  * \brief Description of a media device search pattern
@@ -97,16 +127,7 @@ bool DeviceMatch::match(const MediaDevice *device) const
 		return false;
 
 	for (const std::string &name : entities_) {
-		bool found = false;
-
-		for (const MediaEntity *entity : device->entities()) {
-			if (name == entity->name()) {
-				found = true;
-				break;
-			}
-		}
-
-		if (!found)
+		if (!device->getEntityByName(name))
 			return false;
 	}
 
@@ -228,6 +249,51 @@ std::unique_ptr<MediaDevice> DeviceEnumerator::createDevice(const std::string &d
 	return media;
 }
 
+/**
+ * \brief Create media device instances concurrently
+ * \param[in] deviceNodes paths to the media devices to create
+ *
+ * Create media devices for all the \a deviceNodes, as createDevice() does.
+ * Opening a media device and populating its media graph only involves the
+ * device itself, so the devices are probed concurrently on a bounded number
+ * of threads to speed up the enumeration of systems with many media devices.
+ *
+ * The remaining steps of the device creation, described in createDevice(),
+ * are left to the caller.
+ *
+ * \return Created media device instances, in the same order as \a deviceNodes,
+ * with a nullptr entry for each device that failed to be created
+ */
+std::vector<std::unique_ptr<MediaDevice>>
+DeviceEnumerator::createDevices(const std::vector<std::string> &deviceNodes)
+{
+	std::vector<std::unique_ptr<MediaDevice>> media(deviceNodes.size());
+	std::atomic<size_t> next = 0;
+
+	auto work = [&]() {
+		for (size_t i = next++; i < deviceNodes.size(); i = next++)
+			media[i] = createDevice(deviceNodes[i]);
+	};
+
+	size_t numThreads = std::min<size_t>({ deviceNodes.size(),
+					       std::thread::hardware_concurrency(),
+					       kMaxProbeThreads });
+
+	/* The calling thread takes part in the work. */
+	std::vector<std::unique_ptr<MediaDeviceProbeThread>> threads;
+	for (size_t i = 1; i < numThreads; ++i) {
+		threads.push_back(std::make_unique<MediaDeviceProbeThread>(work));
+		threads.back()->start();
+	}
+
+	work();
+
+	for (std::unique_ptr<MediaDeviceProbeThread> &thread : threads)
+		thread->wait();
+
+	return media;
+}
+
 /**
 * \var DeviceEnumerator::devicesAdded
 * \brief Notify of new media devices being found
@@ -16,6 +16,7 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
+#include <vector>
 
 #include <libcamera/base/log.h>
 
@@ -32,6 +33,7 @@ int DeviceEnumeratorSysfs::init()
 
 int DeviceEnumeratorSysfs::enumerate()
 {
+	std::vector<std::string> mediaNodes;
 	struct dirent *ent;
 	DIR *dir;
 
@@ -73,7 +75,16 @@ int DeviceEnumeratorSysfs::enumerate()
 			continue;
 		}
 
-		std::unique_ptr<MediaDevice> media = createDevice(devnode);
+		mediaNodes.push_back(devnode);
+	}
+
+	closedir(dir);
+
+	/*
+	 * Populate the media graphs concurrently, and add the devices in
+	 * enumeration order to keep the result deterministic.
+	 */
+	for (std::unique_ptr<MediaDevice> &media : createDevices(mediaNodes)) {
 		if (!media)
 			continue;
 
@@ -88,8 +99,6 @@ int DeviceEnumeratorSysfs::enumerate()
 		addDevice(std::move(media));
 	}
 
-	closedir(dir);
-
 	return 0;
 }
 
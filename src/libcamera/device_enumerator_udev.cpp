@@ -17,6 +17,7 @@
 #include <sys/ioctl.h>
 #include <sys/sysmacros.h>
 #include <unistd.h>
+#include <vector>
 
 #include <libcamera/base/event_notifier.h>
 #include <libcamera/base/log.h>
@@ -70,46 +71,48 @@ int DeviceEnumeratorUdev::init()
 	return 0;
 }
 
-int DeviceEnumeratorUdev::addUdevDevice(struct udev_device *dev)
+int DeviceEnumeratorUdev::addMediaDevice(std::unique_ptr<MediaDevice> media)
 {
-	const char *subsystem = udev_device_get_subsystem(dev);
-	if (!subsystem)
+	if (!media)
 		return -ENODEV;
 
-	if (!strcmp(subsystem, "media")) {
-		std::unique_ptr<MediaDevice> media =
-			createDevice(udev_device_get_devnode(dev));
-		if (!media)
-			return -ENODEV;
-
-		DependencyMap deps;
-		int ret = populateMediaDevice(media.get(), &deps);
-		if (ret < 0) {
-			LOG(DeviceEnumerator, Warning)
-				<< "Failed to populate media device "
-				<< media->deviceNode()
-				<< " (" << media->driver() << "), skipping";
-			return ret;
-		}
-
-		if (!deps.empty()) {
-			LOG(DeviceEnumerator, Debug)
-				<< "Defer media device " << media->deviceNode()
-				<< " due to " << deps.size()
-				<< " missing dependencies";
+	DependencyMap deps;
+	int ret = populateMediaDevice(media.get(), &deps);
+	if (ret < 0) {
+		LOG(DeviceEnumerator, Warning)
+			<< "Failed to populate media device "
+			<< media->deviceNode()
+			<< " (" << media->driver() << "), skipping";
+		return ret;
+	}
 
-			pending_.emplace_back(std::move(media), std::move(deps));
-			MediaDeviceDeps *mediaDeps = &pending_.back();
-			for (const auto &dep : mediaDeps->deps_)
-				devMap_[dep.first] = mediaDeps;
+	if (!deps.empty()) {
+		LOG(DeviceEnumerator, Debug)
+			<< "Defer media device " << media->deviceNode()
+			<< " due to " << deps.size()
+			<< " missing dependencies";
 
-			return 0;
-		}
+		pending_.emplace_back(std::move(media), std::move(deps));
+		MediaDeviceDeps *mediaDeps = &pending_.back();
+		for (const auto &dep : mediaDeps->deps_)
+			devMap_[dep.first] = mediaDeps;
 
-		addDevice(std::move(media));
 		return 0;
 	}
 
+	addDevice(std::move(media));
+	return 0;
+}
+
+int DeviceEnumeratorUdev::addUdevDevice(struct udev_device *dev)
+{
+	const char *subsystem = udev_device_get_subsystem(dev);
+	if (!subsystem)
+		return -ENODEV;
+
+	if (!strcmp(subsystem, "media"))
+		return addMediaDevice(createDevice(udev_device_get_devnode(dev)));
+
 	if (!strcmp(subsystem, "video4linux")) {
 		addV4L2Device(udev_device_get_devnum(dev));
 		return 0;
@@ -122,6 +125,10 @@ int DeviceEnumeratorUdev::enumerate()
 {
 	struct udev_enumerate *udev_enum = nullptr;
 	struct udev_list_entry *ents, *ent;
+	std::vector<struct udev_device *> devices;
+	std::vector<std::string> mediaNodes;
+	std::vector<std::unique_ptr<MediaDevice>> media;
+	auto nextMedia = media.begin();
 	int ret;
 
 	udev_enum = udev_enumerate_new(udev_);
@@ -151,6 +158,7 @@ int DeviceEnumeratorUdev::enumerate()
 	udev_list_entry_foreach(ent, ents) {
 		struct udev_device *dev;
 		const char *devnode;
+		const char *subsystem;
 		const char *syspath = udev_list_entry_get_name(ent);
 
 		dev = udev_device_new_from_syspath(udev_, syspath);
@@ -170,10 +178,34 @@ int DeviceEnumeratorUdev::enumerate()
 			continue;
 		}
 
-		if (addUdevDevice(dev) < 0)
+		subsystem = udev_device_get_subsystem(dev);
+		if (subsystem && !strcmp(subsystem, "media"))
+			mediaNodes.push_back(devnode);
+
+		devices.push_back(dev);
+	}
+
+	/*
+	 * Populating the media graphs is the most expensive part of the
+	 * enumeration. Do it concurrently for all media devices, and then add
+	 * the devices in enumeration order to keep the result deterministic.
+	 */
+	media = createDevices(mediaNodes);
+	nextMedia = media.begin();
+
+	for (struct udev_device *dev : devices) {
+		const char *subsystem = udev_device_get_subsystem(dev);
+		int err;
+
+		if (subsystem && !strcmp(subsystem, "media"))
+			err = addMediaDevice(std::move(*nextMedia++));
+		else
+			err = addUdevDevice(dev);
+
+		if (err < 0)
 			LOG(DeviceEnumerator, Warning)
 				<< "Failed to add device for '"
-				<< syspath << "', skipping";
+				<< udev_device_get_syspath(dev) << "', skipping";
 
 		udev_device_unref(dev);
 	}
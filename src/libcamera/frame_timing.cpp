@@ -0,0 +1,159 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+/*
+ * Copyright (C) 2026, Ideas on Board Oy
+ *
+ * frame_timing.cpp - Frame timing model for capture sequence prediction
+ */
+
+#include "libcamera/internal/frame_timing.h"
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * \file frame_timing.h
+ * \brief Frame timing model for capture sequence prediction
+ */
+
+namespace libcamera {
+
+/**
+ * \class FrameTimingModel
+ * \brief Model the timing of the frames captured by a camera
+ *
+ * When a request is queued to a running camera, it is captured by one of the
+ * next frames produced by the sensor. Which one depends on the number of
+ * requests already queued, and on the time left before the next frame starts.
+ * The FrameTimingModel tracks the sequence numbers and timestamps of captured
+ * frames to estimate the frame duration, and predicts the sequence number of
+ * the frame that a request queued at a given time will be captured in.
+ *
+ * The model is fed with frame start events when the pipeline handler has
+ * access to them, through frameStarted(), and with the sequence numbers and
+ * timestamps of completed requests through frameCompleted(). Frame start events
+ * are more accurate and more timely, completed requests are only used when
+ * no frame start event has been received.
+ *
+ * Predictions assume that requests are captured in the order they are queued,
+ * one frame per request, and that the sequence numbers restart from 0 when the
+ * camera is started.
+ */
+
+/**
+ * \brief Construct a frame timing model
+ */
+FrameTimingModel::FrameTimingModel()
+{
+	reset();
+}
+
+/**
+ * \brief Reset the model
+ *
+ * This function shall be called when the camera is stopped, as frame sequence
+ * numbers restart when it is started again.
+ */
+void FrameTimingModel::reset()
+{
+	frameStartEvents_ = false;
+	valid_ = false;
+	sequence_ = 0;
+	time_ = {};
+	frameDuration_ = {};
+	lastPrediction_.reset();
+}
+
+/**
+ * \brief Record the start of a frame
+ * \param[in] sequence The frame sequence number
+ * \param[in] time The time at which the frame started
+ */
+void FrameTimingModel::frameStarted(uint32_t sequence, utils::time_point time)
+{
+	if (!frameStartEvents_) {
+		/* Completed frames timestamps may use a different reference. */
+		frameStartEvents_ = true;
+		valid_ = false;
+	}
+
+	update(sequence, time);
+}
+
+/**
+ * \brief Record the completion of a frame
+ * \param[in] sequence The frame sequence number
+ * \param[in] time The timestamp of the frame
+ *
+ * Completed frames are ignored once frame start events have been recorded.
+ */
+void FrameTimingModel::frameCompleted(uint32_t sequence, utils::time_point time)
+{
+	if (frameStartEvents_)
+		return;
+
+	update(sequence, time);
+}
+
+/**
+ * \brief Predict the sequence number of the frame that will capture a request
+ * \param[in] time The time at which the request is queued to the device
+ *
+ * The prediction is the sequence number of the first frame that starts after
+ * \a time, or the frame following the one predicted for the previous request
+ * if later. Predictions are thus expected to be made for every request, in the
+ * order they are queued.
+ *
+ * \return The predicted frame sequence number
+ */
+uint32_t FrameTimingModel::predictSequence(utils::time_point time)
+{
+	uint32_t sequence = 0;
+
+	if (valid_) {
+		sequence = sequence_ + 1;
+
+		if (frameDuration_ && time > time_) {
+			utils::Duration elapsed = time - time_;
+			sequence += std::floor(elapsed / frameDuration_);
+		}
+	}
+
+	if (lastPrediction_)
+		sequence = std::max(sequence, *lastPrediction_ + 1);
+
+	lastPrediction_ = sequence;
+
+	return sequence;
+}
+
+/**
+ * \fn FrameTimingModel::frameDuration()
+ * \brief Retrieve the estimated frame duration
+ * \return The estimated frame duration, or a zero duration if not known yet
+ */
+
+void FrameTimingModel::update(uint32_t sequence, utils::time_point time)
+{
+	if (valid_ && sequence <= sequence_)
+		return;
+
+	if (valid_ && time > time_) {
+		utils::Duration duration = utils::Duration(time - time_) /
+					   (sequence - sequence_);
+
+		/*
+		 * Smooth the estimate to absorb jitter in the event delivery,
+		 * while following frame duration changes within a few frames.
+		 */
+		if (frameDuration_)
+			frameDuration_ = frameDuration_ * 0.75 + duration * 0.25;
+		else
+			frameDuration_ = duration;
+	}
+
+	sequence_ = sequence;
+	time_ = time;
+	valid_ = true;
+}
+
+} /* namespace libcamera */
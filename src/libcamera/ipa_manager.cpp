@@ -9,6 +9,7 @@
 
 #include <algorithm>
 #include <dirent.h>
+#include <stdlib.h>
 #include <string.h>
 #include <sys/types.h>
 
@@ -29,6 +30,13 @@ namespace libcamera {
 
 LOG_DEFINE_CATEGORY(IPAManager)
 
+namespace {
+
+/* Upper bound of the number of idle proxy workers per IPA module. */
+constexpr unsigned long kMaxProxyWorkerPoolSize = 8;
+
+} /* namespace */
+
 /**
  * \class IPAManager
  * \brief Manager for IPA modules
@@ -93,6 +101,16 @@ LOG_DEFINE_CATEGORY(IPAManager)
  * serialized to Plain Old Data, either for the purpose of passing it to the IPA
  * context plain C API, or to transmit the data to the isolated process through
  * IPC.
+ *
+ * The IPA module information and the results of signature verification are
+ * cached on disk by an IPAModuleCache, which speeds up the discovery of IPA
+ * modules and the creation of IPA contexts for the next processes.
+ *
+ * The proxy worker processes of isolated IPA modules can additionally be
+ * pre-spawned and kept ready by an IPAProxyWorkerPool, to reduce the latency of
+ * IPA context creation. The pool is disabled by default, and is enabled by
+ * setting the LIBCAMERA_IPA_PROXY_POOL_SIZE environment variable to the number
+ * of idle workers to keep per IPA module.
  */
 
 IPAManager *IPAManager::self_ = nullptr;
@@ -114,6 +132,22 @@ IPAManager::IPAManager()
 		LOG(IPAManager, Warning) << "Public key not valid";
 #endif
 
+	cache_ = std::make_unique<IPAModuleCache>(IPAModuleCache::defaultPath());
+
+	const char *poolSize = utils::secure_getenv("LIBCAMERA_IPA_PROXY_POOL_SIZE");
+	if (poolSize) {
+		unsigned long size = strtoul(poolSize, nullptr, 10);
+		if (size > kMaxProxyWorkerPoolSize) {
+			LOG(IPAManager, Warning)
+				<< "Limiting IPA proxy worker pool size to "
+				<< kMaxProxyWorkerPoolSize;
+			size = kMaxProxyWorkerPoolSize;
+		}
+
+		if (size)
+			workerPool_ = std::make_unique<IPAProxyWorkerPool>(size);
+	}
+
 	unsigned int ipaCount = 0;
 
 	/* User-specified paths take precedence. */
@@ -154,6 +188,12 @@ IPAManager::IPAManager()
 		LOG(IPAManager, Warning)
 			<< "No IPA found in '" IPA_MODULE_DIR "'";
 
+	LOG(IPAManager, Debug)
+		<< "IPA module cache: " << cache_->hits() << " hits, "
+		<< cache_->misses() << " misses";
+
+	cache_->save();
+
 	self_ = this;
 }
 
@@ -236,7 +276,7 @@ unsigned int IPAManager::addDir(const char *libDir, unsigned int maxDepth)
 
 	unsigned int count = 0;
 	for (const std::string &file : files) {
-		IPAModule *ipaModule = new IPAModule(file);
+		IPAModule *ipaModule = new IPAModule(file, cache_.get());
 		if (!ipaModule->isValid()) {
 			delete ipaModule;
 			continue;
@@ -303,6 +343,16 @@ bool IPAManager::isSignatureValid([[maybe_unused]] IPAModule *ipa) const
 		return false;
 	}
 
+	const std::vector<uint8_t> signature = ipa->signature();
+
+	std::optional<bool> cached = cache_->signatureValid(ipa->path(), signature);
+	if (cached) {
+		LOG(IPAManager, Debug)
+			<< "IPA module " << ipa->path() << " signature is "
+			<< (*cached ? "valid" : "not valid") << " (cached)";
+		return *cached;
+	}
+
 	File file{ ipa->path() };
 	if (!file.open(File::OpenModeFlag::ReadOnly))
 		return false;
@@ -311,12 +361,15 @@ bool IPAManager::isSignatureValid([[maybe_unused]] IPAModule *ipa) const
 	if (data.empty())
 		return false;
 
-	bool valid = pubKey_.verify(data, ipa->signature());
+	bool valid = pubKey_.verify(data, signature);
 
 	LOG(IPAManager, Debug)
 		<< "IPA module " << ipa->path() << " signature is "
 		<< (valid ? "valid" : "not valid");
 
+	cache_->setSignatureValid(ipa->path(), signature, valid);
+	cache_->save();
+
 	return valid;
 #else
 	return false;
@@ -25,6 +25,7 @@
 #include <libcamera/base/span.h>
 #include <libcamera/base/utils.h>
 
+#include "libcamera/internal/ipa_module_cache.h"
 #include "libcamera/internal/pipeline_handler.h"
 
 /**
@@ -247,19 +248,24 @@ Span<const uint8_t> elfLoadSymbol(Span<const uint8_t> elf, const char *symbol)
 /**
  * \brief Construct an IPAModule instance
  * \param[in] libPath path to IPA module shared object
+ * \param[in] cache Cache of IPA module information (optional)
  *
  * Loads the IPAModuleInfo from the IPA module shared object at libPath.
  * The IPA module shared object file must be of the same endianness and
  * bitness as libcamera.
  *
+ * If a \a cache is given, the IPAModuleInfo is retrieved from the cache when
+ * available, and stored in the cache otherwise, to avoid parsing the shared
+ * object when the next IPAModule instance is created for the same file.
+ *
  * The caller shall call the isValid() function after constructing an
  * IPAModule instance to verify the validity of the IPAModule.
  */
-IPAModule::IPAModule(const std::string &libPath)
+IPAModule::IPAModule(const std::string &libPath, IPAModuleCache *cache)
 	: libPath_(libPath), valid_(false), loaded_(false),
 	  dlHandle_(nullptr), ipaCreate_(nullptr)
 {
-	if (loadIPAModuleInfo() < 0)
+	if (loadIPAModuleInfo(cache) < 0)
 		return;
 
 	valid_ = true;
@@ -271,7 +277,7 @@ IPAModule::~IPAModule()
 		dlclose(dlHandle_);
 }
 
-int IPAModule::loadIPAModuleInfo()
+int IPAModule::parseIPAModuleInfo()
 {
 	File file{ libPath_ };
 	if (!file.open(File::OpenModeFlag::ReadOnly)) {
@@ -295,6 +301,18 @@ int IPAModule::loadIPAModuleInfo()
 
 	memcpy(&info_, info.data(), sizeof(info_));
 
+	return 0;
+}
+
+int IPAModule::loadIPAModuleInfo(IPAModuleCache *cache)
+{
+	bool cached = cache && cache->moduleInfo(libPath_, &info_);
+	if (!cached) {
+		int ret = parseIPAModuleInfo();
+		if (ret)
+			return ret;
+	}
+
 	if (info_.moduleAPIVersion != IPA_MODULE_API_VERSION) {
 		LOG(IPAModule, Error) << "IPA module API version mismatch";
 		return -EINVAL;
@@ -319,6 +337,9 @@ int IPAModule::loadIPAModuleInfo()
 		return -EINVAL;
 	}
 
+	if (cache && !cached)
+		cache->setModuleInfo(libPath_, info_);
+
 	/* Load the signature. Failures are not fatal. */
 	File sign{ libPath_ + ".sign" };
 	if (!sign.open(File::OpenModeFlag::ReadOnly)) {
@@ -327,7 +348,7 @@ int IPAModule::loadIPAModuleInfo()
 		return 0;
 	}
 
-	data = sign.map(0, -1, File::MapFlag::Private);
+	Span<const uint8_t> data = sign.map(0, -1, File::MapFlag::Private);
 	signature_.resize(data.size());
 	memcpy(signature_.data(), data.data(), data.size());
 
@@ -0,0 +1,414 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+/*
+ * Copyright (C) 2026, Ideas on Board Oy
+ *
+ * ipa_module_cache.cpp - Persistent cache of IPA module information
+ */
+
+#include "libcamera/internal/ipa_module_cache.h"
+
+#include <algorithm>
+#include <errno.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <libcamera/base/log.h>
+#include <libcamera/base/utils.h>
+
+#include <libcamera/camera_manager.h>
+
+#include "libcamera/internal/cache_file.h"
+
+/**
+ * \file ipa_module_cache.h
+ * \brief Persistent cache of IPA module information
+ */
+
+namespace libcamera {
+
+LOG_DECLARE_CATEGORY(IPAManager)
+
+namespace {
+
+constexpr char kCacheMagic[8] = { 'L', 'C', 'I', 'P', 'A', 'M', 'C', '\0' };
+constexpr uint32_t kCacheFormatVersion = 1;
+
+enum EntryFlags : uint8_t {
+	EntryHasInfo = 1 << 0,
+	EntryHasSignature = 1 << 1,
+	EntrySignatureValid = 1 << 2,
+};
+
+} /* namespace */
+
+/**
+ * \class IPAModuleCache
+ * \brief Persistent cache of IPA module information and signature checks
+ *
+ * Creating an IPAModule requires parsing the ELF shared object to locate the
+ * IPA module information, and deciding whether the module can be loaded
+ * without isolation requires hashing the whole shared object to verify its
+ * signature. Both operations are performed every time a process starts a
+ * CameraManager, for every IPA module installed on the system.
+ *
+ * The IPAModuleCache stores the results of those operations in a file, and
+ * makes them available to subsequent processes. Each entry is keyed by the
+ * path of the IPA module and identified by the device, inode, size,
+ * modification time and status change time of the file. The last one can't be
+ * set from userspace, so any modification of the file, even in place,
+ * invalidates its entry. Signature check results are additionally only valid
+ * for the exact signature data that was verified, and for the libcamera
+ * version that performed the verification.
+ *
+ * As signature check results decide whether an IPA module is isolated or not,
+ * the cache file is ignored if it isn't owned by the effective user of the
+ * process, or is writable by other users.
+ */
+
+/**
+ * \brief Create an IPA module cache backed by the file at \a path
+ * \param[in] path The path to the cache file
+ *
+ * The cache contents are loaded from \a path if the file exists and is valid.
+ * An empty \a path creates an empty cache that is never saved.
+ */
+IPAModuleCache::IPAModuleCache(const std::string &path)
+	: path_(path), dirty_(false), hits_(0), misses_(0)
+{
+	if (path_.empty())
+		return;
+
+	int ret = load();
+	if (ret < 0 && ret != -ENOENT)
+		LOG(IPAManager, Debug)
+			<< "Ignoring IPA module cache " << path_ << ": "
+			<< strerror(-ret);
+}
+
+/**
+ * \brief Destroy the IPA module cache, saving it if it has been modified
+ */
+IPAModuleCache::~IPAModuleCache()
+{
+	save();
+}
+
+/**
+ * \brief Retrieve the default location of the cache file
+ *
+ * The cache file location can be set with the LIBCAMERA_IPA_MODULE_CACHE
+ * environment variable. Setting it to an empty string disables the cache.
+ * Otherwise the cache is stored in the libcamera directory of the XDG user
+ * cache directory.
+ *
+ * \return The path to the cache file, or an empty string if the cache is
+ * disabled
+ */
+std::string IPAModuleCache::defaultPath()
+{
+	const char *path = utils::secure_getenv("LIBCAMERA_IPA_MODULE_CACHE");
+	if (path)
+		return path;
+
+	const char *cacheHome = utils::secure_getenv("XDG_CACHE_HOME");
+	if (cacheHome && cacheHome[0] == '/')
+		return std::string(cacheHome) + "/libcamera/ipa_modules.cache";
+
+	const char *home = utils::secure_getenv("HOME");
+	if (home && home[0] == '/')
+		return std::string(home) + "/.cache/libcamera/ipa_modules.cache";
+
+	return {};
+}
+
+/**
+ * \fn IPAModuleCache::path()
+ * \brief Retrieve the path to the cache file
+ * \return The path to the cache file
+ */
+
+/**
+ * \brief Retrieve the cached information of an IPA module
+ * \param[in] modulePath The path to the IPA module shared object
+ * \param[out] info The IPA module information
+ *
+ * \return True if the cache contains valid information for the IPA module, in
+ * which case it is stored in \a info, or false otherwise
+ */
+bool IPAModuleCache::moduleInfo(const std::string &modulePath,
+				IPAModuleInfo *info)
+{
+	Entry *entry = lookup(modulePath);
+	if (!entry || !entry->hasInfo) {
+		misses_++;
+		return false;
+	}
+
+	*info = entry->info;
+	hits_++;
+	return true;
+}
+
+/**
+ * \brief Store the information of an IPA module in the cache
+ * \param[in] modulePath The path to the IPA module shared object
+ * \param[in] info The IPA module information
+ *
+ * The \a info is expected to have been parsed from the IPA module after a
+ * failed call to moduleInfo(). If the file has been modified since that call,
+ * the information isn't stored.
+ */
+void IPAModuleCache::setModuleInfo(const std::string &modulePath,
+				   const IPAModuleInfo &info)
+{
+	Entry *entry = update(modulePath);
+	if (!entry)
+		return;
+
+	entry->hasInfo = true;
+	entry->info = info;
+	dirty_ = true;
+}
+
+/**
+ * \brief Retrieve the cached result of an IPA module signature check
+ * \param[in] modulePath The path to the IPA module shared object
+ * \param[in] signature The IPA module signature
+ *
+ * \return The result of the signature check if cached for the IPA module and
+ * \a signature, or std::nullopt otherwise
+ */
+std::optional<bool> IPAModuleCache::signatureValid(const std::string &modulePath,
+						   Span<const uint8_t> signature)
+{
+	Entry *entry = lookup(modulePath);
+	if (!entry || !entry->hasSignature ||
+	    !std::equal(signature.begin(), signature.end(),
+			entry->signature.begin(), entry->signature.end())) {
+		misses_++;
+		return std::nullopt;
+	}
+
+	hits_++;
+	return entry->signatureValid;
+}
+
+/**
+ * \brief Store the result of an IPA module signature check in the cache
+ * \param[in] modulePath The path to the IPA module shared object
+ * \param[in] signature The IPA module signature that has been verified
+ * \param[in] valid The result of the signature check
+ *
+ * The signature check is expected to have been performed after a failed call
+ * to signatureValid(). If the file has been modified since that call, the
+ * result isn't stored.
+ */
+void IPAModuleCache::setSignatureValid(const std::string &modulePath,
+				       Span<const uint8_t> signature, bool valid)
+{
+	Entry *entry = update(modulePath);
+	if (!entry)
+		return;
+
+	entry->hasSignature = true;
+	entry->signatureValid = valid;
+	entry->signature.assign(signature.begin(), signature.end());
+	dirty_ = true;
+}
+
+/**
+ * \brief Save the cache to its file if it has been modified
+ *
+ * Entries for IPA modules that don't exist anymore are dropped. The file is
+ * replaced atomically, so concurrent processes never read a partially written
+ * cache.
+ *
+ * \return 0 on success or if there was nothing to save, or a negative error
+ * code otherwise
+ */
+int IPAModuleCache::save()
+{
+	if (path_.empty() || !dirty_)
+		return 0;
+
+	dirty_ = false;
+
+	CacheFile::Writer writer;
+	writer.write(kCacheMagic);
+	writer.write(kCacheFormatVersion);
+	writer.writeString(CameraManager::version());
+
+	uint32_t count = 0;
+	for (auto it = entries_.begin(); it != entries_.end();) {
+		FileId id;
+		if (fileId(it->first, &id) < 0) {
+			it = entries_.erase(it);
+			continue;
+		}
+
+		count++;
+		++it;
+	}
+
+	writer.write(count);
+
+	for (const auto &[modulePath, entry] : entries_) {
+		uint8_t flags = (entry.hasInfo ? EntryHasInfo : 0)
+			      | (entry.hasSignature ? EntryHasSignature : 0)
+			      | (entry.signatureValid ? EntrySignatureValid : 0);
+
+		writer.writeString(modulePath);
+		writer.write(entry.id);
+		writer.write(flags);
+		writer.write(entry.info);
+		writer.writeBlob(entry.signature);
+	}
+
+	int ret = CacheFile::save(path_, writer.data());
+	if (ret < 0) {
+		LOG(IPAManager, Debug)
+			<< "Failed to save IPA module cache " << path_ << ": "
+			<< strerror(-ret);
+		return ret;
+	}
+
+	LOG(IPAManager, Debug)
+		<< "Saved " << count << " entries to IPA module cache " << path_;
+
+	return 0;
+}
+
+/**
+ * \fn IPAModuleCache::hits()
+ * \brief Retrieve the number of lookups that were answered from the cache
+ * \return The number of cache hits
+ */
+
+/**
+ * \fn IPAModuleCache::misses()
+ * \brief Retrieve the number of lookups that were not answered from the cache
+ * \return The number of cache misses
+ */
+
+bool IPAModuleCache::FileId::operator==(const FileId &other) const
+{
+	return dev == other.dev && ino == other.ino && size == other.size &&
+	       mtime == other.mtime && ctime == other.ctime;
+}
+
+int IPAModuleCache::fileId(const std::string &path, FileId *id)
+{
+	struct stat st;
+	if (stat(path.c_str(), &st) < 0)
+		return -errno;
+
+	id->dev = st.st_dev;
+	id->ino = st.st_ino;
+	id->size = st.st_size;
+	id->mtime = st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+	id->ctime = st.st_ctim.tv_sec * 1000000000LL + st.st_ctim.tv_nsec;
+
+	return 0;
+}
+
+int IPAModuleCache::load()
+{
+	std::vector<uint8_t> data;
+	int ret = CacheFile::load(path_, &data);
+	if (ret < 0)
+		return ret;
+
+	CacheFile::Reader reader(data);
+
+	char magic[sizeof(kCacheMagic)];
+	uint32_t formatVersion;
+	std::string version;
+	uint32_t count;
+
+	if (!reader.read(&magic) || memcmp(magic, kCacheMagic, sizeof(magic)) ||
+	    !reader.read(&formatVersion) || formatVersion != kCacheFormatVersion ||
+	    !reader.readString(&version) || version != CameraManager::version() ||
+	    !reader.read(&count))
+		return -EINVAL;
+
+	std::map<std::string, Entry> entries;
+
+	for (uint32_t i = 0; i < count; ++i) {
+		std::string modulePath;
+		Entry entry{};
+		uint8_t flags;
+
+		if (!reader.readString(&modulePath) || !reader.read(&entry.id) ||
+		    !reader.read(&flags) || !reader.read(&entry.info) ||
+		    !reader.readBlob(&entry.signature))
+			return -EINVAL;
+
+		entry.hasInfo = flags & EntryHasInfo;
+		entry.hasSignature = flags & EntryHasSignature;
+		entry.signatureValid = flags & EntrySignatureValid;
+
+		/* Make sure the strings are null-terminated. */
+		entry.info.pipelineName[sizeof(entry.info.pipelineName) - 1] = '\0';
+		entry.info.name[sizeof(entry.info.name) - 1] = '\0';
+
+		entries[modulePath] = std::move(entry);
+	}
+
+	if (!reader.atEnd())
+		return -EINVAL;
+
+	entries_ = std::move(entries);
+
+	LOG(IPAManager, Debug)
+		<< "Loaded " << entries_.size() << " entries from IPA module cache "
+		<< path_;
+
+	return 0;
+}
+
+/*
+ * Find the entry for \a modulePath, creating or resetting it if it doesn't
+ * match the current state of the file. Return nullptr if the file can't be
+ * accessed.
+ */
+IPAModuleCache::Entry *IPAModuleCache::lookup(const std::string &modulePath)
+{
+	FileId id;
+	if (fileId(modulePath, &id) < 0)
+		return nullptr;
+
+	auto it = entries_.find(modulePath);
+	if (it != entries_.end() && it->second.id == id)
+		return &it->second;
+
+	Entry &entry = entries_[modulePath];
+	entry = {};
+	entry.id = id;
+	dirty_ = true;
+
+	return &entry;
+}
+
+/*
+ * Find the entry for \a modulePath to update it, if the file hasn't been
+ * modified since the entry was looked up. Otherwise drop the entry, as the
+ * data computed by the caller may not correspond to the current file.
+ */
+IPAModuleCache::Entry *IPAModuleCache::update(const std::string &modulePath)
+{
+	auto it = entries_.find(modulePath);
+	if (it == entries_.end())
+		return nullptr;
+
+	FileId id;
+	if (fileId(modulePath, &id) < 0 || id != it->second.id) {
+		entries_.erase(it);
+		dirty_ = true;
+		return nullptr;
+	}
+
+	return &it->second;
+}
+
+} /* namespace libcamera */
@@ -0,0 +1,236 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+/*
+ * Copyright (C) 2026, Ideas on Board Oy
+ *
+ * ipa_proxy_worker_pool.cpp - Pool of pre-spawned IPA proxy workers
+ */
+
+#include "libcamera/internal/ipa_proxy_worker_pool.h"
+
+#include <vector>
+
+#include <libcamera/base/log.h>
+#include <libcamera/base/unique_fd.h>
+
+/**
+ * \file ipa_proxy_worker_pool.h
+ * \brief Pool of pre-spawned IPA proxy workers
+ */
+
+namespace libcamera {
+
+LOG_DECLARE_CATEGORY(IPCPipe)
+
+/**
+ * \class IPAProxyWorkerPool
+ * \brief Keep IPA proxy worker processes ready for isolated IPA modules
+ *
+ * Creating a proxy for an isolated IPA module spawns a proxy worker process,
+ * which then has to load the IPA module and bind its IPC socket before it can
+ * process the first call. This adds a noticeable latency to the creation of
+ * every IPA context.
+ *
+ * The IPAProxyWorkerPool hides that latency by keeping up to size() idle
+ * workers ready for each pair of IPA module and proxy worker executable. The
+ * pool learns about the pairs it has to serve when acquire() is first called
+ * for them: the first acquisition spawns a worker synchronously, and all
+ * subsequent acquisitions are served from the pool, which is topped up right
+ * after handing a worker out. The workers spawned for refilling the pool
+ * initialize in parallel with the caller, and are typically ready by the time
+ * they are needed.
+ *
+ * The pool is optional. It is instantiated by the IPAManager when requested
+ * through the LIBCAMERA_IPA_PROXY_POOL_SIZE environment variable, and is
+ * retrieved by the IPC pipe through instance().
+ */
+
+/**
+ * \struct IPAProxyWorkerPool::Worker
+ * \brief A spawned proxy worker process and its IPC socket
+ *
+ * \var IPAProxyWorkerPool::Worker::process
+ * \brief The proxy worker process
+ *
+ * \var IPAProxyWorkerPool::Worker::socket
+ * \brief The IPC socket connected to the proxy worker process
+ */
+
+IPAProxyWorkerPool *IPAProxyWorkerPool::self_ = nullptr;
+
+/**
+ * \brief Construct an IPAProxyWorkerPool instance
+ * \param[in] size The number of idle workers to keep per IPA module
+ *
+ * Only one pool can exist at a time. It is meant to be instantiated by the
+ * IPAManager.
+ */
+IPAProxyWorkerPool::IPAProxyWorkerPool(unsigned int size)
+	: size_(size), hits_(0), misses_(0)
+{
+	if (self_)
+		LOG(IPCPipe, Fatal)
+			<< "Multiple IPAProxyWorkerPool objects are not allowed";
+
+	self_ = this;
+}
+
+/**
+ * \brief Destroy the IPAProxyWorkerPool instance
+ *
+ * Idle workers are terminated.
+ */
+IPAProxyWorkerPool::~IPAProxyWorkerPool()
+{
+	self_ = nullptr;
+}
+
+/**
+ * \brief Retrieve the IPA proxy worker pool instance
+ * \return The IPA proxy worker pool instance, or nullptr if the pool is
+ * disabled
+ */
+IPAProxyWorkerPool *IPAProxyWorkerPool::instance()
+{
+	return self_;
+}
+
+/**
+ * \brief Spawn a proxy worker process
+ * \param[in] modulePath Path to the IPA module shared object
+ * \param[in] workerPath Path to the proxy worker executable
+ *
+ * Create an IPC socket and start the proxy worker \a workerPath for the IPA
+ * module \a modulePath, passing it the other end of the socket.
+ *
+ * \return The spawned worker, or nullptr if an error occurred
+ */
+std::unique_ptr<IPAProxyWorkerPool::Worker>
+IPAProxyWorkerPool::spawn(const std::string &modulePath,
+			  const std::string &workerPath)
+{
+	std::unique_ptr<Worker> worker = std::make_unique<Worker>();
+
+	worker->socket = std::make_unique<IPCUnixSocket>();
+	UniqueFD fd = worker->socket->create();
+	if (!fd.isValid()) {
+		LOG(IPCPipe, Error) << "Failed to create socket";
+		return nullptr;
+	}
+
+	std::vector<std::string> args = { modulePath, std::to_string(fd.get()) };
+	std::vector<int> fds = { fd.get() };
+
+	worker->process = std::make_unique<Process>();
+	int ret = worker->process->start(workerPath, args, fds);
+	if (ret) {
+		LOG(IPCPipe, Error)
+			<< "Failed to start proxy worker process";
+		return nullptr;
+	}
+
+	return worker;
+}
+
+/**
+ * \brief Acquire a proxy worker process
+ * \param[in] modulePath Path to the IPA module shared object
+ * \param[in] workerPath Path to the proxy worker executable
+ *
+ * Retrieve an idle worker for the IPA module \a modulePath from the pool, or
+ * spawn a new one if none is available, and refill the pool to its target
+ * size. Ownership of the worker is transferred to the caller.
+ *
+ * \return The acquired worker, or nullptr if an error occurred
+ */
+std::unique_ptr<IPAProxyWorkerPool::Worker>
+IPAProxyWorkerPool::acquire(const std::string &modulePath,
+			    const std::string &workerPath)
+{
+	MutexLocker locker(mutex_);
+
+	std::deque<std::unique_ptr<Worker>> &workers =
+		workers_[{ modulePath, workerPath }];
+	std::unique_ptr<Worker> worker;
+
+	/* Skip workers that died while waiting in the pool. */
+	while (!workers.empty() && !worker) {
+		worker = std::move(workers.front());
+		workers.pop_front();
+
+		if (worker->process->exitStatus() != Process::NotExited) {
+			LOG(IPCPipe, Warning)
+				<< "Discarding dead proxy worker for "
+				<< modulePath;
+			worker.reset();
+		}
+	}
+
+	if (worker) {
+		hits_++;
+	} else {
+		misses_++;
+		worker = spawn(modulePath, workerPath);
+		if (!worker)
+			return nullptr;
+	}
+
+	while (workers.size() < size_) {
+		std::unique_ptr<Worker> spare = spawn(modulePath, workerPath);
+		if (!spare)
+			break;
+
+		workers.push_back(std::move(spare));
+	}
+
+	LOG(IPCPipe, Debug)
+		<< "Acquired proxy worker for " << modulePath << " ("
+		<< hits_ << " hits, " << misses_ << " misses)";
+
+	return worker;
+}
+
+/**
+ * \brief Retrieve the number of idle workers for an IPA module
+ * \param[in] modulePath Path to the IPA module shared object
+ * \return The number of idle workers available for \a modulePath
+ */
+unsigned int IPAProxyWorkerPool::available(const std::string &modulePath) const
+{
+	MutexLocker locker(mutex_);
+
+	unsigned int count = 0;
+	for (const auto &[key, workers] : workers_) {
+		if (key.first == modulePath)
+			count += workers.size();
+	}
+
+	return count;
+}
+
+/**
+ * \fn IPAProxyWorkerPool::size()
+ * \brief Retrieve the number of idle workers kept ready per IPA module
+ * \return The target number of idle workers per IPA module
+ */
+
+/**
+ * \brief Retrieve the number of acquisitions served by an idle worker
+ * \return The number of pool hits
+ */
+unsigned int IPAProxyWorkerPool::hits() const
+{
+	MutexLocker locker(mutex_);
+	return hits_;
+}
+
+/**
+ * \brief Retrieve the number of acquisitions that had to spawn a worker
+ * \return The number of pool misses
+ */
+unsigned int IPAProxyWorkerPool::misses() const
+{
+	MutexLocker locker(mutex_);
+	return misses_;
+}
+
+} /* namespace libcamera */
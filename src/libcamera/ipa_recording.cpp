@@ -0,0 +1,98 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+/*
+ * Copyright (C) 2026, Ideas on Board Oy
+ *
+ * ipa_recording.cpp - IPA interface recording format
+ */
+
+#include "libcamera/internal/ipa_recording.h"
+
+/**
+ * \file ipa_recording.h
+ * \brief Type definitions for IPA interface recordings
+ *
+ * IPA modules may record the calls they receive through their interface, along
+ * with the statistics buffers they process, to a file. The recording can then
+ * be replayed offline against the same or a different build of the IPA module,
+ * without any camera hardware, to benchmark the algorithms or compare their
+ * output across versions.
+ *
+ * A recording starts with an ipa_recording_header, followed by a sequence of
+ * records. Each record starts with an ipa_record_header that identifies the
+ * interface call and its frame number, followed by ipa_record_header::size
+ * bytes of payload. The payload is a sequence of chunks, each made of a 32-bit
+ * size in bytes followed by the chunk data. The chunks store the call
+ * arguments serialized with the IPADataSerializer, or raw buffer contents,
+ * depending on the record type. All integers are stored in the platform's
+ * native format, recordings are thus not portable across architectures.
+ *
+ * A single ControlSerializer serializes all the controls of a recording. It is
+ * reset at the beginning of every IPA_RECORD_INIT and IPA_RECORD_CONFIGURE
+ * record, and players shall reset their deserializer at the same points.
+ */
+
+namespace libcamera {
+
+/**
+ * \def IPA_RECORDING_FORMAT_VERSION
+ * \brief The current recording format version
+ */
+
+/**
+ * \def IPA_RECORDING_MAGIC
+ * \brief The magic string that starts all recordings
+ */
+
+/**
+ * \enum ipa_record_type
+ * \brief Type of a record, identifying the IPA interface call it stores
+ * \var IPA_RECORD_INIT
+ * The init() call. The payload stores the IPASettings, the hardware revision,
+ * the IPACameraSensorInfo and the sensor ControlInfoMap
+ * \var IPA_RECORD_CONFIGURE
+ * The configure() call. The payload stores the pipeline-specific configuration
+ * information and the stream configuration map
+ * \var IPA_RECORD_START
+ * The start() call, without payload
+ * \var IPA_RECORD_STOP
+ * The stop() call, without payload
+ * \var IPA_RECORD_QUEUE_REQUEST
+ * The queueRequest() call. The payload stores the request controls
+ * \var IPA_RECORD_FILL_PARAMS
+ * The fillParamsBuffer() call, without payload
+ * \var IPA_RECORD_PROCESS_STATS
+ * The processStatsBuffer() call. The payload stores the contents of the
+ * statistics buffer and the sensor controls
+ */
+
+/**
+ * \struct ipa_recording_header
+ * \brief Header of an IPA interface recording
+ * \var ipa_recording_header::magic
+ * The IPA_RECORDING_MAGIC string, not null-terminated
+ * \var ipa_recording_header::version
+ * The recording format version (IPA_RECORDING_FORMAT_VERSION)
+ * \var ipa_recording_header::pipeline
+ * The null-terminated name of the IPA module that produced the recording
+ */
+
+static_assert(sizeof(ipa_recording_header) == 32,
+	      "Invalid ABI size change for struct ipa_recording_header");
+
+/**
+ * \struct ipa_record_header
+ * \brief Header of a record in an IPA interface recording
+ * \var ipa_record_header::type
+ * The record type (defined by enum ipa_record_type)
+ * \var ipa_record_header::frame
+ * The frame number passed to the interface call, or 0 if not applicable
+ * \var ipa_record_header::size
+ * The size of the record payload in bytes, excluding the header
+ * \var ipa_record_header::reserved
+ * Reserved for future use (shall be set to 0)
+ */
+
+static_assert(sizeof(ipa_record_header) == 16,
+	      "Invalid ABI size change for struct ipa_record_header");
+
+} /* namespace libcamera */
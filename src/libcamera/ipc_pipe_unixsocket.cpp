@@ -7,13 +7,12 @@
 
 #include "libcamera/internal/ipc_pipe_unixsocket.h"
 
-#include <vector>
-
 #include <libcamera/base/event_dispatcher.h>
 #include <libcamera/base/log.h>
 #include <libcamera/base/thread.h>
 #include <libcamera/base/timer.h>
 
+#include "libcamera/internal/ipa_proxy_worker_pool.h"
 #include "libcamera/internal/ipc_pipe.h"
 #include "libcamera/internal/ipc_unixsocket.h"
 #include "libcamera/internal/process.h"
@@ -28,27 +27,17 @@ IPCPipeUnixSocket::IPCPipeUnixSocket(const char *ipaModulePath,
 				     const char *ipaProxyWorkerPath)
 	: IPCPipe()
 {
-	std::vector<int> fds;
-	std::vector<std::string> args;
-	args.push_back(ipaModulePath);
-
-	socket_ = std::make_unique<IPCUnixSocket>();
-	UniqueFD fd = socket_->create();
-	if (!fd.isValid()) {
-		LOG(IPCPipe, Error) << "Failed to create socket";
+	/* Use a pre-spawned worker if the pool is enabled. */
+	IPAProxyWorkerPool *pool = IPAProxyWorkerPool::instance();
+	std::unique_ptr<IPAProxyWorkerPool::Worker> worker =
+		pool ? pool->acquire(ipaModulePath, ipaProxyWorkerPath)
+		     : IPAProxyWorkerPool::spawn(ipaModulePath, ipaProxyWorkerPath);
+	if (!worker)
 		return;
-	}
-	socket_->readyRead.connect(this, &IPCPipeUnixSocket::readyRead);
-	args.push_back(std::to_string(fd.get()));
-	fds.push_back(fd.get());
 
-	proc_ = std::make_unique<Process>();
-	int ret = proc_->start(ipaProxyWorkerPath, args, fds);
-	if (ret) {
-		LOG(IPCPipe, Error)
-			<< "Failed to start proxy worker process";
-		return;
-	}
+	proc_ = std::move(worker->process);
+	socket_ = std::move(worker->socket);
+	socket_->readyRead.connect(this, &IPCPipeUnixSocket::readyRead);
 
 	connected_ = true;
 }
@@ -186,7 +186,8 @@ void MediaDevice::unlock()
  *
  * Entities are stored in a separate list in the MediaDevice to ease lookup,
  * while pads are accessible from the entity they belong to and links from the
- * pads they connect.
+ * pads they connect. The entities are additionally indexed by name and by
+ * function, to speed up lookups on large media graphs.
  *
  * \return 0 on success or a negative error code otherwise
  */
@@ -333,11 +334,31 @@ done:
  */
 MediaEntity *MediaDevice::getEntityByName(const std::string &name) const
 {
-	for (MediaEntity *e : entities_)
-		if (e->name() == name)
-			return e;
+	auto it = entitiesByName_.find(name);
+	if (it == entitiesByName_.end())
+		return nullptr;
 
-	return nullptr;
+	return it->second;
+}
+
+/**
+ * \brief Retrieve the entities that implement a function
+ * \param[in] function The entity function (MEDIA_ENT_F_*)
+ *
+ * The entities are returned in the same order as in the entities() list.
+ *
+ * \return The list of entities whose function is \a function
+ */
+const std::vector<MediaEntity *> &
+MediaDevice::entitiesByFunction(unsigned int function) const
+{
+	static const std::vector<MediaEntity *> empty;
+
+	auto it = entitiesByFunction_.find(function);
+	if (it == entitiesByFunction_.end())
+		return empty;
+
+	return it->second;
 }
 
 /**
@@ -566,6 +587,8 @@ void MediaDevice::clear()
 
 	objects_.clear();
 	entities_.clear();
+	entitiesByName_.clear();
+	entitiesByFunction_.clear();
 	valid_ = false;
 }
 
@@ -646,6 +669,8 @@ bool MediaDevice::populateEntities(const struct media_v2_topology &topology)
 		}
 
 		entities_.push_back(entity);
+		entitiesByName_.emplace(entity->name(), entity);
+		entitiesByFunction_[entity->function()].push_back(entity);
 	}
 
 	return true;
@@ -148,6 +148,9 @@ public:
 
 	bool match(DeviceEnumerator *enumerator) override;
 
+protected:
+	int acquireDevice(Camera *camera) override;
+
 private:
 	IPU3CameraData *cameraData(Camera *camera)
 	{
@@ -1066,9 +1069,16 @@ int PipelineHandlerIPU3::registerCameras()
 		if (ret)
 			continue;
 
-		ret = data->loadIPA();
-		if (ret)
-			continue;
+		/*
+		 * In lazy initialization mode, the IPA is loaded in
+		 * acquireDevice(), and the IPA controls are only reported once
+		 * it has been loaded.
+		 */
+		if (!lazyCameraInit()) {
+			ret = data->loadIPA();
+			if (ret)
+				continue;
+		}
 
 		/* Initialize the camera properties. */
 		data->properties_ = cio2->sensor()->properties();
@@ -1149,6 +1159,22 @@ int PipelineHandlerIPU3::registerCameras()
 	return numCameras ? 0 : -ENODEV;
 }
 
+int PipelineHandlerIPU3::acquireDevice(Camera *camera)
+{
+	IPU3CameraData *data = cameraData(camera);
+
+	if (data->ipa_)
+		return 0;
+
+	int ret = data->loadIPA();
+	if (ret) {
+		data->ipa_.reset();
+		return ret;
+	}
+
+	return initControls(data);
+}
+
 int IPU3CameraData::loadIPA()
 {
 	ipa_ = IPAManager::createIPA<ipa::ipu3::IPAProxyIPU3>(pipe(), 1, 1);
@@ -1323,6 +1349,8 @@ void IPU3CameraData::cio2BufferReady(FrameBuffer *buffer)
 	 */
 	request->metadata().set(controls::SensorTimestamp,
 				buffer->metadata().timestamp);
+	request->metadata().set(controls::FrameSequence,
+				buffer->metadata().sequence);
 
 	info->effectiveSensorControls = delayedCtrls_->get(buffer->metadata().sequence);
 
@@ -1390,6 +1418,7 @@ void IPU3CameraData::statBufferReady(FrameBuffer *buffer)
  */
 void IPU3CameraData::frameStart(uint32_t sequence)
 {
+	frameTiming_.frameStarted(sequence, utils::clock::now());
 	delayedCtrls_->applyControls(sequence);
 
 	if (processingRequests_.empty())
@@ -10,6 +10,7 @@
 #include <iomanip>
 #include <memory>
 #include <numeric>
+#include <optional>
 #include <queue>
 
 #include <linux/media-bus-format.h>
@@ -32,6 +33,7 @@
 #include <libcamera/ipa/rkisp1_ipa_proxy.h>
 
 #include "libcamera/internal/camera.h"
+#include "libcamera/internal/camera_configuration_cache.h"
 #include "libcamera/internal/camera_sensor.h"
 #include "libcamera/internal/delayed_controls.h"
 #include "libcamera/internal/device_enumerator.h"
@@ -109,6 +111,16 @@ public:
 
 	std::unique_ptr<ipa::rkisp1::IPAProxyRkISP1> ipa_;
 
+	struct ValidationResult {
+		CameraConfiguration::Status status;
+		std::vector<StreamConfiguration> config;
+		Transform transform;
+		V4L2SubdeviceFormat sensorFormat;
+		Transform combinedTransform;
+	};
+
+	mutable CameraConfigurationCache<ValidationResult> validationCache_;
+
 private:
 	void paramFilled(unsigned int frame);
 	void setSensorControls(unsigned int frame,
@@ -128,6 +140,7 @@ public:
 	const Transform &combinedTransform() { return combinedTransform_; }
 
 private:
+	Status validateConfiguration();
 	bool fitsAllPaths(const StreamConfiguration &cfg);
 
 	/*
@@ -161,6 +174,10 @@ public:
 
 	bool match(DeviceEnumerator *enumerator) override;
 
+protected:
+	int acquireDevice(Camera *camera) override;
+	void releaseDevice(Camera *camera) override;
+
 private:
 	static constexpr Size kRkISP1PreviewSize = { 1920, 1080 };
 
@@ -201,6 +218,11 @@ private:
 	std::queue<FrameBuffer *> availableParamBuffers_;
 	std::queue<FrameBuffer *> availableStatBuffers_;
 
+	/*
+	 * The camera whose IPA the internal buffers are mapped to. The buffers
+	 * are kept allocated when the camera is stopped.
+	 */
+	Camera *buffersCamera_;
 	Camera *activeCamera_;
 
 	const MediaPad *ispSink_;
@@ -262,8 +284,10 @@ int RkISP1Frames::destroy(unsigned int frame)
 	if (!info)
 		return -ENOENT;
 
-	pipe_->availableParamBuffers_.push(info->paramBuffer);
-	pipe_->availableStatBuffers_.push(info->statBuffer);
+	if (info->paramBuffer)
+		pipe_->availableParamBuffers_.push(info->paramBuffer);
+	if (info->statBuffer)
+		pipe_->availableStatBuffers_.push(info->statBuffer);
 
 	frameInfo_.erase(info->frame);
 
@@ -277,8 +301,10 @@ void RkISP1Frames::clear()
 	for (const auto &entry : frameInfo_) {
 		RkISP1FrameInfo *info = entry.second;
 
-		pipe_->availableParamBuffers_.push(info->paramBuffer);
-		pipe_->availableStatBuffers_.push(info->statBuffer);
+		if (info->paramBuffer)
+			pipe_->availableParamBuffers_.push(info->paramBuffer);
+		if (info->statBuffer)
+			pipe_->availableStatBuffers_.push(info->statBuffer);
 
 		delete info;
 	}
@@ -465,6 +491,29 @@ bool RkISP1CameraConfiguration::fitsAllPaths(const StreamConfiguration &cfg)
 }
 
 CameraConfiguration::Status RkISP1CameraConfiguration::validate()
+{
+	CameraConfigurationKey key(*this);
+
+	std::optional<RkISP1CameraData::ValidationResult> result =
+		data_->validationCache_.find(key);
+	if (result) {
+		config_ = std::move(result->config);
+		transform = result->transform;
+		sensorFormat_ = result->sensorFormat;
+		combinedTransform_ = result->combinedTransform;
+		return result->status;
+	}
+
+	Status status = validateConfiguration();
+	if (status != Invalid)
+		data_->validationCache_.insert(key, { status, config_, transform,
+						      sensorFormat_,
+						      combinedTransform_ });
+
+	return status;
+}
+
+CameraConfiguration::Status RkISP1CameraConfiguration::validateConfiguration()
 {
 	const CameraSensor *sensor = data_->sensor_.get();
 	unsigned int pathCount = data_->selfPath_ ? 2 : 1;
@@ -605,7 +654,7 @@ CameraConfiguration::Status RkISP1CameraConfiguration::validate()
  */
 
 PipelineHandlerRkISP1::PipelineHandlerRkISP1(CameraManager *manager)
-	: PipelineHandler(manager), hasSelfPath_(true)
+	: PipelineHandler(manager), hasSelfPath_(true), buffersCamera_(nullptr)
 {
 }
 
@@ -801,17 +850,24 @@ int PipelineHandlerRkISP1::configure(Camera *camera, CameraConfiguration *c)
 			return ret;
 	}
 
-	V4L2DeviceFormat paramFormat;
-	paramFormat.fourcc = V4L2PixelFormat(V4L2_META_FMT_RK_ISP1_PARAMS);
-	ret = param_->setFormat(&paramFormat);
-	if (ret)
-		return ret;
+	/*
+	 * The parameters and statistics formats never change. Their buffers
+	 * may still be allocated from a previous capture session, in which
+	 * case the formats are set already and can't be set again.
+	 */
+	if (!buffersCamera_) {
+		V4L2DeviceFormat paramFormat;
+		paramFormat.fourcc = V4L2PixelFormat(V4L2_META_FMT_RK_ISP1_PARAMS);
+		ret = param_->setFormat(&paramFormat);
+		if (ret)
+			return ret;
 
-	V4L2DeviceFormat statFormat;
-	statFormat.fourcc = V4L2PixelFormat(V4L2_META_FMT_RK_ISP1_STAT_3A);
-	ret = stat_->setFormat(&statFormat);
-	if (ret)
-		return ret;
+		V4L2DeviceFormat statFormat;
+		statFormat.fourcc = V4L2PixelFormat(V4L2_META_FMT_RK_ISP1_STAT_3A);
+		ret = stat_->setFormat(&statFormat);
+		if (ret)
+			return ret;
+	}
 
 	/* Inform IPA of stream configuration and sensor controls. */
 	ipa::rkisp1::IPAConfigInfo ipaConfig{};
@@ -855,6 +911,17 @@ int PipelineHandlerRkISP1::allocateBuffers(Camera *camera)
 		data->selfPathStream_.configuration().bufferCount,
 	});
 
+	/*
+	 * Reuse the buffers allocated for a previous capture session if they
+	 * match the current configuration.
+	 */
+	if (buffersCamera_ == camera &&
+	    paramBuffers_.size() == (isRaw_ ? 0 : maxCount))
+		return 0;
+
+	if (buffersCamera_)
+		freeBuffers(buffersCamera_);
+
 	if (!isRaw_) {
 		ret = param_->allocateBuffers(maxCount, &paramBuffers_);
 		if (ret < 0)
@@ -880,6 +947,7 @@ int PipelineHandlerRkISP1::allocateBuffers(Camera *camera)
 	}
 
 	data->ipa_->mapBuffers(data->ipaBuffers_);
+	buffersCamera_ = camera;
 
 	return 0;
 
@@ -916,6 +984,8 @@ int PipelineHandlerRkISP1::freeBuffers(Camera *camera)
 	if (stat_->releaseBuffers())
 		LOG(RkISP1, Error) << "Failed to release stat buffers";
 
+	buffersCamera_ = nullptr;
+
 	return 0;
 }
 
@@ -924,7 +994,7 @@ int PipelineHandlerRkISP1::start(Camera *camera, [[maybe_unused]] const ControlL
 	RkISP1CameraData *data = cameraData(camera);
 	int ret;
 
-	/* Allocate buffers for internal pipeline usage. */
+	/* Allocate buffers for internal pipeline usage, or reuse them. */
 	ret = allocateBuffers(camera);
 	if (ret)
 		return ret;
@@ -989,6 +1059,20 @@ int PipelineHandlerRkISP1::start(Camera *camera, [[maybe_unused]] const ControlL
 	return ret;
 }
 
+int PipelineHandlerRkISP1::acquireDevice(Camera *camera)
+{
+	RkISP1CameraData *data = cameraData(camera);
+
+	if (data->ipa_)
+		return 0;
+
+	int ret = data->loadIPA(media_->hwRevision());
+	if (ret)
+		data->ipa_.reset();
+
+	return ret;
+}
+
 void PipelineHandlerRkISP1::stopDevice(Camera *camera)
 {
 	RkISP1CameraData *data = cameraData(camera);
@@ -1017,11 +1101,21 @@ void PipelineHandlerRkISP1::stopDevice(Camera *camera)
 	ASSERT(data->queuedRequests_.empty());
 	data->frameInfo_.clear();
 
-	freeBuffers(camera);
+	/*
+	 * Keep the internal buffers allocated and mapped to the IPA, to speed
+	 * up restarting the camera. They are freed when the camera is
+	 * released, or reallocated when the configuration requires it.
+	 */
 
 	activeCamera_ = nullptr;
 }
 
+void PipelineHandlerRkISP1::releaseDevice(Camera *camera)
+{
+	if (buffersCamera_ == camera)
+		freeBuffers(camera);
+}
+
 int PipelineHandlerRkISP1::queueRequestDevice(Camera *camera, Request *request)
 {
 	RkISP1CameraData *data = cameraData(camera);
@@ -1135,9 +1229,12 @@ int PipelineHandlerRkISP1::createCamera(MediaEntity *sensor)
 	isp_->frameStart.connect(data->delayedCtrls_.get(),
 				 &DelayedControls::applyControls);
 
-	ret = data->loadIPA(media_->hwRevision());
-	if (ret)
-		return ret;
+	/* In lazy initialization mode, the IPA is loaded in acquireDevice(). */
+	if (!lazyCameraInit()) {
+		ret = data->loadIPA(media_->hwRevision());
+		if (ret)
+			return ret;
+	}
 
 	std::set<Stream *> streams{
 		&data->mainPathStream_,
@@ -1179,6 +1276,8 @@ bool PipelineHandlerRkISP1::match(DeviceEnumerator *enumerator)
 	if (isp_->open() < 0)
 		return false;
 
+	isp_->frameStart.connect(this, &PipelineHandlerRkISP1::frameStart);
+
 	/* Locate and open the optional CSI-2 receiver. */
 	ispSink_ = isp_->entity()->getPadByIndex(0);
 	if (!ispSink_ || ispSink_->links().empty())
@@ -1253,6 +1352,15 @@ void PipelineHandlerRkISP1::tryCompleteRequest(RkISP1FrameInfo *info)
 	completeRequest(request);
 }
 
+void PipelineHandlerRkISP1::frameStart(uint32_t sequence)
+{
+	if (!activeCamera_)
+		return;
+
+	RkISP1CameraData *data = cameraData(activeCamera_);
+	data->frameTiming_.frameStarted(sequence, utils::clock::now());
+}
+
 void PipelineHandlerRkISP1::bufferReady(FrameBuffer *buffer)
 {
 	ASSERT(activeCamera_);
@@ -1274,6 +1382,8 @@ void PipelineHandlerRkISP1::bufferReady(FrameBuffer *buffer)
 		 */
 		request->metadata().set(controls::SensorTimestamp,
 					metadata.timestamp);
+		request->metadata().set(controls::FrameSequence,
+					metadata.sequence);
 
 		if (isRaw_) {
 			const ControlList &ctrls =
@@ -174,6 +174,31 @@ CameraConfiguration::Status RPiCameraConfiguration::validateColorSpaces([[maybe_
 }
 
 CameraConfiguration::Status RPiCameraConfiguration::validate()
+{
+	CameraConfigurationKey key(*this);
+
+	std::optional<CameraData::ValidationResult> result =
+		data_->validationCache_.find(key);
+	if (result) {
+		config_ = std::move(result->config);
+		transform = result->transform;
+		combinedTransform_ = result->combinedTransform;
+		sensorFormat_ = result->sensorFormat;
+		yuvColorSpace_ = result->yuvColorSpace;
+		rgbColorSpace_ = result->rgbColorSpace;
+		return result->status;
+	}
+
+	Status status = validateConfiguration();
+	if (status != Invalid)
+		data_->validationCache_.insert(key, { status, config_, transform,
+						      combinedTransform_, sensorFormat_,
+						      yuvColorSpace_, rgbColorSpace_ });
+
+	return status;
+}
+
+CameraConfiguration::Status RPiCameraConfiguration::validateConfiguration()
 {
 	Status status = Valid;
 
@@ -19,6 +19,7 @@
 
 #include "libcamera/internal/bayer_format.h"
 #include "libcamera/internal/camera.h"
+#include "libcamera/internal/camera_configuration_cache.h"
 #include "libcamera/internal/camera_sensor.h"
 #include "libcamera/internal/framebuffer.h"
 #include "libcamera/internal/media_device.h"
@@ -186,6 +187,23 @@ public:
 
 	Config config_;
 
+	struct ValidationResult {
+		CameraConfiguration::Status status;
+		std::vector<StreamConfiguration> config;
+		Transform transform;
+		Transform combinedTransform;
+		V4L2SubdeviceFormat sensorFormat;
+		std::optional<ColorSpace> yuvColorSpace;
+		std::optional<ColorSpace> rgbColorSpace;
+	};
+
+	/*
+	 * Validation only depends on the requested configuration and on data
+	 * set at camera creation time, and is thus safe to cache in a const
+	 * object.
+	 */
+	mutable CameraConfigurationCache<ValidationResult> validationCache_;
+
 protected:
 	void fillRequestMetadata(const ControlList &bufferControls,
 				 Request *request);
@@ -266,6 +284,8 @@ public:
 	V4L2SubdeviceFormat sensorFormat_;
 
 private:
+	Status validateConfiguration();
+
 	const CameraData *data_;
 
 	/*
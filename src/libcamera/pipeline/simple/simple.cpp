@@ -11,6 +11,7 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <optional>
 #include <queue>
 #include <set>
 #include <string>
@@ -29,6 +30,7 @@
 #include <libcamera/stream.h>
 
 #include "libcamera/internal/camera.h"
+#include "libcamera/internal/camera_configuration_cache.h"
 #include "libcamera/internal/camera_sensor.h"
 #include "libcamera/internal/converter.h"
 #include "libcamera/internal/device_enumerator.h"
@@ -274,6 +276,17 @@ public:
 	bool useConverter_;
 	std::queue<std::map<unsigned int, FrameBuffer *>> converterQueue_;
 
+	struct ValidationResult {
+		CameraConfiguration::Status status;
+		std::vector<StreamConfiguration> config;
+		Transform transform;
+		const Configuration *pipeConfig;
+		bool needConversion;
+		Transform combinedTransform;
+	};
+
+	CameraConfigurationCache<ValidationResult> validationCache_;
+
 private:
 	void tryPipeline(unsigned int code, const Size &size);
 	static std::vector<const MediaPad *> routedSourcePads(MediaPad *sink);
@@ -298,6 +311,8 @@ public:
 	const Transform &combinedTransform() const { return combinedTransform_; }
 
 private:
+	Status validateConfiguration();
+
 	/*
 	 * The SimpleCameraData instance is guaranteed to be valid as long as
 	 * the corresponding Camera instance is valid. In order to borrow a
@@ -882,6 +897,30 @@ SimpleCameraConfiguration::SimpleCameraConfiguration(Camera *camera,
 }
 
 CameraConfiguration::Status SimpleCameraConfiguration::validate()
+{
+	CameraConfigurationKey key(*this);
+
+	std::optional<SimpleCameraData::ValidationResult> result =
+		data_->validationCache_.find(key);
+	if (result) {
+		config_ = std::move(result->config);
+		transform = result->transform;
+		pipeConfig_ = result->pipeConfig;
+		needConversion_ = result->needConversion;
+		combinedTransform_ = result->combinedTransform;
+		return result->status;
+	}
+
+	Status status = validateConfiguration();
+	if (status != Invalid)
+		data_->validationCache_.insert(key, { status, config_, transform,
+						      pipeConfig_, needConversion_,
+						      combinedTransform_ });
+
+	return status;
+}
+
+CameraConfiguration::Status SimpleCameraConfiguration::validateConfiguration()
 {
 	const CameraSensor *sensor = data_->sensor_.get();
 	Status status = Valid;
@@ -1302,16 +1341,12 @@ int SimplePipelineHandler::queueRequestDevice(Camera *camera, Request *request)
 
 std::vector<MediaEntity *> SimplePipelineHandler::locateSensors()
 {
-	std::vector<MediaEntity *> entities;
-
 	/*
 	 * Gather all the camera sensor entities based on the function they
 	 * expose.
 	 */
-	for (MediaEntity *entity : media_->entities()) {
-		if (entity->function() == MEDIA_ENT_F_CAM_SENSOR)
-			entities.push_back(entity);
-	}
+	const std::vector<MediaEntity *> &entities =
+		media_->entitiesByFunction(MEDIA_ENT_F_CAM_SENSOR);
 
 	if (entities.empty())
 		return {};
@@ -47,12 +47,15 @@ class VimcCameraData : public Camera::Private
 {
 public:
 	VimcCameraData(PipelineHandler *pipe, MediaDevice *media)
-		: Camera::Private(pipe), media_(media)
+		: Camera::Private(pipe), media_(media), buffersAllocated_(false)
 	{
 	}
 
 	int init();
+	int loadIPA();
 	int allocateMockIPABuffers();
+	int allocateBuffers();
+	void freeBuffers();
 	void bufferReady(FrameBuffer *buffer);
 	void paramsBufferReady(unsigned int id, const Flags<ipa::vimc::TestFlag> flags);
 
@@ -66,6 +69,9 @@ public:
 
 	std::unique_ptr<ipa::vimc::IPAProxyVimc> ipa_;
 	std::vector<std::unique_ptr<FrameBuffer>> mockIPABufs_;
+
+	/* Have the buffers been imported and mapped to the IPA? */
+	bool buffersAllocated_;
 };
 
 class VimcCameraConfiguration : public CameraConfiguration
@@ -98,6 +104,10 @@ public:
 
 	bool match(DeviceEnumerator *enumerator) override;
 
+protected:
+	int acquireDevice(Camera *camera) override;
+	void releaseDevice(Camera *camera) override;
+
 private:
 	int processControls(VimcCameraData *data, Request *request);
 
@@ -242,6 +252,12 @@ int PipelineHandlerVimc::configure(Camera *camera, CameraConfiguration *config)
 	StreamConfiguration &cfg = config->at(0);
 	int ret;
 
+	/*
+	 * Buffers are kept allocated when the camera is stopped, release them
+	 * as the video device format can't be changed while they exist.
+	 */
+	data->freeBuffers();
+
 	/* The scaler hardcodes a x3 scale-up ratio. */
 	V4L2SubdeviceFormat subformat = {};
 	subformat.mbus_code = MEDIA_BUS_FMT_SGRBG8_1X8;
@@ -326,36 +342,30 @@ int PipelineHandlerVimc::exportFrameBuffers(Camera *camera, Stream *stream,
 	VimcCameraData *data = cameraData(camera);
 	unsigned int count = stream->configuration().bufferCount;
 
+	/* Buffers can't be exported while imported buffers are allocated. */
+	data->freeBuffers();
+
 	return data->video_->exportBuffers(count, buffers);
 }
 
 int PipelineHandlerVimc::start(Camera *camera, [[maybe_unused]] const ControlList *controls)
 {
 	VimcCameraData *data = cameraData(camera);
-	unsigned int count = data->stream_.configuration().bufferCount;
 
-	int ret = data->video_->importBuffers(count);
+	int ret = data->allocateBuffers();
 	if (ret < 0)
 		return ret;
 
-	/* Map the mock IPA buffers to VIMC IPA to exercise IPC code paths. */
-	std::vector<IPABuffer> ipaBuffers;
-	for (auto [i, buffer] : utils::enumerate(data->mockIPABufs_)) {
-		buffer->setCookie(i + 1);
-		ipaBuffers.emplace_back(buffer->cookie(), buffer->planes());
-	}
-	data->ipa_->mapBuffers(ipaBuffers);
-
 	ret = data->ipa_->start();
 	if (ret) {
-		data->video_->releaseBuffers();
+		data->freeBuffers();
 		return ret;
 	}
 
 	ret = data->video_->streamOn();
 	if (ret < 0) {
 		data->ipa_->stop();
-		data->video_->releaseBuffers();
+		data->freeBuffers();
 		return ret;
 	}
 
@@ -366,14 +376,18 @@ void PipelineHandlerVimc::stopDevice(Camera *camera)
 {
 	VimcCameraData *data = cameraData(camera);
 	data->video_->streamOff();
-
-	std::vector<unsigned int> ids;
-	for (const std::unique_ptr<FrameBuffer> &buffer : data->mockIPABufs_)
-		ids.push_back(buffer->cookie());
-	data->ipa_->unmapBuffers(ids);
 	data->ipa_->stop();
 
-	data->video_->releaseBuffers();
+	/*
+	 * Keep the buffers allocated and mapped to the IPA, they will be
+	 * reused when the camera is restarted with the same configuration.
+	 */
+}
+
+void PipelineHandlerVimc::releaseDevice(Camera *camera)
+{
+	VimcCameraData *data = cameraData(camera);
+	data->freeBuffers();
 }
 
 int PipelineHandlerVimc::processControls(VimcCameraData *data, Request *request)
@@ -464,24 +478,9 @@ bool PipelineHandlerVimc::match(DeviceEnumerator *enumerator)
 	if (data->init())
 		return false;
 
-	data->ipa_ = IPAManager::createIPA<ipa::vimc::IPAProxyVimc>(this, 0, 0);
-	if (!data->ipa_) {
-		LOG(VIMC, Error) << "no matching IPA found";
+	/* In lazy initialization mode, the IPA is loaded in acquireDevice(). */
+	if (!lazyCameraInit() && data->loadIPA())
 		return false;
-	}
-
-	data->ipa_->paramsBufferReady.connect(data.get(), &VimcCameraData::paramsBufferReady);
-
-	std::string conf = data->ipa_->configurationFile("vimc.conf");
-	Flags<ipa::vimc::TestFlag> inFlags = ipa::vimc::TestFlag::Flag2;
-	Flags<ipa::vimc::TestFlag> outFlags;
-	data->ipa_->init(IPASettings{ conf, data->sensor_->model() },
-			 ipa::vimc::IPAOperationInit, inFlags, &outFlags);
-
-	LOG(VIMC, Debug)
-		<< "Flag 1 was "
-		<< (outFlags & ipa::vimc::TestFlag::Flag1 ? "" : "not ")
-		<< "set";
 
 	/* Create and register the camera. */
 	std::set<Stream *> streams{ &data->stream_ };
@@ -493,6 +492,16 @@ bool PipelineHandlerVimc::match(DeviceEnumerator *enumerator)
 	return true;
 }
 
+int PipelineHandlerVimc::acquireDevice(Camera *camera)
+{
+	VimcCameraData *data = cameraData(camera);
+
+	if (data->ipa_)
+		return 0;
+
+	return data->loadIPA();
+}
+
 int VimcCameraData::init()
 {
 	int ret;
@@ -603,6 +612,30 @@ void VimcCameraData::bufferReady(FrameBuffer *buffer)
 	ipa_->fillParamsBuffer(request->sequence(), mockIPABufs_[0]->cookie());
 }
 
+int VimcCameraData::loadIPA()
+{
+	ipa_ = IPAManager::createIPA<ipa::vimc::IPAProxyVimc>(pipe(), 0, 0);
+	if (!ipa_) {
+		LOG(VIMC, Error) << "no matching IPA found";
+		return -ENOENT;
+	}
+
+	ipa_->paramsBufferReady.connect(this, &VimcCameraData::paramsBufferReady);
+
+	std::string conf = ipa_->configurationFile("vimc.conf");
+	Flags<ipa::vimc::TestFlag> inFlags = ipa::vimc::TestFlag::Flag2;
+	Flags<ipa::vimc::TestFlag> outFlags;
+	ipa_->init(IPASettings{ conf, sensor_->model() },
+		   ipa::vimc::IPAOperationInit, inFlags, &outFlags);
+
+	LOG(VIMC, Debug)
+		<< "Flag 1 was "
+		<< (outFlags & ipa::vimc::TestFlag::Flag1 ? "" : "not ")
+		<< "set";
+
+	return 0;
+}
+
 int VimcCameraData::allocateMockIPABuffers()
 {
 	constexpr unsigned int kBufCount = 2;
@@ -618,6 +651,45 @@ int VimcCameraData::allocateMockIPABuffers()
 	return video_->exportBuffers(kBufCount, &mockIPABufs_);
 }
 
+int VimcCameraData::allocateBuffers()
+{
+	if (buffersAllocated_)
+		return 0;
+
+	unsigned int count = stream_.configuration().bufferCount;
+
+	int ret = video_->importBuffers(count);
+	if (ret < 0)
+		return ret;
+
+	/* Map the mock IPA buffers to VIMC IPA to exercise IPC code paths. */
+	std::vector<IPABuffer> ipaBuffers;
+	for (auto [i, buffer] : utils::enumerate(mockIPABufs_)) {
+		buffer->setCookie(i + 1);
+		ipaBuffers.emplace_back(buffer->cookie(), buffer->planes());
+	}
+	ipa_->mapBuffers(ipaBuffers);
+
+	buffersAllocated_ = true;
+
+	return 0;
+}
+
+void VimcCameraData::freeBuffers()
+{
+	if (!buffersAllocated_)
+		return;
+
+	std::vector<unsigned int> ids;
+	for (const std::unique_ptr<FrameBuffer> &buffer : mockIPABufs_)
+		ids.push_back(buffer->cookie());
+	ipa_->unmapBuffers(ids);
+
+	video_->releaseBuffers();
+
+	buffersAllocated_ = false;
+}
+
 void VimcCameraData::paramsBufferReady([[maybe_unused]] unsigned int id,
 				       [[maybe_unused]] const Flags<ipa::vimc::TestFlag> flags)
 {
@@ -8,6 +8,7 @@
 #include "libcamera/internal/pipeline_handler.h"
 
 #include <chrono>
+#include <string.h>
 #include <sys/stat.h>
 #include <sys/sysmacros.h>
 
@@ -16,6 +17,7 @@
 #include <libcamera/base/utils.h>
 
 #include <libcamera/camera.h>
+#include <libcamera/control_ids.h>
 #include <libcamera/framebuffer.h>
 #include <libcamera/property_ids.h>
 
@@ -47,6 +49,39 @@ namespace libcamera {
 
 LOG_DEFINE_CATEGORY(Pipeline)
 
+namespace {
+
+/*
+ * Report the frame sequence number and lateness of \a request in its metadata,
+ * and record the frame in the camera frame timing model. Pipeline handlers may
+ * set the FrameSequence metadata when the sequence numbers of the request
+ * buffers don't match the sensor frame sequence numbers, otherwise the sequence
+ * number of the first buffer is used.
+ */
+void updateFrameTiming(Camera::Private *data, Request *request)
+{
+	if (request->buffers().empty())
+		return;
+
+	ControlList &metadata = request->metadata();
+	const FrameMetadata &frame = request->buffers().begin()->second->metadata();
+
+	std::optional<int32_t> sequence = metadata.get(controls::FrameSequence);
+	if (!sequence) {
+		sequence = frame.sequence;
+		metadata.set(controls::FrameSequence, *sequence);
+	}
+
+	std::optional<int32_t> predicted = metadata.get(controls::FramePredictedSequence);
+	if (predicted)
+		metadata.set(controls::FrameLateness, *sequence - *predicted);
+
+	utils::time_point time{ std::chrono::nanoseconds(frame.timestamp) };
+	data->frameTiming_.frameCompleted(*sequence, time);
+}
+
+} /* namespace */
+
 /**
  * \class PipelineHandler
  * \brief Create and manage cameras based on a set of media devices
@@ -69,7 +104,7 @@ LOG_DEFINE_CATEGORY(Pipeline)
  * through the PipelineHandlerFactoryBase::create() function.
  */
 PipelineHandler::PipelineHandler(CameraManager *manager)
-	: manager_(manager), useCount_(0)
+	: manager_(manager), useCount_(0), configuredCamera_(nullptr)
 {
 }
 
@@ -183,6 +218,57 @@ bool PipelineHandler::acquire()
 	return true;
 }
 
+/**
+ * \brief Prepare a camera for use after it has been acquired
+ * \param[in] camera The camera being acquired
+ *
+ * This function is called by Camera::acquire() in the pipeline handler thread,
+ * after access to the pipeline handler has been acquired with acquire(). It
+ * calls acquireDevice() to let the pipeline handler perform the camera
+ * initialization that it has deferred from match().
+ *
+ * Pipeline handlers shall not call this function directly as the Camera class
+ * handles access internally.
+ *
+ * \return 0 on success or a negative error code otherwise
+ */
+int PipelineHandler::acquireCamera(Camera *camera)
+{
+	utils::time_point start = utils::clock::now();
+
+	int ret = acquireDevice(camera);
+	if (ret < 0) {
+		LOG(Pipeline, Error)
+			<< "Failed to initialize camera " << camera->id()
+			<< ": " << strerror(-ret);
+		return ret;
+	}
+
+	LOG(Pipeline, Debug)
+		<< "Camera " << camera->id() << " acquired in "
+		<< utils::Duration(utils::clock::now() - start).get<std::milli>()
+		<< "ms";
+
+	return 0;
+}
+
+/**
+ * \brief Initialize a camera when it is acquired
+ * \param[in] camera The camera being acquired
+ *
+ * Pipeline handlers may override this function to perform expensive camera
+ * initialization, such as loading the IPA module and parsing its tuning file,
+ * when the camera is acquired instead of when it is created in match(). This
+ * is done when lazyCameraInit() returns true. The function is called every time
+ * the camera is acquired, and shall only initialize the camera once.
+ *
+ * \return 0 on success or a negative error code otherwise
+ */
+int PipelineHandler::acquireDevice([[maybe_unused]] Camera *camera)
+{
+	return 0;
+}
+
 /**
  * \brief Release exclusive access to the pipeline handler
  * \param[in] camera The camera for which to release data
@@ -209,6 +295,9 @@ void PipelineHandler::release(Camera *camera)
 
 	releaseDevice(camera);
 
+	if (configuredCamera_ == camera)
+		configuredCamera_ = nullptr;
+
 	--useCount_;
 }
 
@@ -277,6 +366,60 @@ void PipelineHandler::unlockMediaDevices()
  * \return 0 on success or a negative error code otherwise
  */
 
+/**
+ * \brief Configure a camera, skipping unchanged configurations
+ * \param[in] camera The camera to configure
+ * \param[in] config The camera configuration to apply
+ *
+ * This function is called by Camera::configure() in the pipeline handler
+ * thread, after validation of \a config. It calls configure() to apply the
+ * configuration to the device, unless \a camera is the last camera configured
+ * by the pipeline handler and \a config is identical to the configuration it
+ * has been configured with. In that case the device is already configured
+ * correctly, and the function only associates the streams with the stream
+ * configurations in \a config.
+ *
+ * Pipeline handlers shall not call this function directly as the Camera class
+ * handles configuration internally.
+ *
+ * \return 0 on success or a negative error code otherwise
+ */
+int PipelineHandler::configureCamera(Camera *camera, CameraConfiguration *config)
+{
+	CameraConfigurationKey key(*config);
+
+	{
+		MutexLocker locker(lock_);
+
+		if (configuredCamera_ == camera && configuredKey_ == key) {
+			for (const auto &[i, cfg] : utils::enumerate(*config))
+				cfg.setStream(configuredStreams_[i]);
+
+			LOG(Pipeline, Debug)
+				<< "Configuration of camera " << camera->id()
+				<< " unchanged, skipping device configuration";
+
+			return 0;
+		}
+
+		configuredCamera_ = nullptr;
+	}
+
+	int ret = configure(camera, config);
+	if (ret)
+		return ret;
+
+	configuredKey_ = std::move(key);
+	configuredStreams_.clear();
+	for (const StreamConfiguration &cfg : *config)
+		configuredStreams_.push_back(cfg.stream());
+
+	MutexLocker locker(lock_);
+	configuredCamera_ = camera;
+
+	return 0;
+}
+
 /**
  * \fn PipelineHandler::exportFrameBuffers()
  * \brief Allocate and export buffers for \a stream
@@ -345,6 +488,7 @@ void PipelineHandler::stop(Camera *camera)
 	ASSERT(data->queuedRequests_.empty());
 
 	data->requestSequence_ = 0;
+	data->frameTiming_.reset();
 }
 
 /**
@@ -437,6 +581,9 @@ void PipelineHandler::doQueueRequest(Request *request)
 		return;
 	}
 
+	uint32_t sequence = data->frameTiming_.predictSequence(utils::clock::now());
+	request->metadata().set(controls::FramePredictedSequence, sequence);
+
 	int ret = queueRequestDevice(camera, request);
 	if (ret) {
 		request->_d()->cancel();
@@ -532,6 +679,10 @@ void PipelineHandler::completeRequest(Request *request)
 
 		ASSERT(!req->hasPendingBuffers());
 		data->queuedRequests_.pop_front();
+
+		if (req->status() == Request::RequestComplete)
+			updateFrameTiming(data, req);
+
 		camera->requestComplete(req);
 	}
 }
@@ -615,10 +766,9 @@ void PipelineHandler::registerCamera(std::shared_ptr<Camera> camera)
 	 */
 	std::vector<int64_t> devnums;
 	for (const std::shared_ptr<MediaDevice> &media : mediaDevices_) {
-		for (const MediaEntity *entity : media->entities()) {
+		for (const MediaEntity *entity : media->entitiesByFunction(MEDIA_ENT_F_IO_V4L)) {
 			if (entity->pads().size() == 1 &&
-			    (entity->pads()[0]->flags() & MEDIA_PAD_FL_SINK) &&
-			    entity->function() == MEDIA_ENT_F_IO_V4L) {
+			    (entity->pads()[0]->flags() & MEDIA_PAD_FL_SINK)) {
 				devnums.push_back(makedev(entity->deviceMajor(),
 							  entity->deviceMinor()));
 			}
@@ -652,6 +802,27 @@ void PipelineHandler::hotplugMediaDevice(MediaDevice *media)
 	media->disconnected.connect(this, [=]() { mediaDeviceDisconnected(media); });
 }
 
+/**
+ * \brief Check if camera initialization shall be deferred to acquire time
+ *
+ * Lazy camera initialization is enabled by setting the
+ * LIBCAMERA_LAZY_CAMERA_INIT environment variable to a non-empty string. When
+ * enabled, pipeline handlers that support it only perform the initialization
+ * steps required to register cameras in match(), and defer the expensive
+ * steps, such as IPA module loading, to acquireDevice(). This speeds up the
+ * startup of processes that use a single camera out of many.
+ *
+ * The camera controls that depend on the IPA module are then only available
+ * once the camera has been acquired.
+ *
+ * \return True if camera initialization shall be deferred, false otherwise
+ */
+bool PipelineHandler::lazyCameraInit()
+{
+	const char *lazy = utils::secure_getenv("LIBCAMERA_LAZY_CAMERA_INIT");
+	return lazy && lazy[0] != '\0';
+}
+
 /**
  * \brief Slot for the MediaDevice disconnected signal
  */
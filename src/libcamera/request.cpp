@@ -7,6 +7,7 @@
 
 #include "libcamera/internal/request.h"
 
+#include <algorithm>
 #include <map>
 #include <sstream>
 
@@ -41,6 +42,11 @@ LOG_DEFINE_CATEGORY(Request)
  * Request data from the public API, and exposes utility functions to
  * internal users of the request (namely the PipelineHandler class and its
  * subclasses).
+ *
+ * Requests are meant to be reused by applications for every frame. To avoid
+ * memory allocations in the capture loop, the containers that track the
+ * request buffers keep their storage across Request::reuse() calls, and the
+ * fence timeout timer is only created the first time it is needed.
  */
 
 /**
@@ -50,6 +56,8 @@ LOG_DEFINE_CATEGORY(Request)
 Request::Private::Private(Camera *camera)
 	: camera_(camera), cancelled_(false)
 {
+	pending_.reserve(camera->streams().size());
+	spareNodes_.reserve(camera->streams().size());
 }
 
 Request::Private::~Private()
@@ -79,8 +87,8 @@ bool Request::Private::hasPendingBuffers() const
  * \brief Complete a buffer for the request
  * \param[in] buffer The buffer that has completed
  *
- * A request tracks the status of all buffers it contains through a set of
- * pending buffers. This function removes the \a buffer from the set to mark it
+ * A request tracks the status of all buffers it contains through a list of
+ * pending buffers. This function removes the \a buffer from the list to mark it
  * as complete. All buffers associate with the request shall be marked as
  * complete by calling this function once and once only before reporting the
  * request as complete with the complete() function.
@@ -92,8 +100,12 @@ bool Request::Private::completeBuffer(FrameBuffer *buffer)
 {
 	LIBCAMERA_TRACEPOINT(request_complete_buffer, this, buffer);
 
-	int ret = pending_.erase(buffer);
-	ASSERT(ret == 1);
+	auto it = std::find(pending_.begin(), pending_.end(), buffer);
+	ASSERT(it != pending_.end());
+	if (it != pending_.end()) {
+		*it = pending_.back();
+		pending_.pop_back();
+	}
 
 	buffer->_d()->setRequest(nullptr);
 
@@ -136,7 +148,8 @@ void Request::Private::doCancelRequest()
 	cancelled_ = true;
 	pending_.clear();
 	notifiers_.clear();
-	timer_.reset();
+	if (timer_)
+		timer_->stop();
 }
 
 /**
@@ -170,7 +183,8 @@ void Request::Private::reset()
 	prepared_ = false;
 	pending_.clear();
 	notifiers_.clear();
-	timer_.reset();
+	if (timer_)
+		timer_->stop();
 }
 
 /*
@@ -241,11 +255,15 @@ void Request::Private::prepare(std::chrono::milliseconds timeout)
 	 * In case a timeout is specified, create a timer and set it up.
 	 *
 	 * The timer must be created here instead of in the Request constructor,
-	 * in order to be bound to the pipeline handler thread.
+	 * in order to be bound to the pipeline handler thread. It is then kept
+	 * for the next uses of the request.
 	 */
 	if (timeout != 0ms) {
-		timer_ = std::make_unique<Timer>();
-		timer_->timeout.connect(this, &Request::Private::timeout);
+		if (!timer_) {
+			timer_ = std::make_unique<Timer>();
+			timer_->timeout.connect(this, &Request::Private::timeout);
+		}
+
 		timer_->start(timeout);
 	}
 }
@@ -282,8 +300,9 @@ void Request::Private::notifierActivated(FrameBuffer *buffer)
 	if (!notifiers_.empty())
 		return;
 
-	/* All fences completed, delete the timer and emit the prepared signal. */
-	timer_.reset();
+	/* All fences completed, stop the timer and emit the prepared signal. */
+	if (timer_)
+		timer_->stop();
 	emitPrepareCompleted();
 }
 
@@ -378,21 +397,27 @@ Request::~Request()
  * prior to queueing the request to the camera, in lieu of constructing a new
  * request. The application can reuse the buffers that were previously added
  * to the request via addBuffer() by setting \a flags to ReuseBuffers.
+ *
+ * Reusing a request doesn't allocate memory for its buffers. When the buffers
+ * are not reused, the storage of the streams to buffers map is kept internally
+ * and recycled by the next calls to addBuffer().
  */
 void Request::reuse(ReuseFlag flags)
 {
 	LIBCAMERA_TRACEPOINT(request_reuse, this);
 
-	_d()->reset();
+	Private *d = _d();
+	d->reset();
 
 	if (flags & ReuseBuffers) {
 		for (auto pair : bufferMap_) {
 			FrameBuffer *buffer = pair.second;
 			buffer->_d()->setRequest(this);
-			_d()->pending_.insert(buffer);
+			d->pending_.push_back(buffer);
 		}
 	} else {
-		bufferMap_.clear();
+		while (!bufferMap_.empty())
+			d->spareNodes_.push_back(bufferMap_.extract(bufferMap_.begin()));
 	}
 
 	status_ = RequestPending;
@@ -474,8 +499,21 @@ int Request::addBuffer(const Stream *stream, FrameBuffer *buffer,
 	}
 
 	buffer->_d()->setRequest(this);
-	_d()->pending_.insert(buffer);
-	bufferMap_[stream] = buffer;
+
+	Private *d = _d();
+	d->pending_.push_back(buffer);
+
+	/* Recycle a map node released by reuse() if available. */
+	if (!d->spareNodes_.empty()) {
+		BufferMap::node_type node = std::move(d->spareNodes_.back());
+		d->spareNodes_.pop_back();
+
+		node.key() = stream;
+		node.mapped() = buffer;
+		bufferMap_.insert(it, std::move(node));
+	} else {
+		bufferMap_.emplace_hint(it, stream, buffer);
+	}
 
 	/*
 	 * Make sure the fence has been extracted from the buffer
@@ -0,0 +1,340 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+/*
+ * Copyright (C) 2026, Ideas on Board Oy
+ *
+ * v4l2_capability_cache.cpp - Persistent cache of V4L2 device capabilities
+ */
+
+#include "libcamera/internal/v4l2_capability_cache.h"
+
+#include <errno.h>
+#include <string.h>
+#include <sys/utsname.h>
+
+#include <libcamera/base/log.h>
+#include <libcamera/base/utils.h>
+
+#include <libcamera/camera_manager.h>
+
+#include "libcamera/internal/cache_file.h"
+
+/**
+ * \file v4l2_capability_cache.h
+ * \brief Persistent cache of V4L2 device capabilities
+ */
+
+namespace libcamera {
+
+LOG_DECLARE_CATEGORY(V4L2)
+
+namespace {
+
+constexpr char kCacheMagic[8] = { 'L', 'C', 'V', '4', 'L', '2', 'C', '\0' };
+constexpr uint32_t kCacheFormatVersion = 1;
+
+/* Upper bound of the number of formats and sizes per entry. */
+constexpr uint32_t kMaxFormats = 4096;
+
+} /* namespace */
+
+/**
+ * \class V4L2CapabilityCache
+ * \brief Persistent cache of the formats supported by V4L2 devices
+ *
+ * Enumerating the formats and frame sizes supported by a V4L2 device or
+ * sub-device requires one ioctl call per media bus code or pixel format and
+ * per size, and some drivers are slow to answer them. The enumeration is
+ * performed when creating cameras, which is a significant part of the startup
+ * time of short-lived processes.
+ *
+ * The V4L2CapabilityCache stores the enumeration results in a file, and makes
+ * them available to subsequent processes. Entries are identified by a key
+ * constructed by the caller, which shall identify the device hardware and
+ * driver (such as the driver name, model, bus information and hardware and
+ * driver versions), and all the parameters of the enumeration. The whole
+ * cache is additionally tied to the running kernel build and to the libcamera
+ * version, and is discarded when either of them changes. Validating the cache
+ * thus costs a single uname() call.
+ *
+ * Only enumerations whose results don't depend on the current device state
+ * shall be cached.
+ *
+ * The cache is optional. It is enabled by the CameraManager when a cache file
+ * path is set through the LIBCAMERA_V4L2_CAPABILITY_CACHE environment
+ * variable, and is retrieved by the devices through instance().
+ */
+
+/**
+ * \typedef V4L2CapabilityCache::Formats
+ * \brief A map of media bus codes or V4L2 pixel formats to size ranges
+ */
+
+V4L2CapabilityCache *V4L2CapabilityCache::self_ = nullptr;
+
+/**
+ * \brief Create a V4L2 capability cache backed by the file at \a path
+ * \param[in] path The path to the cache file
+ *
+ * The cache contents are loaded from \a path if the file exists and is valid.
+ * Only one cache can exist at a time.
+ */
+V4L2CapabilityCache::V4L2CapabilityCache(const std::string &path)
+	: path_(path), dirty_(false), hits_(0), misses_(0)
+{
+	if (self_)
+		LOG(V4L2, Fatal)
+			<< "Multiple V4L2CapabilityCache objects are not allowed";
+
+	int ret = load();
+	if (ret < 0 && ret != -ENOENT)
+		LOG(V4L2, Debug)
+			<< "Ignoring V4L2 capability cache " << path_ << ": "
+			<< strerror(-ret);
+
+	self_ = this;
+}
+
+/**
+ * \brief Destroy the V4L2 capability cache, saving it if it has been modified
+ */
+V4L2CapabilityCache::~V4L2CapabilityCache()
+{
+	save();
+
+	self_ = nullptr;
+}
+
+/**
+ * \brief Retrieve the V4L2 capability cache instance
+ * \return The V4L2 capability cache instance, or nullptr if the cache is
+ * disabled
+ */
+V4L2CapabilityCache *V4L2CapabilityCache::instance()
+{
+	return self_;
+}
+
+/**
+ * \brief Retrieve the location of the cache file
+ *
+ * The cache is disabled by default. It is enabled by setting the
+ * LIBCAMERA_V4L2_CAPABILITY_CACHE environment variable to the path of the
+ * cache file.
+ *
+ * \return The path to the cache file, or an empty string if the cache is
+ * disabled
+ */
+std::string V4L2CapabilityCache::defaultPath()
+{
+	const char *path = utils::secure_getenv("LIBCAMERA_V4L2_CAPABILITY_CACHE");
+	if (!path)
+		return {};
+
+	return path;
+}
+
+/**
+ * \fn V4L2CapabilityCache::path()
+ * \brief Retrieve the path to the cache file
+ * \return The path to the cache file
+ */
+
+/**
+ * \brief Retrieve cached formats
+ * \param[in] key The key identifying the device and the enumeration
+ * \param[out] formats The cached formats
+ *
+ * \return True if the cache contains formats for \a key, in which case they are
+ * stored in \a formats, or false otherwise
+ */
+bool V4L2CapabilityCache::formats(const std::string &key, Formats *formats)
+{
+	MutexLocker locker(mutex_);
+
+	auto it = entries_.find(key);
+	if (it == entries_.end()) {
+		misses_++;
+		return false;
+	}
+
+	*formats = it->second;
+	hits_++;
+	return true;
+}
+
+/**
+ * \brief Store formats in the cache
+ * \param[in] key The key identifying the device and the enumeration
+ * \param[in] formats The enumerated formats
+ */
+void V4L2CapabilityCache::setFormats(const std::string &key,
+				     const Formats &formats)
+{
+	MutexLocker locker(mutex_);
+
+	Formats &entry = entries_[key];
+	if (entry == formats)
+		return;
+
+	entry = formats;
+	dirty_ = true;
+}
+
+/**
+ * \brief Save the cache to its file if it has been modified
+ * \return 0 on success or if there was nothing to save, or a negative error
+ * code otherwise
+ */
+int V4L2CapabilityCache::save()
+{
+	MutexLocker locker(mutex_);
+
+	if (path_.empty() || !dirty_)
+		return 0;
+
+	dirty_ = false;
+
+	CacheFile::Writer writer;
+	writer.write(kCacheMagic);
+	writer.write(kCacheFormatVersion);
+	writer.writeString(CameraManager::version());
+	writer.writeString(systemId());
+	writer.write<uint32_t>(entries_.size());
+
+	for (const auto &[key, formats] : entries_) {
+		writer.writeString(key);
+		writer.write<uint32_t>(formats.size());
+
+		for (const auto &[code, sizes] : formats) {
+			writer.write<uint32_t>(code);
+			writer.write<uint32_t>(sizes.size());
+
+			for (const SizeRange &size : sizes) {
+				writer.write<uint32_t>(size.min.width);
+				writer.write<uint32_t>(size.min.height);
+				writer.write<uint32_t>(size.max.width);
+				writer.write<uint32_t>(size.max.height);
+				writer.write<uint32_t>(size.hStep);
+				writer.write<uint32_t>(size.vStep);
+			}
+		}
+	}
+
+	int ret = CacheFile::save(path_, writer.data());
+	if (ret < 0) {
+		LOG(V4L2, Debug)
+			<< "Failed to save V4L2 capability cache " << path_
+			<< ": " << strerror(-ret);
+		return ret;
+	}
+
+	LOG(V4L2, Debug)
+		<< "Saved " << entries_.size() << " entries to V4L2 capability cache "
+		<< path_;
+
+	return 0;
+}
+
+/**
+ * \brief Retrieve the number of lookups that were answered from the cache
+ * \return The number of cache hits
+ */
+unsigned int V4L2CapabilityCache::hits() const
+{
+	MutexLocker locker(mutex_);
+	return hits_;
+}
+
+/**
+ * \brief Retrieve the number of lookups that were not answered from the cache
+ * \return The number of cache misses
+ */
+unsigned int V4L2CapabilityCache::misses() const
+{
+	MutexLocker locker(mutex_);
+	return misses_;
+}
+
+/*
+ * Identify the running kernel build. The version string contains the build
+ * number and date, and changes with every kernel rebuild.
+ */
+std::string V4L2CapabilityCache::systemId()
+{
+	struct utsname uts;
+	if (uname(&uts) < 0)
+		return {};
+
+	return std::string(uts.release) + " " + uts.version + " " + uts.machine;
+}
+
+int V4L2CapabilityCache::load()
+{
+	std::vector<uint8_t> data;
+	int ret = CacheFile::load(path_, &data);
+	if (ret < 0)
+		return ret;
+
+	CacheFile::Reader reader(data);
+
+	char magic[sizeof(kCacheMagic)];
+	uint32_t formatVersion;
+	std::string version;
+	std::string system;
+	uint32_t count;
+
+	if (!reader.read(&magic) || memcmp(magic, kCacheMagic, sizeof(magic)) ||
+	    !reader.read(&formatVersion) || formatVersion != kCacheFormatVersion ||
+	    !reader.readString(&version) || version != CameraManager::version() ||
+	    !reader.readString(&system) || system != systemId() ||
+	    !reader.read(&count))
+		return -EINVAL;
+
+	std::map<std::string, Formats> entries;
+
+	for (uint32_t i = 0; i < count; ++i) {
+		std::string key;
+		uint32_t numFormats;
+
+		if (!reader.readString(&key) || !reader.read(&numFormats) ||
+		    numFormats > kMaxFormats)
+			return -EINVAL;
+
+		Formats &formats = entries[key];
+
+		for (uint32_t j = 0; j < numFormats; ++j) {
+			uint32_t code;
+			uint32_t numSizes;
+
+			if (!reader.read(&code) || !reader.read(&numSizes) ||
+			    numSizes > kMaxFormats)
+				return -EINVAL;
+
+			std::vector<SizeRange> &sizes = formats[code];
+
+			for (uint32_t k = 0; k < numSizes; ++k) {
+				uint32_t values[6];
+				if (!reader.read(&values))
+					return -EINVAL;
+
+				sizes.emplace_back(Size{ values[0], values[1] },
+						   Size{ values[2], values[3] },
+						   values[4], values[5]);
+			}
+		}
+	}
+
+	if (!reader.atEnd())
+		return -EINVAL;
+
+	MutexLocker locker(mutex_);
+	entries_ = std::move(entries);
+
+	LOG(V4L2, Debug)
+		<< "Loaded " << entries_.size()
+		<< " entries from V4L2 capability cache " << path_;
+
+	return 0;
+}
+
+} /* namespace libcamera */
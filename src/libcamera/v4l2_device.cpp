@@ -7,6 +7,7 @@
 
 #include "libcamera/internal/v4l2_device.h"
 
+#include <algorithm>
 #include <fcntl.h>
 #include <iomanip>
 #include <limits.h>
@@ -50,6 +51,24 @@ LOG_DEFINE_CATEGORY(V4L2)
  * classes to model either a V4L2 video device or a V4L2 subdevice.
  */
 
+/**
+ * \struct V4L2Device::ControlStatistics
+ * \brief Statistics about the control accesses on a V4L2 device
+ *
+ * \var ControlStatistics::reads
+ * \brief Number of VIDIOC_G_EXT_CTRLS calls
+ *
+ * \var ControlStatistics::writes
+ * \brief Number of VIDIOC_S_EXT_CTRLS calls
+ *
+ * \var ControlStatistics::skippedWrites
+ * \brief Number of setControls() calls that didn't result in a
+ * VIDIOC_S_EXT_CTRLS call, as all control values were unchanged
+ *
+ * \var ControlStatistics::skippedControls
+ * \brief Number of controls not written as their value was unchanged
+ */
+
 /**
  * \brief Construct a V4L2Device
  * \param[in] deviceNode The device node filesystem path
@@ -59,7 +78,7 @@ LOG_DEFINE_CATEGORY(V4L2)
  */
 V4L2Device::V4L2Device(const std::string &deviceNode)
 	: deviceNode_(deviceNode), fdEventNotifier_(nullptr),
-	  frameStartEnabled_(false)
+	  frameStartEnabled_(false), controlStats_({})
 {
 }
 
@@ -146,6 +165,9 @@ void V4L2Device::close()
 	delete fdEventNotifier_;
 
 	fd_.reset();
+
+	controlTemplates_.clear();
+	invalidateControlValues();
 }
 
 /**
@@ -193,21 +215,24 @@ ControlList V4L2Device::getControls(const std::vector<uint32_t> &ids)
 		ctrls.set(id, {});
 	}
 
-	std::vector<v4l2_ext_control> v4l2Ctrls(ids.size());
-	memset(v4l2Ctrls.data(), 0, sizeof(v4l2_ext_control) * ctrls.size());
+	const ControlTemplate *tmpl = controlTemplate(ctrls);
+	if (!tmpl)
+		return {};
+
+	v4l2Ctrls_.resize(ctrls.size());
+	memset(v4l2Ctrls_.data(), 0, sizeof(v4l2_ext_control) * ctrls.size());
 
 	unsigned int i = 0;
 	for (auto &ctrl : ctrls) {
-		unsigned int id = ctrl.first;
-		const struct v4l2_query_ext_ctrl &info = controlInfo_[id];
+		const ControlTemplate::Entry &entry = tmpl->entries[i];
 
-		v4l2_ext_control &v4l2Ctrl = v4l2Ctrls[i++];
-		v4l2Ctrl.id = id;
+		v4l2_ext_control &v4l2Ctrl = v4l2Ctrls_[i++];
+		v4l2Ctrl.id = entry.id;
 
-		if (info.flags & V4L2_CTRL_FLAG_HAS_PAYLOAD) {
+		if (entry.hasPayload) {
 			ControlType type;
 
-			switch (info.type) {
+			switch (entry.v4l2Type) {
 			case V4L2_CTRL_TYPE_U8:
 				type = ControlTypeByte;
 				break;
@@ -215,12 +240,12 @@ ControlList V4L2Device::getControls(const std::vector<uint32_t> &ids)
 			default:
 				LOG(V4L2, Error)
 					<< "Unsupported payload control type "
-					<< info.type;
+					<< entry.v4l2Type;
 				return {};
 			}
 
 			ControlValue &value = ctrl.second;
-			value.reserve(type, true, info.elems);
+			value.reserve(type, true, entry.elems);
 			Span<uint8_t> data = value.data();
 
 			v4l2Ctrl.p_u8 = data.data();
@@ -230,30 +255,41 @@ ControlList V4L2Device::getControls(const std::vector<uint32_t> &ids)
 
 	struct v4l2_ext_controls v4l2ExtCtrls = {};
 	v4l2ExtCtrls.which = V4L2_CTRL_WHICH_CUR_VAL;
-	v4l2ExtCtrls.controls = v4l2Ctrls.data();
-	v4l2ExtCtrls.count = v4l2Ctrls.size();
+	v4l2ExtCtrls.controls = v4l2Ctrls_.data();
+	v4l2ExtCtrls.count = v4l2Ctrls_.size();
+
+	controlStats_.reads++;
+
+	Span<const v4l2_ext_control> v4l2Ctrls{ v4l2Ctrls_ };
 
 	int ret = ioctl(VIDIOC_G_EXT_CTRLS, &v4l2ExtCtrls);
 	if (ret) {
 		unsigned int errorIdx = v4l2ExtCtrls.error_idx;
 
 		/* Generic validation error. */
-		if (errorIdx == 0 || errorIdx >= v4l2Ctrls.size()) {
+		if (errorIdx == 0 || errorIdx >= v4l2Ctrls_.size()) {
 			LOG(V4L2, Error) << "Unable to read controls: "
 					 << strerror(-ret);
 			return {};
 		}
 
 		/* A specific control failed. */
-		const unsigned int id = v4l2Ctrls[errorIdx].id;
+		const unsigned int id = v4l2Ctrls_[errorIdx].id;
 		LOG(V4L2, Error) << "Unable to read control " << utils::hex(id)
 				 << ": " << strerror(-ret);
 
-		v4l2Ctrls.resize(errorIdx);
+		v4l2Ctrls = v4l2Ctrls.first(errorIdx);
 	}
 
 	updateControls(&ctrls, v4l2Ctrls);
 
+	/* The values read from the device are current, cache them. */
+	for (unsigned int j = 0; j < v4l2Ctrls.size(); ++j) {
+		const ControlTemplate::Entry &entry = tmpl->entries[j];
+		if (entry.cacheable)
+			controlValues_[entry.id] = ctrls.get(entry.id);
+	}
+
 	return ctrls;
 }
 
@@ -275,6 +311,14 @@ ControlList V4L2Device::getControls(const std::vector<uint32_t> &ids)
  * are written and their values are updated in \a ctrls, while all other
  * controls are not written and their values are not changed.
  *
+ * To minimize the cost of repeated writes, controls whose value is identical to
+ * the value applied by the device at the last write are skipped, and no ioctl
+ * is issued if all controls are skipped. This assumes that the controls of the
+ * device are only modified through this instance. Controls that are volatile,
+ * inactive or that trigger an action when written are always written, and
+ * writing a control that may affect other controls, such as the blanking,
+ * drops the cached values of the controls not included in \a ctrls.
+ *
  * \return 0 on success or an error code otherwise
  * \retval -EINVAL One of the control is not supported or not accessible
  * \retval i The index of the control that failed
@@ -284,23 +328,46 @@ int V4L2Device::setControls(ControlList *ctrls)
 	if (ctrls->empty())
 		return 0;
 
-	std::vector<v4l2_ext_control> v4l2Ctrls(ctrls->size());
-	memset(v4l2Ctrls.data(), 0, sizeof(v4l2_ext_control) * ctrls->size());
+	const ControlTemplate *tmpl = controlTemplate(*ctrls);
+	if (!tmpl)
+		return -EINVAL;
+
+	v4l2Ctrls_.resize(ctrls->size());
+	memset(v4l2Ctrls_.data(), 0, sizeof(v4l2_ext_control) * ctrls->size());
+	v4l2CtrlIndices_.resize(ctrls->size());
+
+	bool invalidatesOthers = false;
+	unsigned int count = 0;
 
 	for (auto [ctrl, i] = std::pair(ctrls->begin(), 0u); i < ctrls->size(); ctrl++, i++) {
-		const unsigned int id = ctrl->first;
-		const auto iter = controls_.find(id);
-		if (iter == controls_.end()) {
+		const ControlTemplate::Entry &entry = tmpl->entries[i];
+		const unsigned int id = entry.id;
+		ControlValue &value = ctrl->second;
+
+		if (entry.type == ControlTypeByte && !value.isArray()) {
 			LOG(V4L2, Error)
-				<< "Control " << utils::hex(id) << " not found";
+				<< "Control " << utils::hex(id)
+				<< " requires an array value";
 			return -EINVAL;
 		}
-		v4l2_ext_control &v4l2Ctrl = v4l2Ctrls[i];
+
+		/* Skip controls whose value hasn't changed since the last write. */
+		if (entry.cacheable) {
+			const auto iter = controlValues_.find(id);
+			if (iter != controlValues_.end() && iter->second == value) {
+				controlStats_.skippedControls++;
+				continue;
+			}
+		}
+
+		invalidatesOthers |= entry.invalidatesOthers;
+
+		v4l2CtrlIndices_[count] = i;
+		v4l2_ext_control &v4l2Ctrl = v4l2Ctrls_[count++];
 		v4l2Ctrl.id = id;
 
 		/* Set the v4l2_ext_control value for the write operation. */
-		ControlValue &value = ctrl->second;
-		switch (iter->first->type()) {
+		switch (entry.type) {
 		case ControlTypeInteger32: {
 			if (value.isArray()) {
 				Span<uint8_t> data = value.data();
@@ -318,13 +385,6 @@ int V4L2Device::setControls(ControlList *ctrls)
 			break;
 
 		case ControlTypeByte: {
-			if (!value.isArray()) {
-				LOG(V4L2, Error)
-					<< "Control " << utils::hex(id)
-					<< " requires an array value";
-				return -EINVAL;
-			}
-
 			Span<uint8_t> data = value.data();
 			v4l2Ctrl.p_u8 = data.data();
 			v4l2Ctrl.size = data.size();
@@ -339,36 +399,104 @@ int V4L2Device::setControls(ControlList *ctrls)
 		}
 	}
 
-	struct v4l2_ext_controls v4l2ExtCtrls = {};
-	v4l2ExtCtrls.which = V4L2_CTRL_WHICH_CUR_VAL;
-	v4l2ExtCtrls.controls = v4l2Ctrls.data();
-	v4l2ExtCtrls.count = v4l2Ctrls.size();
+	if (!count) {
+		controlStats_.skippedWrites++;
+		return 0;
+	}
+
+	Span<v4l2_ext_control> v4l2Ctrls{ v4l2Ctrls_.data(), count };
+
+	int ret = writeControls(v4l2Ctrls);
+	if (ret < 0) {
+		invalidateControlValues();
+		return ret;
+	}
 
-	int ret = ioctl(VIDIOC_S_EXT_CTRLS, &v4l2ExtCtrls);
 	if (ret) {
-		unsigned int errorIdx = v4l2ExtCtrls.error_idx;
+		/*
+		 * The device state is unknown after a partial write. Report
+		 * the index of the failed control in the caller's list.
+		 */
+		invalidateControlValues();
+		updateControls(ctrls, v4l2Ctrls.first(ret));
+		return v4l2CtrlIndices_[ret];
+	}
 
-		/* Generic validation error. */
-		if (errorIdx == 0 || errorIdx >= v4l2Ctrls.size()) {
-			LOG(V4L2, Error) << "Unable to set controls: "
-					 << strerror(-ret);
-			return -EINVAL;
+	updateControls(ctrls, v4l2Ctrls);
+
+	/*
+	 * Writing some controls may modify the value of other controls, for
+	 * instance when changing the blanking clamps the exposure time. Drop
+	 * the cached values of the controls that are not part of this write in
+	 * that case.
+	 */
+	if (invalidatesOthers) {
+		for (auto iter = controlValues_.begin(); iter != controlValues_.end();) {
+			if (ctrls->contains(iter->first))
+				++iter;
+			else
+				iter = controlValues_.erase(iter);
 		}
+	}
 
-		/* A specific control failed. */
-		const unsigned int id = v4l2Ctrls[errorIdx].id;
-		LOG(V4L2, Error) << "Unable to set control " << utils::hex(id)
-				 << ": " << strerror(-ret);
+	/* Cache the values applied by the device. */
+	for (unsigned int i = 0; i < count; ++i) {
+		const ControlTemplate::Entry &entry = tmpl->entries[v4l2CtrlIndices_[i]];
+		if (entry.cacheable)
+			controlValues_[entry.id] = ctrls->get(entry.id);
+	}
+
+	return 0;
+}
 
-		v4l2Ctrls.resize(errorIdx);
-		ret = errorIdx;
+/**
+ * \brief Write controls to the device from V4L2 control structures
+ * \param[in] v4l2Ctrls The V4L2 control structures to write
+ *
+ * This function writes the controls described by \a v4l2Ctrls with a single
+ * VIDIOC_S_EXT_CTRLS call. The caller is responsible for filling the
+ * structures, and for ensuring that the controls are supported by the device.
+ * Unlike setControls(ControlList *), this function doesn't allocate memory,
+ * which makes it usable in time-critical code paths that write the same set of
+ * controls repeatedly.
+ *
+ * The values applied by the device are not reported back to the caller. They
+ * are however cached, and subsequent calls to setControls(ControlList *) skip
+ * the controls whose value hasn't changed.
+ *
+ * \return 0 on success or an error code otherwise
+ * \retval -EINVAL One of the control is not supported or not accessible
+ * \retval i The index of the control that failed
+ */
+int V4L2Device::setControls(Span<v4l2_ext_control> v4l2Ctrls)
+{
+	if (v4l2Ctrls.empty())
+		return 0;
+
+	int ret = writeControls(v4l2Ctrls);
+	if (ret) {
+		/* The device state is unknown after a failed write. */
+		invalidateControlValues();
+		return ret;
 	}
 
-	updateControls(ctrls, v4l2Ctrls);
+	updateControlValues(v4l2Ctrls);
 
-	return ret;
+	return 0;
 }
 
+/**
+ * \fn V4L2Device::controlStatistics()
+ * \brief Retrieve statistics about the control read and write operations
+ *
+ * The statistics count the VIDIOC_G_EXT_CTRLS and VIDIOC_S_EXT_CTRLS calls
+ * issued by getControls() and setControls(), as well as the calls to
+ * setControls() for which no control needed to be written, and the number of
+ * controls skipped because their value was unchanged.
+ *
+ * \return The control access statistics
+ */
+
 /**
  * \brief Retrieve the v4l2_query_ext_ctrl information for the given control
  * \param[in] id The V4L2 control id
@@ -691,6 +819,10 @@ void V4L2Device::updateControlInfo()
 
 		info = *v4l2ControlInfo(ctrl);
 	}
+
+	/* Control flags may have changed, rebuild the templates. */
+	controlTemplates_.clear();
+	invalidateControlValues();
 }
 
 /*
@@ -738,6 +870,190 @@ void V4L2Device::updateControls(ControlList *ctrls,
 	}
 }
 
+/*
+ * \brief Check if the value of a control can be cached
+ * \param[in] ctrl The V4L2 control information
+ *
+ * Controls that are volatile, inactive or that trigger an action when written
+ * must always be written to the device.
+ *
+ * \return True if the control value can be cached, false otherwise
+ */
+bool V4L2Device::isCacheable(const v4l2_query_ext_ctrl &ctrl)
+{
+	constexpr uint32_t uncacheableFlags = V4L2_CTRL_FLAG_VOLATILE
+					    | V4L2_CTRL_FLAG_WRITE_ONLY
+					    | V4L2_CTRL_FLAG_INACTIVE
+					    | V4L2_CTRL_FLAG_EXECUTE_ON_WRITE;
+
+	return !(ctrl.flags & uncacheableFlags) &&
+	       ctrl.type != V4L2_CTRL_TYPE_BUTTON;
+}
+
+/*
+ * \brief Check if writing a control may modify the value of other controls
+ * \param[in] ctrl The V4L2 control information
+ *
+ * Changing the blanking, for instance, clamps the exposure time.
+ *
+ * \return True if writing the control may modify other controls
+ */
+bool V4L2Device::invalidatesOthers(const v4l2_query_ext_ctrl &ctrl)
+{
+	return ctrl.flags & V4L2_CTRL_FLAG_UPDATE ||
+	       ctrl.id == V4L2_CID_VBLANK ||
+	       ctrl.id == V4L2_CID_HBLANK;
+}
+
+/*
+ * \brief Retrieve the marshalling template for the controls in \a ctrls
+ * \param[in] ctrls The list of controls
+ *
+ * The template stores, in the iteration order of \a ctrls, the information
+ * needed to convert the control values to and from V4L2 controls. Templates
+ * are cached, as the same sets of controls are typically accessed repeatedly.
+ *
+ * \return The template, or nullptr if a control is not supported by the device
+ */
+const V4L2Device::ControlTemplate *V4L2Device::controlTemplate(const ControlList &ctrls)
+{
+	static constexpr unsigned int kMaxControlTemplates = 8;
+
+	for (auto iter = controlTemplates_.rbegin(); iter != controlTemplates_.rend(); ++iter) {
+		const std::vector<ControlTemplate::Entry> &entries = iter->entries;
+		if (entries.size() != ctrls.size())
+			continue;
+
+		if (std::equal(entries.begin(), entries.end(), ctrls.begin(),
+			       [](const ControlTemplate::Entry &entry, const auto &ctrl) {
+				       return entry.id == ctrl.first;
+			       }))
+			return &*iter;
+	}
+
+	ControlTemplate tmpl;
+	tmpl.entries.reserve(ctrls.size());
+
+	for (const auto &ctrl : ctrls) {
+		const unsigned int id = ctrl.first;
+		const auto iter = controls_.find(id);
+		if (iter == controls_.end()) {
+			LOG(V4L2, Error)
+				<< "Control " << utils::hex(id) << " not found";
+			return nullptr;
+		}
+
+		const struct v4l2_query_ext_ctrl &info = controlInfo_[id];
+
+		ControlTemplate::Entry &entry = tmpl.entries.emplace_back();
+		entry.id = id;
+		entry.type = iter->first->type();
+		entry.v4l2Type = info.type;
+		entry.elems = info.elems;
+		entry.hasPayload = info.flags & V4L2_CTRL_FLAG_HAS_PAYLOAD;
+		entry.cacheable = isCacheable(info);
+		entry.invalidatesOthers = invalidatesOthers(info);
+	}
+
+	if (controlTemplates_.size() == kMaxControlTemplates)
+		controlTemplates_.erase(controlTemplates_.begin());
+
+	return &controlTemplates_.emplace_back(std::move(tmpl));
+}
+
+/*
+ * \brief Write V4L2 controls to the device
+ * \param[in] v4l2Ctrls The V4L2 controls
+ * \return 0 on success, -EINVAL on generic errors, or the index of the control
+ * that failed
+ */
+int V4L2Device::writeControls(Span<v4l2_ext_control> v4l2Ctrls)
+{
+	struct v4l2_ext_controls v4l2ExtCtrls = {};
+	v4l2ExtCtrls.which = V4L2_CTRL_WHICH_CUR_VAL;
+	v4l2ExtCtrls.controls = v4l2Ctrls.data();
+	v4l2ExtCtrls.count = v4l2Ctrls.size();
+
+	controlStats_.writes++;
+
+	int ret = ioctl(VIDIOC_S_EXT_CTRLS, &v4l2ExtCtrls);
+	if (!ret)
+		return 0;
+
+	unsigned int errorIdx = v4l2ExtCtrls.error_idx;
+
+	/* Generic validation error. */
+	if (errorIdx == 0 || errorIdx >= v4l2Ctrls.size()) {
+		LOG(V4L2, Error) << "Unable to set controls: "
+				 << strerror(-ret);
+		return -EINVAL;
+	}
+
+	/* A specific control failed. */
+	const unsigned int id = v4l2Ctrls[errorIdx].id;
+	LOG(V4L2, Error) << "Unable to set control " << utils::hex(id)
+			 << ": " << strerror(-ret);
+
+	return errorIdx;
+}
+
+/*
+ * \brief Update the cached control values after a write
+ * \param[in] v4l2Ctrls The V4L2 controls that have been written
+ *
+ * Cache the values of the scalar controls in \a v4l2Ctrls, as applied by the
+ * device, in the same form as setControls(ControlList *) does. Controls that
+ * can't be cached are dropped from the cache, as well as the controls not
+ * included in \a v4l2Ctrls if one of the written controls may affect them.
+ */
+void V4L2Device::updateControlValues(Span<const v4l2_ext_control> v4l2Ctrls)
+{
+	auto written = [&](unsigned int id) {
+		return std::any_of(v4l2Ctrls.begin(), v4l2Ctrls.end(),
+				   [id](const v4l2_ext_control &v4l2Ctrl) {
+					   return v4l2Ctrl.id == id;
+				   });
+	};
+
+	for (const v4l2_ext_control &v4l2Ctrl : v4l2Ctrls) {
+		const struct v4l2_query_ext_ctrl &info = controlInfo_[v4l2Ctrl.id];
+		if (!invalidatesOthers(info))
+			continue;
+
+		for (auto iter = controlValues_.begin(); iter != controlValues_.end();) {
+			if (written(iter->first))
+				++iter;
+			else
+				iter = controlValues_.erase(iter);
+		}
+
+		break;
+	}
+
+	for (const v4l2_ext_control &v4l2Ctrl : v4l2Ctrls) {
+		const unsigned int id = v4l2Ctrl.id;
+		const struct v4l2_query_ext_ctrl &info = controlInfo_[id];
+
+		if (!isCacheable(info) || info.flags & V4L2_CTRL_FLAG_HAS_PAYLOAD) {
+			controlValues_.erase(id);
+			continue;
+		}
+
+		if (info.type == V4L2_CTRL_TYPE_INTEGER64)
+			controlValues_[id] = ControlValue(static_cast<int64_t>(v4l2Ctrl.value64));
+		else
+			controlValues_[id] = ControlValue(static_cast<int32_t>(v4l2Ctrl.value));
+	}
+}
+
+/*
+ * \brief Drop the cached control values
+ */
+void V4L2Device::invalidateControlValues()
+{
+	controlValues_.clear();
+}
+
 /**
  * \brief Slot to handle V4L2 events from the V4L2 device
  *
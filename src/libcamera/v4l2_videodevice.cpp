@@ -31,6 +31,7 @@
 #include "libcamera/internal/framebuffer.h"
 #include "libcamera/internal/media_device.h"
 #include "libcamera/internal/media_object.h"
+#include "libcamera/internal/v4l2_capability_cache.h"
 
 /**
  * \file v4l2_videodevice.h
@@ -533,8 +534,8 @@ std::ostream &operator<<(std::ostream &out, const V4L2DeviceFormat &f)
  * \param[in] deviceNode The file-system path to the video device node
  */
 V4L2VideoDevice::V4L2VideoDevice(const std::string &deviceNode)
-	: V4L2Device(deviceNode), formatInfo_(nullptr), cache_(nullptr),
-	  fdBufferNotifier_(nullptr), state_(State::Stopped),
+	: V4L2Device(deviceNode), entity_(nullptr), formatInfo_(nullptr),
+	  cache_(nullptr), fdBufferNotifier_(nullptr), state_(State::Stopped),
 	  watchdogDuration_(0.0)
 {
 	/*
@@ -554,6 +555,7 @@ V4L2VideoDevice::V4L2VideoDevice(const std::string &deviceNode)
 V4L2VideoDevice::V4L2VideoDevice(const MediaEntity *entity)
 	: V4L2VideoDevice(entity->deviceNode())
 {
+	entity_ = entity;
 	watchdog_.timeout.connect(this, &V4L2VideoDevice::watchdogExpired);
 }
 
@@ -1073,12 +1075,40 @@ int V4L2VideoDevice::trySetFormatSingleplane(V4L2DeviceFormat *format, bool set)
  * If the \a code argument is not zero, only formats compatible with that media
  * bus code will be enumerated.
  *
+ * The enumeration results are stored in the V4L2CapabilityCache when the cache
+ * is enabled, and retrieved from it in subsequent calls and processes.
+ *
  * \return A list of the supported video device formats
  */
 V4L2VideoDevice::Formats V4L2VideoDevice::formats(uint32_t code)
 {
+	V4L2CapabilityCache *cache = V4L2CapabilityCache::instance();
+	V4L2CapabilityCache::Formats cached;
+	std::string key;
 	Formats formats;
 
+	if (cache) {
+		key = std::string("video:") + caps_.driver() + ":" + caps_.card()
+		    + ":" + caps_.bus_info() + ":" + std::to_string(caps_.version)
+		    + ":" + std::to_string(bufferType_) + ":" + std::to_string(code);
+
+		/*
+		 * The driver version doesn't change with the firmware or the
+		 * hardware revision, which the media device reports.
+		 */
+		if (entity_) {
+			const MediaDevice *media = entity_->device();
+			key += ":" + media->model() + ":"
+			     + std::to_string(media->hwRevision());
+		}
+
+		if (cache->formats(key, &cached)) {
+			for (auto &[fourcc, sizes] : cached)
+				formats.emplace(V4L2PixelFormat(fourcc), std::move(sizes));
+			return formats;
+		}
+	}
+
 	for (V4L2PixelFormat pixelFormat : enumPixelformats(code)) {
 		std::vector<SizeRange> sizes = enumSizes(pixelFormat);
 		if (sizes.empty())
@@ -1094,6 +1124,12 @@ V4L2VideoDevice::Formats V4L2VideoDevice::formats(uint32_t code)
 		formats.emplace(pixelFormat, sizes);
 	}
 
+	if (cache && !formats.empty()) {
+		for (const auto &[pixelFormat, sizes] : formats)
+			cached.emplace(pixelFormat.fourcc(), sizes);
+		cache->setFormats(key, cached);
+	}
+
 	return formats;
 }
 
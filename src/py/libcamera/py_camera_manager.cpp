@@ -13,6 +13,7 @@
 #include <vector>
 
 #include "py_main.h"
+#include "py_mapped_frame_buffer.h"
 
 namespace py = pybind11;
 
@@ -73,6 +74,8 @@ std::vector<py::object> PyCameraManager::getReadyRequests()
 	std::vector<py::object> py_reqs;
 
 	for (Request *request : getCompletedRequests()) {
+		PyMappedFrameBuffer::beginAccess(request);
+
 		py::object o = py::cast(request);
 		/* Decrease the ref increased in Camera.queue_request() */
 		o.dec_ref();
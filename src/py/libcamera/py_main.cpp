@@ -23,6 +23,7 @@
 
 #include "py_camera_manager.h"
 #include "py_helpers.h"
+#include "py_mapped_frame_buffer.h"
 
 namespace py = pybind11;
 
@@ -101,6 +102,7 @@ PYBIND11_MODULE(_libcamera, m)
 	init_py_properties_generated(m);
 	init_py_color_space(m);
 	init_py_transform(m);
+	init_py_mapped_frame_buffer(m);
 
 	/* Forward declarations */
 
@@ -237,6 +239,8 @@ PYBIND11_MODULE(_libcamera, m)
 
 			py_req.inc_ref();
 
+			PyMappedFrameBuffer::endAccess(req);
+
 			int ret = self.queueRequest(req);
 			if (ret) {
 				py_req.dec_ref();
@@ -344,6 +348,13 @@ PYBIND11_MODULE(_libcamera, m)
 		     py::arg("planes"), py::arg("cookie") = 0)
 		.def_property_readonly("metadata", &FrameBuffer::metadata, py::return_value_policy::reference_internal)
 		.def_property_readonly("planes", &FrameBuffer::planes)
+		/*
+		 * Memoryviews over a persistent mapping of the planes, valid
+		 * until the request containing the buffer is reused or queued
+		 */
+		.def_property_readonly("mapped_planes", [](py::object self) {
+			return PyMappedFrameBuffer::get(self)->planes();
+		})
 		.def_property("cookie", &FrameBuffer::cookie, &FrameBuffer::setCookie);
 
 	pyFrameBufferPlane
@@ -433,7 +444,10 @@ PYBIND11_MODULE(_libcamera, m)
 		 * \todo As we add a keep_alive to the fb in addBuffers(), we
 		 * can only allow reuse with ReuseBuffers.
 		 */
-		.def("reuse", [](Request &self) { self.reuse(Request::ReuseFlag::ReuseBuffers); })
+		.def("reuse", [](Request &self) {
+			PyMappedFrameBuffer::endAccess(&self);
+			self.reuse(Request::ReuseFlag::ReuseBuffers);
+		})
 		.def("__str__", &Request::toString);
 
 	pyRequestStatus
@@ -0,0 +1,178 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+/*
+ * Copyright (C) 2026, Ideas on Board Oy
+ *
+ * Persistent memory mappings of frame buffers
+ */
+
+#include "py_mapped_frame_buffer.h"
+
+#include <algorithm>
+#include <errno.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <system_error>
+#include <unordered_map>
+
+#include <linux/dma-buf.h>
+
+#include "py_main.h"
+
+namespace py = pybind11;
+
+using namespace libcamera;
+
+/*
+ * Frame buffers are mapped once, the first time their planes are accessed from
+ * Python, and the mapping is kept in a cache until the Python FrameBuffer
+ * object is destroyed. The planes are exported to Python through the buffer
+ * protocol, which allows wrapping them in NumPy arrays without copying the
+ * data. The exported memoryviews keep the mapping alive.
+ *
+ * CPU access to the buffers is bracketed with DMA_BUF_IOCTL_SYNC calls. Access
+ * begins when the buffer is mapped and when a request containing the buffer
+ * completes, and ends when the request is reused or queued to the camera. The
+ * memoryviews stay valid after that point, but their contents are undefined
+ * until the request completes again.
+ */
+
+namespace {
+
+std::unordered_map<const FrameBuffer *, std::shared_ptr<PyMappedFrameBuffer>> mappings;
+
+} /* namespace */
+
+PyMappedFrameBuffer::PyMappedFrameBuffer(const FrameBuffer *buffer)
+	: map_(buffer, MappedFrameBuffer::MapFlag::ReadWrite), accessing_(false)
+{
+	if (!map_.isValid())
+		throw std::system_error(-map_.error(), std::generic_category(),
+					"Failed to map frame buffer");
+
+	for (const FrameBuffer::Plane &plane : buffer->planes()) {
+		auto it = std::find_if(fds_.begin(), fds_.end(),
+				       [&](const SharedFD &fd) {
+					       return fd.get() == plane.fd.get();
+				       });
+		if (it == fds_.end())
+			fds_.push_back(plane.fd);
+	}
+}
+
+PyMappedFrameBuffer::~PyMappedFrameBuffer()
+{
+	endAccess();
+}
+
+/*
+ * Retrieve the mapping for the Python FrameBuffer object \a buffer, mapping
+ * the buffer if it isn't mapped yet.
+ */
+std::shared_ptr<PyMappedFrameBuffer> PyMappedFrameBuffer::get(py::handle buffer)
+{
+	const FrameBuffer *fb = buffer.cast<const FrameBuffer *>();
+
+	auto it = mappings.find(fb);
+	if (it != mappings.end())
+		return it->second;
+
+	auto mapping = std::make_shared<PyMappedFrameBuffer>(fb);
+	mapping->beginAccess();
+
+	/*
+	 * Evict the mapping when the Python object is destroyed, as the
+	 * FrameBuffer may be deleted at any time after that point. The weak
+	 * reference is released here and dropped in the callback.
+	 */
+	py::cpp_function evict([fb](py::handle weakref) {
+		mappings.erase(fb);
+		weakref.dec_ref();
+	});
+	py::weakref(buffer, evict).release();
+
+	mappings.emplace(fb, mapping);
+
+	return mapping;
+}
+
+/* Begin CPU access to the mapped buffers of a completed \a request. */
+void PyMappedFrameBuffer::beginAccess(Request *request)
+{
+	for (const auto &[stream, buffer] : request->buffers()) {
+		auto it = mappings.find(buffer);
+		if (it != mappings.end())
+			it->second->beginAccess();
+	}
+}
+
+/* End CPU access to the mapped buffers of \a request. */
+void PyMappedFrameBuffer::endAccess(Request *request)
+{
+	for (const auto &[stream, buffer] : request->buffers()) {
+		auto it = mappings.find(buffer);
+		if (it != mappings.end())
+			it->second->endAccess();
+	}
+}
+
+py::tuple PyMappedFrameBuffer::planes()
+{
+	const std::vector<MappedBuffer::Plane> &planes = map_.planes();
+	py::tuple tuple(planes.size());
+
+	for (unsigned int i = 0; i < planes.size(); ++i) {
+		Plane plane{ shared_from_this(), planes[i] };
+		tuple[i] = py::memoryview(py::cast(std::move(plane)));
+	}
+
+	return tuple;
+}
+
+void PyMappedFrameBuffer::beginAccess()
+{
+	/*
+	 * Always synchronize, even if access has already begun, as the buffer
+	 * may have been mapped while owned by the device.
+	 */
+	sync(DMA_BUF_SYNC_START | DMA_BUF_SYNC_RW);
+	accessing_ = true;
+}
+
+void PyMappedFrameBuffer::endAccess()
+{
+	if (!accessing_)
+		return;
+
+	sync(DMA_BUF_SYNC_END | DMA_BUF_SYNC_RW);
+	accessing_ = false;
+}
+
+void PyMappedFrameBuffer::sync(uint64_t flags)
+{
+	struct dma_buf_sync sync = { flags };
+
+	for (const SharedFD &fd : fds_) {
+		int ret;
+
+		do {
+			ret = ioctl(fd.get(), DMA_BUF_IOCTL_SYNC, &sync);
+		} while (ret < 0 && (errno == EINTR || errno == EAGAIN));
+
+		/* Buffers that are not dmabufs don't need synchronization. */
+		if (ret < 0 && errno != ENOTTY)
+			LOG(Python, Warning)
+				<< "Failed to synchronize buffer: "
+				<< strerror(errno);
+	}
+}
+
+void init_py_mapped_frame_buffer(py::module &m)
+{
+	py::class_<PyMappedFrameBuffer::Plane>(m, "MappedPlane", py::buffer_protocol())
+		.def_buffer([](PyMappedFrameBuffer::Plane &self) {
+			return py::buffer_info(self.data.data(), self.data.size());
+		})
+		.def("__len__", [](const PyMappedFrameBuffer::Plane &self) {
+			return self.data.size();
+		});
+}
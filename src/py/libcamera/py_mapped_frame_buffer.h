@@ -0,0 +1,56 @@
+/* SPDX-License-Identifier: LGPL-2.1-or-later */
+/*
+ * Copyright (C) 2026, Ideas on Board Oy
+ *
+ * Persistent memory mappings of frame buffers
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <libcamera/base/class.h>
+#include <libcamera/base/shared_fd.h>
+#include <libcamera/base/span.h>
+
+#include <libcamera/framebuffer.h>
+#include <libcamera/request.h>
+
+#include "libcamera/internal/mapped_framebuffer.h"
+
+#include <pybind11/pybind11.h>
+
+class PyMappedFrameBuffer : public std::enable_shared_from_this<PyMappedFrameBuffer>
+{
+public:
+	/* A plane of a mapped frame buffer, exported with the buffer protocol */
+	struct Plane {
+		std::shared_ptr<PyMappedFrameBuffer> buffer;
+		libcamera::Span<uint8_t> data;
+	};
+
+	PyMappedFrameBuffer(const libcamera::FrameBuffer *buffer);
+	~PyMappedFrameBuffer();
+
+	static std::shared_ptr<PyMappedFrameBuffer> get(pybind11::handle buffer);
+
+	static void beginAccess(libcamera::Request *request);
+	static void endAccess(libcamera::Request *request);
+
+	pybind11::tuple planes();
+
+	void beginAccess();
+	void endAccess();
+
+private:
+	LIBCAMERA_DISABLE_COPY_AND_MOVE(PyMappedFrameBuffer)
+
+	void sync(uint64_t flags);
+
+	libcamera::MappedFrameBuffer map_;
+	std::vector<libcamera::SharedFD> fds_;
+	bool accessing_;
+};
+
+void init_py_mapped_frame_buffer(pybind11::module &m);
@@ -0,0 +1,170 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright (C) 2026, Ideas on Board Oy
+ *
+ * camera-configuration-cache.cpp - Camera configuration cache tests
+ */
+
+#include <iostream>
+#include <optional>
+
+#include <libcamera/camera.h>
+#include <libcamera/color_space.h>
+#include <libcamera/formats.h>
+#include <libcamera/stream.h>
+
+#include "libcamera/internal/camera_configuration_cache.h"
+
+#include "test.h"
+
+using namespace std;
+using namespace libcamera;
+
+namespace {
+
+class TestConfiguration : public CameraConfiguration
+{
+public:
+	TestConfiguration(unsigned int width)
+	{
+		StreamConfiguration cfg;
+		cfg.pixelFormat = formats::NV12;
+		cfg.size = { width, 720 };
+		cfg.bufferCount = 4;
+		addConfiguration(cfg);
+	}
+
+	Status validate() override { return Valid; }
+};
+
+} /* namespace */
+
+class CameraConfigurationCacheTest : public Test
+{
+protected:
+	int testKey()
+	{
+		TestConfiguration config(1280);
+		TestConfiguration other(1280);
+		Stream stream;
+
+		/* Streams associated with the configuration are ignored. */
+		other.at(0).setStream(&stream);
+		if (CameraConfigurationKey(config) != CameraConfigurationKey(other)) {
+			cerr << "Identical configurations have different keys" << endl;
+			return TestFail;
+		}
+
+		other.transform = Transform::HFlip;
+		if (CameraConfigurationKey(config) == CameraConfigurationKey(other)) {
+			cerr << "Key ignores the transform" << endl;
+			return TestFail;
+		}
+
+		other.transform = config.transform;
+		other.at(0).colorSpace = ColorSpace::Rec709;
+		if (CameraConfigurationKey(config) == CameraConfigurationKey(other)) {
+			cerr << "Key ignores the color space" << endl;
+			return TestFail;
+		}
+
+		other.at(0).colorSpace = config.at(0).colorSpace;
+		other.addConfiguration(config.at(0));
+		if (CameraConfigurationKey(config) == CameraConfigurationKey(other)) {
+			cerr << "Key ignores the number of streams" << endl;
+			return TestFail;
+		}
+
+		return TestPass;
+	}
+
+	int testCache()
+	{
+		using Cache = CameraConfigurationCache<unsigned int>;
+		Cache cache;
+
+		CameraConfigurationKey key(TestConfiguration(0));
+
+		if (cache.find(key)) {
+			cerr << "Empty cache returned a value" << endl;
+			return TestFail;
+		}
+
+		cache.insert(key, 0);
+
+		std::optional<unsigned int> value = cache.find(key);
+		if (!value || *value != 0) {
+			cerr << "Failed to find cached value" << endl;
+			return TestFail;
+		}
+
+		if (cache.hits() != 1 || cache.misses() != 1) {
+			cerr << "Invalid statistics, " << cache.hits() << " hits, "
+			     << cache.misses() << " misses" << endl;
+			return TestFail;
+		}
+
+		/* Inserting an existing key replaces the value. */
+		cache.insert(key, 42);
+		value = cache.find(key);
+		if (!value || *value != 42) {
+			cerr << "Failed to replace cached value" << endl;
+			return TestFail;
+		}
+
+		/*
+		 * Fill the cache, look up the first entry, and add one more
+		 * entry. The least recently used entry, the second one, must be
+		 * evicted.
+		 */
+		for (unsigned int i = 1; i < Cache::kMaxEntries; ++i)
+			cache.insert(CameraConfigurationKey(TestConfiguration(i)), i);
+
+		if (!cache.find(key)) {
+			cerr << "Entry evicted from non-full cache" << endl;
+			return TestFail;
+		}
+
+		unsigned int last = Cache::kMaxEntries;
+		cache.insert(CameraConfigurationKey(TestConfiguration(last)), last);
+
+		if (!cache.find(key)) {
+			cerr << "Recently used entry evicted" << endl;
+			return TestFail;
+		}
+
+		if (cache.find(CameraConfigurationKey(TestConfiguration(1)))) {
+			cerr << "Least recently used entry not evicted" << endl;
+			return TestFail;
+		}
+
+		for (unsigned int i = 2; i <= last; ++i) {
+			value = cache.find(CameraConfigurationKey(TestConfiguration(i)));
+			if (!value || *value != i) {
+				cerr << "Entry " << i << " not found" << endl;
+				return TestFail;
+			}
+		}
+
+		cache.clear();
+		if (cache.find(key)) {
+			cerr << "Cleared cache returned a value" << endl;
+			return TestFail;
+		}
+
+		return TestPass;
+	}
+
+	int run() override
+	{
+		if (testKey() != TestPass)
+			return TestFail;
+
+		if (testCache() != TestPass)
+			return TestFail;
+
+		return TestPass;
+	}
+};
+
+TEST_REGISTER(CameraConfigurationCacheTest)
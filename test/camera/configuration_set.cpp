@@ -53,6 +53,21 @@ protected:
 			return TestFail;
 		}
 
+		/*
+		 * Test that setting the same configuration again works and
+		 * associates the stream with the stream configuration.
+		 */
+		cfg.setStream(nullptr);
+		if (camera_->configure(config_.get())) {
+			cout << "Failed to set the same configuration again" << endl;
+			return TestFail;
+		}
+
+		if (!cfg.stream()) {
+			cout << "Stream not associated with the configuration" << endl;
+			return TestFail;
+		}
+
 		/*
 		 * Test that configuring the camera fails if it is not
 		 * acquired, this will also test release and reacquiring
@@ -0,0 +1,240 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright (C) 2026, Ideas on Board Oy
+ *
+ * lazy_init.cpp - Test deferred camera initialization
+ */
+
+#include <dirent.h>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdlib.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include <libcamera/framebuffer_allocator.h>
+
+#include <libcamera/base/event_dispatcher.h>
+#include <libcamera/base/thread.h>
+#include <libcamera/base/timer.h>
+#include <libcamera/base/utils.h>
+
+#include "camera_test.h"
+#include "test.h"
+
+using namespace libcamera;
+using namespace std;
+using namespace std::chrono_literals;
+
+namespace {
+
+/*
+ * Enable lazy initialization. This must be done before CameraTest starts the
+ * camera manager, hence before it in the list of base classes.
+ */
+class LazyInitEnvironment
+{
+public:
+	LazyInitEnvironment()
+	{
+		setenv("LIBCAMERA_LAZY_CAMERA_INIT", "1", 1);
+	}
+
+	~LazyInitEnvironment()
+	{
+		unsetenv("LIBCAMERA_LAZY_CAMERA_INIT");
+	}
+};
+
+class LazyInitTest : private LazyInitEnvironment, public CameraTest, public Test
+{
+public:
+	LazyInitTest()
+		: CameraTest("platform/vimc.0 Sensor B")
+	{
+	}
+
+protected:
+	/*
+	 * Check if the VIMC IPA module has been loaded. Depending on whether it
+	 * is isolated or not, the module runs in a child process or is mapped
+	 * in the test process.
+	 */
+	static bool ipaLoaded()
+	{
+		ifstream maps("/proc/self/maps");
+		for (string line; getline(maps, line);) {
+			if (line.find("ipa_vimc.so") != string::npos)
+				return true;
+		}
+
+		DIR *dir = opendir("/proc");
+		if (!dir)
+			return false;
+
+		const string parent = to_string(getpid());
+		bool found = false;
+
+		while (struct dirent *ent = readdir(dir)) {
+			ifstream file(string("/proc/") + ent->d_name + "/stat");
+			string stat;
+			if (!getline(file, stat))
+				continue;
+
+			/*
+			 * The parent pid follows the state, after the command
+			 * name that is enclosed in parentheses and may contain
+			 * spaces.
+			 */
+			size_t pos = stat.rfind(')');
+			if (pos == string::npos)
+				continue;
+
+			istringstream fields(stat.substr(pos + 1));
+			string state, ppid;
+			if (!(fields >> state >> ppid))
+				continue;
+
+			if (ppid == parent) {
+				found = true;
+				break;
+			}
+		}
+
+		closedir(dir);
+		return found;
+	}
+
+	void requestComplete(Request *request)
+	{
+		if (request->status() != Request::RequestComplete)
+			return;
+
+		if (!completedRequests_++)
+			firstFrame_ = utils::clock::now();
+	}
+
+	int init() override
+	{
+		return status_;
+	}
+
+	int run() override
+	{
+		/* The IPA must not be loaded until the camera is acquired. */
+		if (ipaLoaded()) {
+			cerr << "IPA loaded before the camera is acquired" << endl;
+			return TestFail;
+		}
+
+		utils::time_point open = utils::clock::now();
+
+		if (camera_->acquire()) {
+			cerr << "Failed to acquire the camera" << endl;
+			return TestFail;
+		}
+
+		utils::time_point acquired = utils::clock::now();
+
+		if (!ipaLoaded()) {
+			cerr << "IPA not loaded after the camera is acquired" << endl;
+			return TestFail;
+		}
+
+		unique_ptr<CameraConfiguration> config =
+			camera_->generateConfiguration({ StreamRole::VideoRecording });
+		if (!config || config->size() != 1) {
+			cerr << "Failed to generate default configuration" << endl;
+			return TestFail;
+		}
+
+		if (camera_->configure(config.get())) {
+			cerr << "Failed to configure the camera" << endl;
+			return TestFail;
+		}
+
+		Stream *stream = config->at(0).stream();
+
+		allocator_ = make_unique<FrameBufferAllocator>(camera_);
+		if (allocator_->allocate(stream) < 0) {
+			cerr << "Failed to allocate buffers" << endl;
+			return TestFail;
+		}
+
+		for (const unique_ptr<FrameBuffer> &buffer : allocator_->buffers(stream)) {
+			unique_ptr<Request> request = camera_->createRequest();
+			if (!request || request->addBuffer(stream, buffer.get())) {
+				cerr << "Failed to create request" << endl;
+				return TestFail;
+			}
+
+			requests_.push_back(std::move(request));
+		}
+
+		completedRequests_ = 0;
+		camera_->requestCompleted.connect(this, &LazyInitTest::requestComplete);
+
+		if (camera_->start()) {
+			cerr << "Failed to start camera" << endl;
+			return TestFail;
+		}
+
+		for (unique_ptr<Request> &request : requests_) {
+			if (camera_->queueRequest(request.get())) {
+				cerr << "Failed to queue request" << endl;
+				return TestFail;
+			}
+		}
+
+		EventDispatcher *dispatcher = Thread::current()->eventDispatcher();
+
+		Timer timer;
+		timer.start(1000ms);
+		while (timer.isRunning() && !completedRequests_)
+			dispatcher->processEvents();
+
+		if (camera_->stop()) {
+			cerr << "Failed to stop camera" << endl;
+			return TestFail;
+		}
+
+		if (!completedRequests_) {
+			cerr << "No request completed" << endl;
+			return TestFail;
+		}
+
+		cout << "Acquire took "
+		     << utils::Duration(acquired - open).get<std::milli>()
+		     << "ms, first frame after "
+		     << utils::Duration(firstFrame_ - open).get<std::milli>()
+		     << "ms" << endl;
+
+		/* The camera must be acquirable again once initialized. */
+		if (camera_->release() || camera_->acquire()) {
+			cerr << "Failed to acquire the camera again" << endl;
+			return TestFail;
+		}
+
+		return TestPass;
+	}
+
+	void cleanup() override
+	{
+		requests_.clear();
+		allocator_.reset();
+	}
+
+private:
+	unique_ptr<FrameBufferAllocator> allocator_;
+	vector<unique_ptr<Request>> requests_;
+
+	unsigned int completedRequests_;
+	utils::time_point firstFrame_;
+};
+
+} /* namespace */
+
+TEST_REGISTER(LazyInitTest)
@@ -0,0 +1,235 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright (C) 2019, Google Inc.
+ *
+ * request_allocations.cpp - Count memory allocations in the capture loop
+ */
+
+#include <atomic>
+#include <iostream>
+#include <new>
+#include <stdlib.h>
+
+#include <libcamera/framebuffer_allocator.h>
+
+#include <libcamera/base/event_dispatcher.h>
+#include <libcamera/base/thread.h>
+#include <libcamera/base/timer.h>
+
+#include "camera_test.h"
+#include "test.h"
+
+using namespace libcamera;
+using namespace std;
+using namespace std::chrono_literals;
+
+namespace {
+
+/*
+ * Count all allocations performed by the process, and separately the
+ * allocations performed by the current thread.
+ */
+std::atomic<unsigned long> allocations;
+thread_local unsigned long threadAllocations;
+
+} /* namespace */
+
+void *operator new(std::size_t size)
+{
+	allocations++;
+	threadAllocations++;
+
+	void *ptr = malloc(size ? size : 1);
+	if (!ptr)
+		throw std::bad_alloc();
+
+	return ptr;
+}
+
+void operator delete(void *ptr) noexcept
+{
+	free(ptr);
+}
+
+void operator delete(void *ptr, [[maybe_unused]] std::size_t size) noexcept
+{
+	free(ptr);
+}
+
+namespace {
+
+/*
+ * The capture loop still allocates memory outside of the request: the messages
+ * that carry requests to the pipeline handler thread and IPA calls, and the
+ * request controls and metadata. The vimc pipeline handler has been measured
+ * to perform 46 allocations per request, keep a small margin above that to
+ * catch any regression.
+ */
+constexpr double kMaxAllocationsPerRequest = 48;
+
+class RequestAllocations : public CameraTest, public Test
+{
+public:
+	RequestAllocations()
+		: CameraTest("platform/vimc.0 Sensor B")
+	{
+	}
+
+protected:
+	void requestComplete(Request *request)
+	{
+		if (request->status() != Request::RequestComplete)
+			return;
+
+		completeRequestsCount_++;
+
+		/*
+		 * Skip the first requests, to let all the components of the
+		 * capture pipeline settle.
+		 */
+		if (completeRequestsCount_ == warmupCount_)
+			startAllocations_ = allocations;
+		if (completeRequestsCount_ >= warmupCount_)
+			endAllocations_ = allocations;
+
+		const Stream *stream = request->buffers().begin()->first;
+		FrameBuffer *buffer = request->buffers().begin()->second;
+
+		/* Reuse the request alternatively with and without its buffer. */
+		unsigned long count = threadAllocations;
+
+		if (completeRequestsCount_ % 2) {
+			request->reuse(Request::ReuseBuffers);
+		} else {
+			request->reuse();
+			request->addBuffer(stream, buffer);
+		}
+
+		if (completeRequestsCount_ > warmupCount_)
+			reuseAllocations_ += threadAllocations - count;
+
+		camera_->queueRequest(request);
+	}
+
+	int init() override
+	{
+		if (status_ != TestPass)
+			return status_;
+
+		config_ = camera_->generateConfiguration({ StreamRole::VideoRecording });
+		if (!config_ || config_->size() != 1) {
+			cout << "Failed to generate default configuration" << endl;
+			return TestFail;
+		}
+
+		allocator_ = make_unique<FrameBufferAllocator>(camera_);
+
+		return TestPass;
+	}
+
+	int run() override
+	{
+		if (camera_->acquire()) {
+			cout << "Failed to acquire the camera" << endl;
+			return TestFail;
+		}
+
+		if (camera_->configure(config_.get())) {
+			cout << "Failed to set default configuration" << endl;
+			return TestFail;
+		}
+
+		Stream *stream = config_->at(0).stream();
+
+		if (allocator_->allocate(stream) < 0)
+			return TestFail;
+
+		for (const unique_ptr<FrameBuffer> &buffer : allocator_->buffers(stream)) {
+			unique_ptr<Request> request = camera_->createRequest();
+			if (!request) {
+				cout << "Failed to create request" << endl;
+				return TestFail;
+			}
+
+			if (request->addBuffer(stream, buffer.get())) {
+				cout << "Failed to associate buffer with request" << endl;
+				return TestFail;
+			}
+
+			requests_.push_back(move(request));
+		}
+
+		completeRequestsCount_ = 0;
+		warmupCount_ = requests_.size() * 2;
+		reuseAllocations_ = 0;
+
+		camera_->requestCompleted.connect(this, &RequestAllocations::requestComplete);
+
+		if (camera_->start()) {
+			cout << "Failed to start camera" << endl;
+			return TestFail;
+		}
+
+		for (unique_ptr<Request> &request : requests_) {
+			if (camera_->queueRequest(request.get())) {
+				cout << "Failed to queue request" << endl;
+				return TestFail;
+			}
+		}
+
+		EventDispatcher *dispatcher = Thread::current()->eventDispatcher();
+
+		Timer timer;
+		timer.start(2000ms);
+		while (timer.isRunning())
+			dispatcher->processEvents();
+
+		if (camera_->stop()) {
+			cout << "Failed to stop camera" << endl;
+			return TestFail;
+		}
+
+		if (completeRequestsCount_ <= warmupCount_) {
+			cout << "Failed to capture enough frames (got "
+			     << completeRequestsCount_ << " expected more than "
+			     << warmupCount_ << ")" << endl;
+			return TestFail;
+		}
+
+		unsigned int measured = completeRequestsCount_ - warmupCount_;
+		double perRequest = (endAllocations_ - startAllocations_)
+				  / static_cast<double>(measured);
+
+		cout << "Captured " << measured << " requests with "
+		     << perRequest << " allocations per request" << endl;
+
+		if (perRequest > kMaxAllocationsPerRequest) {
+			cout << "Too many allocations per request (maximum "
+			     << kMaxAllocationsPerRequest << ")" << endl;
+			return TestFail;
+		}
+
+		if (reuseAllocations_) {
+			cout << "Request reuse performed " << reuseAllocations_
+			     << " allocations" << endl;
+			return TestFail;
+		}
+
+		return TestPass;
+	}
+
+	vector<unique_ptr<Request>> requests_;
+
+	unique_ptr<CameraConfiguration> config_;
+	unique_ptr<FrameBufferAllocator> allocator_;
+
+	unsigned int completeRequestsCount_;
+	unsigned int warmupCount_;
+	unsigned long startAllocations_;
+	unsigned long endAllocations_;
+	unsigned long reuseAllocations_;
+};
+
+} /* namespace */
+
+TEST_REGISTER(RequestAllocations)
@@ -0,0 +1,205 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright (C) 2026, Ideas on Board Oy
+ *
+ * stop_start.cpp - Test stopping and restarting a camera
+ */
+
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <libcamera/framebuffer_allocator.h>
+
+#include <libcamera/base/event_dispatcher.h>
+#include <libcamera/base/thread.h>
+#include <libcamera/base/timer.h>
+#include <libcamera/base/utils.h>
+
+#include "camera_test.h"
+#include "test.h"
+
+using namespace libcamera;
+using namespace std;
+using namespace std::chrono_literals;
+
+namespace {
+
+class StopStart : public CameraTest, public Test
+{
+public:
+	StopStart()
+		: CameraTest("platform/vimc.0 Sensor B")
+	{
+	}
+
+protected:
+	static constexpr unsigned int kNumCycles = 5;
+
+	void requestComplete(Request *request)
+	{
+		if (request->status() != Request::RequestComplete)
+			return;
+
+		if (!completedRequests_++)
+			firstFrame_ = utils::clock::now();
+
+		request->reuse(Request::ReuseBuffers);
+		camera_->queueRequest(request);
+	}
+
+	int capture(utils::time_point start, utils::Duration *latency)
+	{
+		completedRequests_ = 0;
+
+		if (camera_->start()) {
+			cerr << "Failed to start camera" << endl;
+			return TestFail;
+		}
+
+		for (unique_ptr<Request> &request : requests_) {
+			request->reuse(Request::ReuseBuffers);
+			if (camera_->queueRequest(request.get())) {
+				cerr << "Failed to queue request" << endl;
+				return TestFail;
+			}
+		}
+
+		EventDispatcher *dispatcher = Thread::current()->eventDispatcher();
+
+		Timer timer;
+		timer.start(1000ms);
+		while (timer.isRunning() && completedRequests_ < 5)
+			dispatcher->processEvents();
+
+		if (completedRequests_ < 5) {
+			cerr << "Only " << completedRequests_
+			     << " requests completed" << endl;
+			return TestFail;
+		}
+
+		*latency = firstFrame_ - start;
+
+		return TestPass;
+	}
+
+	int init() override
+	{
+		if (status_ != TestPass)
+			return status_;
+
+		config_ = camera_->generateConfiguration({ StreamRole::VideoRecording });
+		if (!config_ || config_->size() != 1) {
+			cerr << "Failed to generate default configuration" << endl;
+			return TestFail;
+		}
+
+		return TestPass;
+	}
+
+	int run() override
+	{
+		if (camera_->acquire()) {
+			cerr << "Failed to acquire the camera" << endl;
+			return TestFail;
+		}
+
+		if (camera_->configure(config_.get())) {
+			cerr << "Failed to configure the camera" << endl;
+			return TestFail;
+		}
+
+		Stream *stream = config_->at(0).stream();
+
+		allocator_ = make_unique<FrameBufferAllocator>(camera_);
+		if (allocator_->allocate(stream) < 0) {
+			cerr << "Failed to allocate buffers" << endl;
+			return TestFail;
+		}
+
+		for (const unique_ptr<FrameBuffer> &buffer : allocator_->buffers(stream)) {
+			unique_ptr<Request> request = camera_->createRequest();
+			if (!request || request->addBuffer(stream, buffer.get())) {
+				cerr << "Failed to create request" << endl;
+				return TestFail;
+			}
+
+			requests_.push_back(std::move(request));
+		}
+
+		camera_->requestCompleted.connect(this, &StopStart::requestComplete);
+
+		utils::Duration latency;
+		if (capture(utils::clock::now(), &latency) != TestPass)
+			return TestFail;
+
+		cout << "First start: first frame after "
+		     << latency.get<std::milli>() << "ms" << endl;
+
+		for (unsigned int i = 0; i < kNumCycles; ++i) {
+			utils::time_point stop = utils::clock::now();
+
+			if (camera_->stop()) {
+				cerr << "Failed to stop camera" << endl;
+				return TestFail;
+			}
+
+			/*
+			 * Reconfigure the camera with the same configuration
+			 * on every other cycle, which must not prevent reusing
+			 * the pipeline internal resources.
+			 */
+			if (i % 2 && camera_->configure(config_.get())) {
+				cerr << "Failed to reconfigure the camera" << endl;
+				return TestFail;
+			}
+
+			if (capture(stop, &latency) != TestPass)
+				return TestFail;
+
+			cout << "Restart " << i << ": first frame after "
+			     << latency.get<std::milli>() << "ms from stop"
+			     << endl;
+		}
+
+		if (camera_->stop()) {
+			cerr << "Failed to stop camera" << endl;
+			return TestFail;
+		}
+
+		/* Buffers must still be allocatable when the camera is stopped. */
+		FrameBufferAllocator allocator(camera_);
+		if (allocator.allocate(stream) < 0) {
+			cerr << "Failed to allocate buffers after stop" << endl;
+			return TestFail;
+		}
+
+		if (capture(utils::clock::now(), &latency) != TestPass)
+			return TestFail;
+
+		if (camera_->stop()) {
+			cerr << "Failed to stop camera" << endl;
+			return TestFail;
+		}
+
+		return TestPass;
+	}
+
+	void cleanup() override
+	{
+		requests_.clear();
+		allocator_.reset();
+	}
+
+private:
+	unique_ptr<CameraConfiguration> config_;
+	unique_ptr<FrameBufferAllocator> allocator_;
+	vector<unique_ptr<Request>> requests_;
+
+	unsigned int completedRequests_;
+	utils::time_point firstFrame_;
+};
+
+} /* namespace */
+
+TEST_REGISTER(StopStart)
@@ -267,6 +267,62 @@ protected:
 		return TestPass;
 	}
 
+	int priorityWrite()
+	{
+		std::unordered_map<uint32_t, DelayedControls::ControlParams> delays = {
+			{ V4L2_CID_BRIGHTNESS, { 1, true } },
+			{ V4L2_CID_CONTRAST, { 2, false } },
+		};
+		std::unique_ptr<DelayedControls> delayed =
+			std::make_unique<DelayedControls>(dev_.get(), delays);
+		ControlList ctrls;
+
+		ctrls.set(V4L2_CID_BRIGHTNESS, 50);
+		ctrls.set(V4L2_CID_CONTRAST, 50);
+		dev_->setControls(&ctrls);
+		delayed->reset();
+
+		/* Trigger the first frame start event */
+		delayed->applyControls(0);
+
+		for (unsigned int i = 1; i < 10; i++) {
+			int32_t value = 60 + i;
+
+			ctrls.set(V4L2_CID_BRIGHTNESS, value);
+			ctrls.set(V4L2_CID_CONTRAST, value);
+			delayed->push(ctrls);
+
+			delayed->applyControls(i);
+		}
+
+		/*
+		 * The controls are written to the device ahead of time by their
+		 * respective delays, check the values applied by the last frame
+		 * start.
+		 */
+		ControlList result = dev_->getControls({ V4L2_CID_BRIGHTNESS,
+							  V4L2_CID_CONTRAST });
+		int32_t brightness = result.get(V4L2_CID_BRIGHTNESS).get<int32_t>();
+		int32_t contrast = result.get(V4L2_CID_CONTRAST).get<int32_t>();
+		if (brightness != 68 || contrast != 69) {
+			cerr << "Failed priority write"
+			     << " brightness " << brightness
+			     << " contrast " << contrast
+			     << endl;
+			return TestFail;
+		}
+
+		const DelayedControls::Statistics &stats = delayed->statistics();
+		if (stats.frames != 10 || stats.writes != 9 ||
+		    stats.maxLatency < stats.lastLatency) {
+			cerr << "Invalid statistics: " << stats.frames
+			     << " frames, " << stats.writes << " writes" << endl;
+			return TestFail;
+		}
+
+		return TestPass;
+	}
+
 	int run() override
 	{
 		int ret;
@@ -291,6 +347,11 @@ protected:
 		if (ret)
 			return ret;
 
+		/* Test priority writes and write statistics. */
+		ret = priorityWrite();
+		if (ret)
+			return ret;
+
 		return TestPass;
 	}
 
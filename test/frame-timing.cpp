@@ -0,0 +1,95 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright (C) 2026, Ideas on Board Oy
+ *
+ * frame-timing.cpp - Frame timing model tests
+ */
+
+#include <iostream>
+
+#include "libcamera/internal/frame_timing.h"
+
+#include "test.h"
+
+using namespace std;
+using namespace std::chrono_literals;
+using namespace libcamera;
+
+class FrameTimingTest : public Test
+{
+protected:
+	int expect(FrameTimingModel &model, utils::time_point time,
+		   uint32_t expected)
+	{
+		uint32_t sequence = model.predictSequence(time);
+		if (sequence != expected) {
+			cerr << "Predicted sequence " << sequence
+			     << ", expected " << expected << endl;
+			return TestFail;
+		}
+
+		return TestPass;
+	}
+
+	int run() override
+	{
+		FrameTimingModel model;
+		utils::time_point start{ 1s };
+
+		/* Without timing information, requests are captured in order. */
+		if (expect(model, start, 0) != TestPass ||
+		    expect(model, start, 1) != TestPass ||
+		    expect(model, start, 2) != TestPass)
+			return TestFail;
+
+		/* Record frames at 30fps and check the duration estimate. */
+		for (unsigned int i = 0; i < 10; ++i)
+			model.frameCompleted(i, start + i * 33ms);
+
+		if (model.frameDuration() != utils::Duration(33ms)) {
+			cerr << "Invalid frame duration "
+			     << model.frameDuration() << endl;
+			return TestFail;
+		}
+
+		/*
+		 * A request queued shortly after frame 9 is captured in frame 10,
+		 * one queued two frame durations later in frame 12.
+		 */
+		if (expect(model, start + 9 * 33ms + 5ms, 10) != TestPass ||
+		    expect(model, start + 11 * 33ms + 5ms, 12) != TestPass)
+			return TestFail;
+
+		/* Requests queued back to back are captured in consecutive frames. */
+		if (expect(model, start + 11 * 33ms + 6ms, 13) != TestPass)
+			return TestFail;
+
+		/* Frame start events override completed frames. */
+		model.frameStarted(20, start + 20 * 33ms + 2ms);
+		model.frameCompleted(30, start + 50 * 33ms);
+
+		if (expect(model, start + 20 * 33ms + 10ms, 21) != TestPass)
+			return TestFail;
+
+		/* Frame duration changes are tracked within a few frames. */
+		for (unsigned int i = 21; i < 40; ++i)
+			model.frameStarted(i, start + 20 * 33ms + 2ms + (i - 20) * 50ms);
+
+		utils::Duration duration = model.frameDuration();
+		if (duration < 49ms || duration > 51ms) {
+			cerr << "Frame duration change not tracked: " << duration
+			     << endl;
+			return TestFail;
+		}
+
+		/* Reset restarts the sequence. */
+		model.reset();
+
+		if (expect(model, start, 0) != TestPass)
+			return TestFail;
+
+		return TestPass;
+	}
+};
+
+TEST_REGISTER(FrameTimingTest)
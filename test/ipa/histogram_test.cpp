@@ -0,0 +1,189 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright (C) 2026, Ideas on Board Oy
+ *
+ * histogram_test.cpp - Test the libipa Histogram class
+ */
+
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "libipa/histogram.h"
+
+#include "test.h"
+
+using namespace std;
+using namespace libcamera;
+using namespace libcamera::ipa;
+
+class HistogramTest : public Test
+{
+protected:
+	int init()
+	{
+		std::mt19937 gen(42);
+		std::uniform_int_distribution<uint32_t> dist(0, 1000);
+
+		for (auto &zone : zones_) {
+			for (uint32_t &bin : zone)
+				bin = dist(gen);
+		}
+
+		/* Leave holes in the data to exercise empty bins. */
+		for (unsigned int i = 100; i < 120; i++) {
+			for (auto &zone : zones_)
+				zone[i] = 0;
+		}
+
+		return TestPass;
+	}
+
+	int testQuantiles()
+	{
+		Histogram hist(zones_[0]);
+
+		const std::array<double, 6> q{ 0.0, 0.1, 0.25, 0.5, 0.98, 1.0 };
+		std::array<double, 6> points;
+		hist.quantiles(q, points);
+
+		for (unsigned int i = 0; i < q.size(); i++) {
+			double expected = hist.quantile(q[i]);
+			if (points[i] != expected) {
+				cerr << "Quantile " << q[i] << " mismatch: "
+				     << points[i] << " != " << expected << endl;
+				return TestFail;
+			}
+		}
+
+		return TestPass;
+	}
+
+	int testUpdate()
+	{
+		Histogram hist;
+		if (hist.bins() != 0 || hist.total() != 0) {
+			cerr << "Empty histogram isn't empty" << endl;
+			return TestFail;
+		}
+
+		for (const auto &zone : zones_) {
+			hist.update(zone);
+
+			Histogram ref(zone);
+			if (hist.bins() != ref.bins() || hist.total() != ref.total() ||
+			    hist.interQuantileMean(0.98, 1.0) != ref.interQuantileMean(0.98, 1.0)) {
+				cerr << "Updated histogram mismatch" << endl;
+				return TestFail;
+			}
+		}
+
+		return TestPass;
+	}
+
+	int testWeighted()
+	{
+		/* Weighting every bin by 3 must not change the quantiles. */
+		Histogram hist(zones_[0], [](uint32_t value) { return value * 3; });
+		Histogram ref(zones_[0]);
+
+		if (hist.total() != ref.total() * 3) {
+			cerr << "Weighted histogram total mismatch" << endl;
+			return TestFail;
+		}
+
+		if (hist.quantile(0.5) != ref.quantile(0.5)) {
+			cerr << "Weighted histogram median mismatch" << endl;
+			return TestFail;
+		}
+
+		/* Accumulate a subset of zones, and compare with their sum. */
+		std::array<uint32_t, kBins> sum{};
+		hist.reset(kBins);
+		for (unsigned int z = 0; z < zones_.size(); z += 2) {
+			uint32_t weight = z + 1;
+			hist.accumulate(zones_[z], weight);
+			for (unsigned int i = 0; i < kBins; i++)
+				sum[i] += zones_[z][i] * weight;
+		}
+
+		ref.update(sum);
+		for (double q : { 0.01, 0.5, 0.99 }) {
+			if (hist.quantile(q) != ref.quantile(q)) {
+				cerr << "Accumulated histogram mismatch" << endl;
+				return TestFail;
+			}
+		}
+
+		return TestPass;
+	}
+
+	int benchmark()
+	{
+		constexpr unsigned int kIterations = 10000;
+		double separate = 0;
+		double batched = 0;
+
+		auto start = chrono::steady_clock::now();
+		for (unsigned int i = 0; i < kIterations; i++) {
+			const auto &zone = zones_[i % zones_.size()];
+			Histogram hist(zone);
+			separate += hist.quantile(0.1) + hist.quantile(0.5) +
+				    hist.quantile(0.9);
+			separate += hist.interQuantileMean(0.98, 1.0);
+		}
+		auto mid = chrono::steady_clock::now();
+
+		Histogram hist;
+		const std::array<double, 3> q{ 0.1, 0.5, 0.9 };
+		std::array<double, 3> points;
+		for (unsigned int i = 0; i < kIterations; i++) {
+			hist.update(zones_[i % zones_.size()]);
+			hist.quantiles(q, points);
+			batched += points[0] + points[1] + points[2];
+			batched += hist.interQuantileMean(0.98, 1.0);
+		}
+		auto end = chrono::steady_clock::now();
+
+		auto ns = [](chrono::steady_clock::duration d) {
+			return chrono::duration_cast<chrono::nanoseconds>(d).count() / kIterations;
+		};
+
+		cout << "Histogram: " << ns(mid - start) << " ns/frame with separate "
+		     << "queries, " << ns(end - mid) << " ns/frame with a reused "
+		     << "histogram and batched queries" << endl;
+
+		if (separate != batched) {
+			cerr << "Batched queries mismatch" << endl;
+			return TestFail;
+		}
+
+		return TestPass;
+	}
+
+	int run()
+	{
+		int ret = testQuantiles();
+		if (ret != TestPass)
+			return ret;
+
+		ret = testUpdate();
+		if (ret != TestPass)
+			return ret;
+
+		ret = testWeighted();
+		if (ret != TestPass)
+			return ret;
+
+		return benchmark();
+	}
+
+private:
+	static constexpr unsigned int kBins = 256;
+
+	std::array<std::array<uint32_t, kBins>, 8> zones_;
+};
+
+TEST_REGISTER(HistogramTest)
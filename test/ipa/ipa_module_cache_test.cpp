@@ -0,0 +1,200 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright (C) 2026, Ideas on Board Oy
+ *
+ * ipa_module_cache_test.cpp - Test the IPA module cache and its invalidation
+ */
+
+#include <chrono>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "libcamera/internal/ipa_module.h"
+#include "libcamera/internal/ipa_module_cache.h"
+
+#include "test.h"
+
+using namespace std;
+using namespace libcamera;
+
+class IPAModuleCacheTest : public Test
+{
+protected:
+	int init() override
+	{
+		dir_ = "/tmp/libcamera.test.XXXXXX";
+		if (!mkdtemp(&dir_.front()))
+			return TestFail;
+
+		modulePath_ = dir_ + "/ipa_vimc.so";
+		cachePath_ = dir_ + "/ipa_modules.cache";
+
+		ifstream src("src/ipa/vimc/ipa_vimc.so", ios::binary);
+		ofstream dst(modulePath_, ios::binary);
+		dst << src.rdbuf();
+		if (!src || !dst) {
+			cerr << "Failed to copy the vimc IPA module" << endl;
+			return TestSkip;
+		}
+
+		return TestPass;
+	}
+
+	int checkModule(bool expectHit)
+	{
+		IPAModuleCache cache(cachePath_);
+		IPAModule module(modulePath_, &cache);
+
+		if (!module.isValid()) {
+			cerr << "IPA module is invalid" << endl;
+			return TestFail;
+		}
+
+		if (strcmp(module.info().name, "vimc")) {
+			cerr << "Unexpected IPA module name " << module.info().name
+			     << endl;
+			return TestFail;
+		}
+
+		unsigned int hits = expectHit ? 1 : 0;
+		if (cache.hits() != hits || cache.misses() != 1 - hits) {
+			cerr << "Expected a cache " << (expectHit ? "hit" : "miss")
+			     << ", got " << cache.hits() << " hits and "
+			     << cache.misses() << " misses" << endl;
+			return TestFail;
+		}
+
+		return TestPass;
+	}
+
+	int checkSignature(const vector<uint8_t> &signature,
+			   std::optional<bool> expected)
+	{
+		IPAModuleCache cache(cachePath_);
+		std::optional<bool> valid = cache.signatureValid(modulePath_, signature);
+
+		if (valid != expected) {
+			cerr << "Unexpected cached signature check result" << endl;
+			return TestFail;
+		}
+
+		return TestPass;
+	}
+
+	int run() override
+	{
+		const vector<uint8_t> signature = { 0x01, 0x02, 0x03, 0x04 };
+		const vector<uint8_t> otherSignature = { 0x05, 0x06 };
+
+		/* The first lookup misses, the next ones hit from the file. */
+		if (checkModule(false) != TestPass)
+			return TestFail;
+
+		if (checkModule(true) != TestPass)
+			return TestFail;
+
+		/* Store a signature check result, and retrieve it. */
+		{
+			IPAModuleCache cache(cachePath_);
+			if (cache.signatureValid(modulePath_, signature)) {
+				cerr << "Unexpected cached signature" << endl;
+				return TestFail;
+			}
+
+			cache.setSignatureValid(modulePath_, signature, true);
+		}
+
+		if (checkSignature(signature, true) != TestPass)
+			return TestFail;
+
+		/* A different signature must not match the cached result. */
+		if (checkSignature(otherSignature, std::nullopt) != TestPass)
+			return TestFail;
+
+		/*
+		 * Rewrite the last byte of the module in place, and restore
+		 * its modification time. The status change time must
+		 * invalidate the entry. Wait first to make sure the timestamps
+		 * change even on file systems with a coarse granularity.
+		 */
+		struct stat st;
+		if (stat(modulePath_.c_str(), &st) < 0)
+			return TestFail;
+
+		this_thread::sleep_for(chrono::milliseconds(1100));
+
+		{
+			fstream file(modulePath_, ios::binary | ios::in | ios::out);
+			file.seekg(st.st_size - 1);
+			char c = file.get();
+			file.seekp(st.st_size - 1);
+			file.put(c);
+		}
+
+		const struct timespec times[2] = { st.st_atim, st.st_mtim };
+		if (utimensat(AT_FDCWD, modulePath_.c_str(), times, 0) < 0)
+			return TestFail;
+
+		if (checkSignature(signature, std::nullopt) != TestPass)
+			return TestFail;
+
+		if (checkModule(false) != TestPass)
+			return TestFail;
+
+		/* Replace the module with a different file. */
+		{
+			ofstream file(modulePath_ + ".new", ios::binary);
+			ifstream src(modulePath_, ios::binary);
+			file << src.rdbuf() << '\0';
+		}
+
+		if (rename((modulePath_ + ".new").c_str(), modulePath_.c_str()) < 0)
+			return TestFail;
+
+		if (checkModule(false) != TestPass)
+			return TestFail;
+
+		if (checkModule(true) != TestPass)
+			return TestFail;
+
+		/* A cache file writable by other users must be ignored. */
+		chmod(cachePath_.c_str(), 0666);
+
+		if (checkModule(false) != TestPass)
+			return TestFail;
+
+		/* A corrupted cache file must be ignored. */
+		if (truncate(cachePath_.c_str(), 20) < 0)
+			return TestFail;
+
+		if (checkModule(false) != TestPass)
+			return TestFail;
+
+		if (checkModule(true) != TestPass)
+			return TestFail;
+
+		return TestPass;
+	}
+
+	void cleanup() override
+	{
+		unlink(modulePath_.c_str());
+		unlink(cachePath_.c_str());
+		rmdir(dir_.c_str());
+	}
+
+private:
+	string dir_;
+	string modulePath_;
+	string cachePath_;
+};
+
+TEST_REGISTER(IPAModuleCacheTest)
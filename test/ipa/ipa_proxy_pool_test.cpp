@@ -0,0 +1,127 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright (C) 2026, Ideas on Board Oy
+ *
+ * ipa_proxy_pool_test.cpp - Test the pool of pre-spawned IPA proxy workers
+ */
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+#include <libcamera/ipa/vimc_ipa_proxy.h>
+
+#include "libcamera/internal/ipa_module.h"
+#include "libcamera/internal/ipa_proxy_worker_pool.h"
+#include "libcamera/internal/process.h"
+
+#include "test.h"
+
+using namespace libcamera;
+using namespace std;
+using namespace std::chrono_literals;
+
+class IPAProxyPoolTest : public Test
+{
+protected:
+	int init() override
+	{
+		module_ = make_unique<IPAModule>("src/ipa/vimc/ipa_vimc.so");
+		if (!module_->isValid()) {
+			cerr << "Failed to load the vimc IPA module" << endl;
+			return TestSkip;
+		}
+
+		return TestPass;
+	}
+
+	/*
+	 * Measure the latency from the creation of an isolated IPA proxy to
+	 * the completion of its first call, which is the contribution of the
+	 * IPA to the camera open latency.
+	 */
+	int measure(chrono::microseconds *latency)
+	{
+		auto start = chrono::steady_clock::now();
+
+		auto ipa = make_unique<ipa::vimc::IPAProxyVimc>(module_.get(), true);
+		if (!ipa->isValid()) {
+			cerr << "Failed to create the vimc IPA proxy" << endl;
+			return TestFail;
+		}
+
+		std::string conf = ipa->configurationFile("vimc.conf");
+		Flags<ipa::vimc::TestFlag> inFlags;
+		Flags<ipa::vimc::TestFlag> outFlags;
+		int ret = ipa->init(IPASettings{ conf, "vimc" },
+				    ipa::vimc::IPAOperationInit,
+				    inFlags, &outFlags);
+		if (ret < 0 || !(outFlags & ipa::vimc::TestFlag::Flag1)) {
+			cerr << "IPA interface init() failed" << endl;
+			return TestFail;
+		}
+
+		*latency = chrono::duration_cast<chrono::microseconds>(
+			chrono::steady_clock::now() - start);
+
+		return TestPass;
+	}
+
+	int run() override
+	{
+		const std::string &modulePath = module_->path();
+		chrono::microseconds cold, miss, hit;
+
+		/* Without a pool, the worker is spawned on demand. */
+		if (measure(&cold) != TestPass)
+			return TestFail;
+
+		IPAProxyWorkerPool pool(1);
+
+		/* The first acquisition misses and fills the pool. */
+		if (measure(&miss) != TestPass)
+			return TestFail;
+
+		if (pool.hits() != 0 || pool.misses() != 1) {
+			cerr << "Expected a pool miss" << endl;
+			return TestFail;
+		}
+
+		/* Give the spare worker time to initialize, as an idle pool would. */
+		this_thread::sleep_for(200ms);
+
+		/* The next acquisition is served by the pre-spawned worker. */
+		if (measure(&hit) != TestPass)
+			return TestFail;
+
+		if (pool.hits() != 1 || pool.misses() != 1) {
+			cerr << "Expected a pool hit" << endl;
+			return TestFail;
+		}
+
+		/* The pool must have been refilled. */
+		if (pool.available(modulePath) != 1) {
+			cerr << "Pool not refilled" << endl;
+			return TestFail;
+		}
+
+		cout << "IPA open latency: " << cold.count() << "us without pool, "
+		     << miss.count() << "us on pool miss, "
+		     << hit.count() << "us on pool hit" << endl;
+
+		return TestPass;
+	}
+
+	void cleanup() override
+	{
+		module_.reset();
+	}
+
+private:
+	ProcessManager processManager_;
+
+	unique_ptr<IPAModule> module_;
+};
+
+TEST_REGISTER(IPAProxyPoolTest)
@@ -0,0 +1,171 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright (C) 2026, Ideas on Board Oy
+ *
+ * alsc_test.cpp - Test and benchmark the Raspberry Pi ALSC adaptive solver
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <random>
+
+#include <libcamera/geometry.h>
+
+#include "controller/rpi/alsc.h"
+
+#include "test.h"
+
+using namespace std;
+using namespace libcamera;
+using namespace RPiController;
+
+class AlscTest : public Test
+{
+protected:
+	/*
+	 * Generate R/G colour statistics for a grey scene with a residual
+	 * colour shading of a few percent towards the corners, and some noise.
+	 */
+	void generateStats(Array2D<double> &C, std::mt19937 &gen)
+	{
+		const Size &size = C.dimensions();
+		std::normal_distribution<double> noise(0.0, 0.0002);
+
+		for (unsigned int y = 0; y < size.height; y++) {
+			for (unsigned int x = 0; x < size.width; x++) {
+				double dx = (x + 0.5) / size.width - 0.5;
+				double dy = (y + 0.5) / size.height - 0.5;
+				double shading = 1 + kShading * (dx * dx + dy * dy) * 2;
+
+				C[y * size.width + x] = 0.6 * shading + noise(gen);
+			}
+		}
+	}
+
+	static double spread(const Array2D<double> &C, const Array2D<double> &lambda)
+	{
+		double min = std::numeric_limits<double>::max();
+		double max = 0;
+
+		for (unsigned int i = 0; i < C.size(); i++) {
+			double value = C[i] * lambda[i];
+			min = std::min(min, value);
+			max = std::max(max, value);
+		}
+
+		return max / min - 1;
+	}
+
+	int testSize(const Size &size)
+	{
+		std::mt19937 gen(42);
+		Array2D<double> C, lambda, oldLambda;
+		SparseArray<double> W, M;
+
+		C.resize(size);
+		lambda.resize(size, 1.0);
+		oldLambda.resize(size);
+		for (auto &w : W)
+			w.resize(size);
+		for (auto &m : M)
+			m.resize(size);
+
+		/*
+		 * Starting from unity lambdas, the solver must even out most of
+		 * the colour shading.
+		 */
+		generateStats(C, gen);
+		computeW(C, kSigma, W);
+		runMatrixIterations(C, lambda, W, M, kOmega, kIterations, 0.0,
+				    kLambdaBound, oldLambda);
+
+		Array2D<double> unity;
+		unity.resize(size, 1.0);
+		double before = spread(C, unity);
+		double after = spread(C, lambda);
+
+		if (after > before / 4) {
+			cerr << "Colour shading not corrected for " << size
+			     << ": spread " << before << " -> " << after << endl;
+			return TestFail;
+		}
+
+		for (unsigned int i = 0; i < lambda.size(); i++) {
+			if (lambda[i] < 1 - kLambdaBound - 1e-6 ||
+			    lambda[i] > 1 + kLambdaBound + 1e-6) {
+				cerr << "Lambda out of bounds for " << size << endl;
+				return TestFail;
+			}
+		}
+
+		/*
+		 * Measure the time taken by the adaptive algorithm in steady
+		 * state, with new statistics on every run and the lambdas carried
+		 * over from the previous run, as for a video stream. This covers
+		 * both colour channels.
+		 */
+		constexpr unsigned int kFrames = 200;
+
+		auto start = chrono::steady_clock::now();
+		for (unsigned int i = 0; i < kFrames; i++) {
+			generateStats(C, gen);
+			for (unsigned int channel = 0; channel < 2; channel++) {
+				computeW(C, kSigma, W);
+				runMatrixIterations(C, lambda, W, M, kOmega,
+						    kIterations, kThreshold,
+						    kLambdaBound, oldLambda);
+			}
+		}
+		auto steady = chrono::steady_clock::now() - start;
+
+		/* Also measure the worst case, running all the iterations. */
+		start = chrono::steady_clock::now();
+		for (unsigned int i = 0; i < kFrames; i++) {
+			std::fill(lambda.begin(), lambda.end(), 1.0);
+			for (unsigned int channel = 0; channel < 2; channel++) {
+				computeW(C, kSigma, W);
+				runMatrixIterations(C, lambda, W, M, kOmega,
+						    kIterations, 0.0,
+						    kLambdaBound, oldLambda);
+			}
+		}
+		auto full = chrono::steady_clock::now() - start;
+
+		auto us = [](chrono::steady_clock::duration d) {
+			return chrono::duration_cast<chrono::microseconds>(d).count() /
+			       static_cast<double>(kFrames);
+		};
+
+		cout << "ALSC " << size << ": " << us(steady)
+		     << " us/frame in steady state, " << us(full)
+		     << " us/frame with " << kIterations << " iterations" << endl;
+
+		return TestPass;
+	}
+
+	int run()
+	{
+		/* Table sizes for VC4 and PiSP. */
+		for (const Size &size : { Size(16, 12), Size(32, 32) }) {
+			int ret = testSize(size);
+			if (ret != TestPass)
+				return ret;
+		}
+
+		return TestPass;
+	}
+
+private:
+	/* Typical tuning parameters. */
+	static constexpr double kSigma = 0.005;
+	static constexpr double kOmega = 1.3;
+	static constexpr unsigned int kIterations = 100;
+	static constexpr double kThreshold = 1e-3;
+	static constexpr double kLambdaBound = 0.05;
+
+	static constexpr double kShading = 0.03;
+};
+
+TEST_REGISTER(AlscTest)
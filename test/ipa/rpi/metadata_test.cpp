@@ -0,0 +1,236 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright (C) 2026, Ideas on Board Oy
+ *
+ * metadata_test.cpp - Test the Raspberry Pi controller metadata
+ */
+
+#include <any>
+#include <iostream>
+#include <string>
+
+#include "controller/metadata.h"
+
+#include "test.h"
+
+using namespace std;
+using namespace RPiController;
+
+namespace {
+
+const MetadataTag<int> IntTag("test.int");
+const MetadataTag<std::string> StringTag("test.string");
+const MetadataTag<double> DoubleTag("test.double");
+
+} /* namespace */
+
+class MetadataTest : public Test
+{
+protected:
+	int testSetGet()
+	{
+		Metadata metadata;
+		int value = 0;
+
+		if (metadata.get(IntTag, value) != -1) {
+			cerr << "Unset tag has a value" << endl;
+			return TestFail;
+		}
+
+		metadata.set(IntTag, 42);
+		if (metadata.get(IntTag, value) || value != 42) {
+			cerr << "Failed to get the value of a typed tag" << endl;
+			return TestFail;
+		}
+
+		/* Typed and string tags refer to the same value. */
+		if (metadata.get("test.int", value) || value != 42) {
+			cerr << "Failed to get the value by tag name" << endl;
+			return TestFail;
+		}
+
+		metadata.set("test.int", 43);
+		if (metadata.get(IntTag, value) || value != 43) {
+			cerr << "Failed to overwrite the value by tag name" << endl;
+			return TestFail;
+		}
+
+		int *locked = metadata.getLocked(IntTag);
+		if (!locked || *locked != 43) {
+			cerr << "Failed to access the value in place" << endl;
+			return TestFail;
+		}
+
+		metadata.clear();
+		if (metadata.get(IntTag, value) != -1 || metadata.getLocked(IntTag)) {
+			cerr << "Value not cleared" << endl;
+			return TestFail;
+		}
+
+		return TestPass;
+	}
+
+	int testTypeMismatch()
+	{
+		Metadata metadata;
+
+		metadata.set(IntTag, 42);
+
+		/* Getting a value with the wrong type throws, as std::any does. */
+		try {
+			double value;
+			metadata.get("test.int", value);
+			cerr << "Type mismatch not detected" << endl;
+			return TestFail;
+		} catch (const std::bad_any_cast &) {
+		}
+
+		if (metadata.getLocked<double>("test.int")) {
+			cerr << "In-place access with the wrong type succeeded" << endl;
+			return TestFail;
+		}
+
+		/* Setting a value with a different type replaces it. */
+		metadata.set("test.int", std::string("forty-two"));
+
+		std::string str;
+		if (metadata.get("test.int", str) || str != "forty-two") {
+			cerr << "Failed to replace the value type" << endl;
+			return TestFail;
+		}
+
+		try {
+			int value;
+			metadata.get(IntTag, value);
+			cerr << "Type mismatch not detected on typed tag" << endl;
+			return TestFail;
+		} catch (const std::bad_any_cast &) {
+		}
+
+		if (metadata.getLocked(IntTag)) {
+			cerr << "In-place access with the wrong typed tag succeeded" << endl;
+			return TestFail;
+		}
+
+		/* Copying a value of a different type replaces the destination. */
+		Metadata other;
+		other.set(IntTag, 7);
+		metadata = other;
+
+		int value = 0;
+		if (metadata.get(IntTag, value) || value != 7) {
+			cerr << "Failed to copy a value of a different type" << endl;
+			return TestFail;
+		}
+
+		return TestPass;
+	}
+
+	int testMerge()
+	{
+		Metadata metadata;
+		Metadata other;
+		int value = 0;
+		std::string str;
+		double dbl = 0;
+
+		metadata.set(IntTag, 1);
+		other.set(IntTag, 2);
+		other.set(StringTag, std::string("other"));
+
+		metadata.merge(other);
+
+		/* Existing values are kept, missing ones are moved. */
+		if (metadata.get(IntTag, value) || value != 1 ||
+		    metadata.get(StringTag, str) || str != "other") {
+			cerr << "Merge produced wrong values" << endl;
+			return TestFail;
+		}
+
+		if (other.get(IntTag, value) || value != 2 ||
+		    other.get(StringTag, str) != -1) {
+			cerr << "Merge left wrong values in the source" << endl;
+			return TestFail;
+		}
+
+		Metadata copy;
+		copy.set(StringTag, std::string("copy"));
+		copy.set(DoubleTag, 0.5);
+
+		metadata.mergeCopy(copy);
+
+		if (metadata.get(StringTag, str) || str != "other" ||
+		    metadata.get(DoubleTag, dbl) || dbl != 0.5) {
+			cerr << "Merge copy produced wrong values" << endl;
+			return TestFail;
+		}
+
+		if (copy.get(StringTag, str) || str != "copy" ||
+		    copy.get(DoubleTag, dbl) || dbl != 0.5) {
+			cerr << "Merge copy modified the source" << endl;
+			return TestFail;
+		}
+
+		return TestPass;
+	}
+
+	int testCopy()
+	{
+		Metadata metadata;
+		Metadata other;
+		int value = 0;
+		std::string str;
+		double dbl = 0;
+
+		metadata.set(IntTag, 1);
+		metadata.set(DoubleTag, 1.5);
+		other.set(IntTag, 2);
+		other.set(StringTag, std::string("other"));
+
+		/* Copying replaces all the values, including the missing ones. */
+		metadata = other;
+
+		if (metadata.get(IntTag, value) || value != 2 ||
+		    metadata.get(StringTag, str) || str != "other" ||
+		    metadata.get(DoubleTag, dbl) != -1) {
+			cerr << "Copy produced wrong values" << endl;
+			return TestFail;
+		}
+
+		/* The copy doesn't share storage with the source. */
+		other.set(StringTag, std::string("changed"));
+		if (metadata.get(StringTag, str) || str != "other") {
+			cerr << "Copy shares storage with the source" << endl;
+			return TestFail;
+		}
+
+		Metadata copy(metadata);
+		if (copy.get(IntTag, value) || value != 2 ||
+		    copy.get(StringTag, str) || str != "other" ||
+		    copy.get(DoubleTag, dbl) != -1) {
+			cerr << "Copy construction produced wrong values" << endl;
+			return TestFail;
+		}
+
+		return TestPass;
+	}
+
+	int run()
+	{
+		int ret = testSetGet();
+		if (ret != TestPass)
+			return ret;
+
+		ret = testTypeMismatch();
+		if (ret != TestPass)
+			return ret;
+
+		ret = testMerge();
+		if (ret != TestPass)
+			return ret;
+
+		return testCopy();
+	}
+};
+
+TEST_REGISTER(MetadataTest)
@@ -0,0 +1,130 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright (C) 2026, Ideas on Board Oy
+ *
+ * pwl_test.cpp - Test and benchmark the Raspberry Pi Pwl evaluation
+ */
+
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <math.h>
+#include <vector>
+
+#include <libcamera/base/span.h>
+
+#include "controller/pwl.h"
+
+#include "test.h"
+
+using namespace std;
+using namespace libcamera;
+using namespace RPiController;
+
+class PwlTest : public Test
+{
+protected:
+	int init()
+	{
+		/* A gamma curve, as found in the tuning files. */
+		std::vector<Pwl::Point> points;
+		for (unsigned int i = 0; i <= 64; i++) {
+			double x = i * 1024.0;
+			points.emplace_back(x, 65535 * pow(x / 65536, 0.45));
+		}
+
+		gamma_ = Pwl(points);
+
+		/* The points at which VC4 evaluates the gamma curve. */
+		for (unsigned int i = 0; i < kPoints; i++) {
+			if (i < 16)
+				x_[i] = i * 1024;
+			else if (i < 24)
+				x_[i] = (i - 16) * 2048 + 16384;
+			else
+				x_[i] = (i - 24) * 4096 + 32768;
+		}
+
+		return TestPass;
+	}
+
+	int testEval()
+	{
+		/* Check the batched evaluation against the scalar one. */
+		const std::vector<double> x = {
+			-100.0, 0.0, 512.0, 1024.0, 30000.0, 65536.0, 70000.0,
+			/* Unsorted values must work too. */
+			40000.0, 100.0, 65000.0, 3.5,
+		};
+		std::vector<double> y(x.size());
+
+		gamma_.eval(x, y);
+
+		for (unsigned int i = 0; i < x.size(); i++) {
+			double expected = gamma_.eval(x[i]);
+			if (y[i] != expected) {
+				cerr << "Batched evaluation mismatch at " << x[i]
+				     << ": " << y[i] << " != " << expected << endl;
+				return TestFail;
+			}
+		}
+
+		/* The control points must be evaluated exactly. */
+		if (gamma_.eval(0.0) != 0.0 || gamma_.eval(65536.0) != 65535.0) {
+			cerr << "Control points not evaluated exactly" << endl;
+			return TestFail;
+		}
+
+		return TestPass;
+	}
+
+	int benchmark()
+	{
+		constexpr unsigned int kIterations = 10000;
+		std::array<double, kPoints> scalar;
+		std::array<double, kPoints> batched;
+
+		auto start = chrono::steady_clock::now();
+		for (unsigned int i = 0; i < kIterations; i++) {
+			for (unsigned int j = 0; j < kPoints; j++)
+				scalar[j] = gamma_.eval(x_[j]);
+		}
+		auto mid = chrono::steady_clock::now();
+
+		for (unsigned int i = 0; i < kIterations; i++)
+			gamma_.eval(x_, batched);
+		auto end = chrono::steady_clock::now();
+
+		auto ns = [](chrono::steady_clock::duration d) {
+			return chrono::duration_cast<chrono::nanoseconds>(d).count() / kIterations;
+		};
+
+		cout << "Pwl: " << ns(mid - start) << " ns/curve with scalar "
+		     << "evaluation, " << ns(end - mid) << " ns/curve with batched "
+		     << "evaluation" << endl;
+
+		if (scalar != batched) {
+			cerr << "Batched evaluation mismatch" << endl;
+			return TestFail;
+		}
+
+		return TestPass;
+	}
+
+	int run()
+	{
+		int ret = testEval();
+		if (ret != TestPass)
+			return ret;
+
+		return benchmark();
+	}
+
+private:
+	static constexpr unsigned int kPoints = 32;
+
+	Pwl gamma_;
+	std::array<double, kPoints> x_;
+};
+
+TEST_REGISTER(PwlTest)
@@ -0,0 +1,71 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright (C) 2026, Ideas on Board Oy
+ *
+ * media_device_lookup_test.cpp - Test MediaDevice entity lookups
+ */
+
+#include <iostream>
+#include <vector>
+
+#include <linux/media.h>
+
+#include "media_device_test.h"
+
+using namespace libcamera;
+using namespace std;
+
+class MediaDeviceLookupTest : public MediaDeviceTest
+{
+	int checkFunction(unsigned int function)
+	{
+		vector<MediaEntity *> expected;
+		for (MediaEntity *entity : media_->entities()) {
+			if (entity->function() == function)
+				expected.push_back(entity);
+		}
+
+		if (media_->entitiesByFunction(function) != expected) {
+			cerr << "Invalid entities for function 0x" << hex
+			     << function << dec << endl;
+			return TestFail;
+		}
+
+		return TestPass;
+	}
+
+	int run()
+	{
+		/* All entities must be found by name. */
+		for (MediaEntity *entity : media_->entities()) {
+			if (media_->getEntityByName(entity->name()) != entity) {
+				cerr << "Failed to look up entity '"
+				     << entity->name() << "'" << endl;
+				return TestFail;
+			}
+		}
+
+		if (media_->getEntityByName("Invalid Entity")) {
+			cerr << "Found an entity with an invalid name" << endl;
+			return TestFail;
+		}
+
+		/* Function lookups must match a scan of the entities list. */
+		if (media_->entitiesByFunction(MEDIA_ENT_F_IO_V4L).empty()) {
+			cerr << "No video device entity found" << endl;
+			return TestFail;
+		}
+
+		for (unsigned int function : { MEDIA_ENT_F_IO_V4L,
+					       MEDIA_ENT_F_CAM_SENSOR,
+					       MEDIA_ENT_F_PROC_VIDEO_SCALER,
+					       MEDIA_ENT_F_ATV_DECODER }) {
+			if (checkFunction(function) != TestPass)
+				return TestFail;
+		}
+
+		return TestPass;
+	}
+};
+
+TEST_REGISTER(MediaDeviceLookupTest)
@@ -298,6 +298,70 @@ class SimpleCaptureMethods(CameraTesterBase):
 
         cam.stop()
 
+    def test_mapped_planes(self):
+        cm = self.cm
+        cam = self.cam
+
+        camconfig = cam.generate_configuration([libcam.StreamRole.StillCapture])
+        self.assertTrue(camconfig.size == 1)
+
+        streamconfig = camconfig.at(0)
+
+        cam.configure(camconfig)
+
+        stream = streamconfig.stream
+
+        allocator = libcam.FrameBufferAllocator(cam)
+        num_bufs = allocator.allocate(stream)
+        self.assertTrue(num_bufs > 0)
+
+        buffer = allocator.buffers(stream)[0]
+
+        planes = buffer.mapped_planes
+        self.assertEqual(len(planes), len(buffer.planes))
+
+        for mv, plane in zip(planes, buffer.planes):
+            self.assertFalse(mv.readonly)
+            self.assertEqual(mv.nbytes, plane.length)
+
+        # The mapping is persistent, all views share the same memory
+        planes[0][0] = 0x5a
+        self.assertEqual(buffer.mapped_planes[0][0], 0x5a)
+
+        req = cam.create_request()
+        req.add_buffer(stream, buffer)
+
+        cam.start()
+        cam.queue_request(req)
+
+        req = None
+        gc.collect()
+
+        sel = selectors.DefaultSelector()
+        sel.register(cm.event_fd, selectors.EVENT_READ)
+
+        reqs = []
+        while not reqs:
+            sel.select()
+            reqs = cm.get_ready_requests()
+
+        self.assertEqual(reqs[0].status, libcam.Request.Status.Complete)
+
+        # The views remain valid, and the captured frame is visible through them
+        bytes_used = buffer.metadata.planes[0].bytes_used
+        self.assertTrue(bytes_used > 0)
+        self.assertEqual(len(bytes(planes[0][:bytes_used])), bytes_used)
+
+        for mv in planes:
+            mv.release()
+
+        reqs = None
+        planes = None
+        buffer = None
+        gc.collect()
+
+        cam.stop()
+
 
 # Recursively expand slist's objects into olist, using seen to track already
 # processed objects.
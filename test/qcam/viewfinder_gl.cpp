@@ -0,0 +1,313 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright (C) 2026, agent
+ *
+ * viewfinder_gl.cpp - Test raw Bayer rendering in the qcam OpenGL viewfinder
+ */
+
+#include <array>
+#include <iostream>
+#include <math.h>
+#include <memory>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <vector>
+
+#include <QApplication>
+#include <QImage>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+#include <QSize>
+
+#include <libcamera/base/shared_fd.h>
+#include <libcamera/base/unique_fd.h>
+
+#include <libcamera/color_space.h>
+#include <libcamera/formats.h>
+#include <libcamera/framebuffer.h>
+
+#include "../common/image.h"
+#include "viewfinder_gl.h"
+
+#include "test.h"
+
+using namespace libcamera;
+using namespace std;
+
+namespace {
+
+struct RawFormat {
+	PixelFormat format;
+	unsigned int bitDepth;
+	/* Position of the first red pixel in the Bayer pattern */
+	unsigned int redX;
+	unsigned int redY;
+};
+
+/* Cover the 8-bit and the 10-bit and 12-bit CSI-2 packed shaders. */
+const std::array<RawFormat, 3> rawFormats{ {
+	{ formats::SRGGB8, 8, 0, 0 },
+	{ formats::SGRBG10_CSI2P, 10, 1, 0 },
+	{ formats::SBGGR12_CSI2P, 12, 1, 1 },
+} };
+
+/* Colour patches, from top-left to bottom-right, as 8-bit R, G and B values. */
+const std::array<std::array<unsigned int, 3>, 4> patches{ {
+	{ 40, 120, 60 },
+	{ 200, 80, 30 },
+	{ 90, 90, 150 },
+	{ 160, 220, 100 },
+} };
+
+class ViewFinderGLTest : public Test
+{
+protected:
+	int init() override
+	{
+		/* Render off-screen unless a platform has been selected. */
+		setenv("QT_QPA_PLATFORM", "offscreen", 0);
+
+		app_ = make_unique<QApplication>(argc_, argv_);
+
+		QOffscreenSurface surface;
+		surface.create();
+
+		QOpenGLContext context;
+		if (!context.create() || !context.makeCurrent(&surface)) {
+			cerr << "OpenGL not available" << endl;
+			return TestSkip;
+		}
+
+		/* The histogram computation requires vertex texture fetch. */
+		GLint units = 0;
+		context.functions()->glGetIntegerv(GL_MAX_VERTEX_TEXTURE_IMAGE_UNITS,
+						   &units);
+		context.doneCurrent();
+
+		if (!units) {
+			cerr << "Vertex texture fetch not supported" << endl;
+			return TestSkip;
+		}
+
+		return TestPass;
+	}
+
+	static const std::array<unsigned int, 3> &patch(int x, int y)
+	{
+		return patches[(y >= kHeight / 2) * 2 + (x >= kWidth / 2)];
+	}
+
+	/*
+	 * Fill the frame with the colour patches, with the least significant
+	 * bits of the 10-bit and 12-bit formats all set to 1. Sampling them by
+	 * mistake would then result in large errors.
+	 */
+	static void fillFrame(const RawFormat &format, unsigned int stride,
+			      uint8_t *data)
+	{
+		const unsigned int shift = format.bitDepth - 8;
+
+		for (int y = 0; y < kHeight; y++) {
+			uint8_t *line = data + y * stride;
+
+			for (int x = 0; x < kWidth; x++) {
+				unsigned int c = (x + format.redX) % 2 +
+						 (y + format.redY) % 2;
+				unsigned int value = (patch(x, y)[c] << shift) |
+						     ((1 << shift) - 1);
+
+				switch (format.bitDepth) {
+				case 8:
+					line[x] = value;
+					break;
+
+				case 10:
+					line[x / 4 * 5 + x % 4] = value >> 2;
+					line[x / 4 * 5 + 4] |= (value & 0x3) << (x % 4 * 2);
+					break;
+
+				case 12:
+					line[x / 2 * 3 + x % 2] = value >> 4;
+					line[x / 2 * 3 + 2] |= (value & 0xf) << (x % 2 * 4);
+					break;
+				}
+			}
+		}
+	}
+
+	static unique_ptr<FrameBuffer> createBuffer(unsigned int size)
+	{
+		UniqueFD fd(memfd_create("viewfinder_gl", MFD_CLOEXEC));
+		if (!fd.isValid() || ftruncate(fd.get(), size) < 0)
+			return nullptr;
+
+		FrameBuffer::Plane plane;
+		plane.fd = SharedFD(std::move(fd));
+		plane.offset = 0;
+		plane.length = size;
+
+		return make_unique<FrameBuffer>(std::vector<FrameBuffer::Plane>{ plane });
+	}
+
+	/* Histogram bin of an 8-bit value, as computed by histogram.vert. */
+	static unsigned int bin(unsigned int value)
+	{
+		return std::min(value * ViewFinderGL::kHistogramBins / 255,
+				ViewFinderGL::kHistogramBins - 1);
+	}
+
+	int testFormat(const RawFormat &format)
+	{
+		const unsigned int stride = kWidth * format.bitDepth / 8;
+
+		unique_ptr<FrameBuffer> buffer = createBuffer(stride * kHeight);
+		if (!buffer) {
+			cerr << "Failed to create frame buffer" << endl;
+			return TestFail;
+		}
+
+		unique_ptr<Image> image =
+			Image::fromFrameBuffer(buffer.get(), Image::MapMode::ReadWrite);
+		if (!image) {
+			cerr << "Failed to map frame buffer" << endl;
+			return TestFail;
+		}
+
+		fillFrame(format, stride, image->data(0).data());
+
+		if (viewfinder_->setFormat(format.format, QSize(kWidth, kHeight),
+					   ColorSpace::Raw, stride)) {
+			cerr << "Failed to set format " << format.format << endl;
+			return TestFail;
+		}
+
+		viewfinder_->setColourGains(kGains[0], kGains[2]);
+
+		/* The histogram is only refreshed every few frames. */
+		QImage frame;
+		for (unsigned int i = 0; i < kFrames; i++) {
+			viewfinder_->render(buffer.get(), image.get());
+			frame = viewfinder_->getCurrentImage();
+		}
+
+		viewfinder_->stop();
+
+		if (frame.size() != QSize(kWidth, kHeight)) {
+			cerr << "Unexpected viewfinder image size" << endl;
+			return TestFail;
+		}
+
+		/*
+		 * Check the white balance and gamma at the centre of each
+		 * patch, away from the demosaicing edges and from the
+		 * histogram overlay in the bottom-left corner.
+		 */
+		for (int y : { kHeight / 4, kHeight * 3 / 4 }) {
+			for (int x : { kWidth * 3 / 8, kWidth * 7 / 8 }) {
+				QRgb pixel = frame.pixel(x, y);
+				const std::array<int, 3> rgb{
+					qRed(pixel), qGreen(pixel), qBlue(pixel)
+				};
+
+				for (unsigned int c = 0; c < 3; c++) {
+					double value = std::min(patch(x, y)[c] / 255.0 * kGains[c], 1.0);
+					int expected = lround(pow(value, kGamma) * 255);
+
+					if (abs(rgb[c] - expected) > 3) {
+						cerr << format.format << ": wrong value "
+						     << rgb[c] << " for channel " << c
+						     << " at (" << x << ", " << y
+						     << "), expected " << expected << endl;
+						return TestFail;
+					}
+				}
+			}
+		}
+
+		/*
+		 * The histogram is computed before white balance and gamma, the
+		 * bins of the raw patch values must hold most of the samples.
+		 */
+		const ViewFinderGL::Histogram &histogram = viewfinder_->histogram();
+
+		unsigned int samples = 0;
+		for (unsigned int count : histogram[0])
+			samples += count;
+
+		if (!samples) {
+			cerr << format.format << ": histogram not computed" << endl;
+			return TestFail;
+		}
+
+		for (unsigned int c = 0; c < 3; c++) {
+			unsigned int total = 0;
+			for (unsigned int count : histogram[c])
+				total += count;
+
+			unsigned int count = 0;
+			for (unsigned int p = 0; p < patches.size(); p++) {
+				bool duplicate = false;
+				for (unsigned int q = 0; q < p; q++)
+					duplicate |= bin(patches[q][c]) == bin(patches[p][c]);
+				if (!duplicate)
+					count += histogram[c][bin(patches[p][c])];
+			}
+
+			if (total != samples || count < samples * 9 / 10) {
+				cerr << format.format << ": histogram of channel "
+				     << c << " doesn't match the raw values" << endl;
+				return TestFail;
+			}
+		}
+
+		return TestPass;
+	}
+
+	int run() override
+	{
+		viewfinder_ = make_unique<ViewFinderGL>();
+		viewfinder_->resize(kWidth, kHeight);
+		viewfinder_->show();
+		QApplication::processEvents();
+
+		for (const RawFormat &format : rawFormats) {
+			int ret = testFormat(format);
+			if (ret != TestPass)
+				return ret;
+		}
+
+		return TestPass;
+	}
+
+	void cleanup() override
+	{
+		viewfinder_.reset();
+	}
+
+private:
+	/*
+	 * The frame size results in the histogram being computed on an image
+	 * subsampled by 4, which must preserve the Bayer pattern phase.
+	 */
+	static constexpr int kWidth = 512;
+	static constexpr int kHeight = 384;
+
+	/* Render enough frames to refresh the histogram. */
+	static constexpr unsigned int kFrames = 4;
+
+	static constexpr std::array<double, 3> kGains{ 1.5, 1.0, 2.0 };
+	static constexpr double kGamma = 1.0 / 2.2;
+
+	int argc_ = 1;
+	char name_[14] = "viewfinder_gl";
+	char *argv_[2] = { name_, nullptr };
+
+	unique_ptr<QApplication> app_;
+	unique_ptr<ViewFinderGL> viewfinder_;
+};
+
+} /* namespace */
+
+TEST_REGISTER(ViewFinderGLTest)
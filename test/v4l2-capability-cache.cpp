@@ -0,0 +1,122 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+/*
+ * Copyright (C) 2026, Ideas on Board Oy
+ *
+ * v4l2-capability-cache.cpp - V4L2 capability cache tests
+ */
+
+#include <iostream>
+#include <stdlib.h>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "libcamera/internal/v4l2_capability_cache.h"
+
+#include "test.h"
+
+using namespace std;
+using namespace libcamera;
+
+class V4L2CapabilityCacheTest : public Test
+{
+protected:
+	int init() override
+	{
+		dir_ = "/tmp/libcamera.test.XXXXXX";
+		if (!mkdtemp(&dir_.front()))
+			return TestFail;
+
+		/* Exercise the creation of the parent directory. */
+		path_ = dir_ + "/cache/v4l2_capabilities.cache";
+
+		formats_[0x3001] = { SizeRange({ 640, 480 }, { 3280, 2464 }, 2, 2) };
+		formats_[0x300f] = {
+			SizeRange({ 1920, 1080 }),
+			SizeRange({ 3280, 2464 }),
+		};
+
+		return TestPass;
+	}
+
+	int check(const string &key, bool expectHit)
+	{
+		V4L2CapabilityCache cache(path_);
+		V4L2CapabilityCache::Formats formats;
+
+		if (cache.formats(key, &formats) != expectHit) {
+			cerr << "Expected a cache " << (expectHit ? "hit" : "miss")
+			     << " for " << key << endl;
+			return TestFail;
+		}
+
+		if (expectHit && formats != formats_) {
+			cerr << "Cached formats mismatch for " << key << endl;
+			return TestFail;
+		}
+
+		return TestPass;
+	}
+
+	int run() override
+	{
+		const string key = "sensor:vimc:VIMC MDEV:0:0:Sensor A:0";
+
+		if (check(key, false) != TestPass)
+			return TestFail;
+
+		{
+			V4L2CapabilityCache cache(path_);
+
+			if (V4L2CapabilityCache::instance() != &cache) {
+				cerr << "Cache instance not registered" << endl;
+				return TestFail;
+			}
+
+			cache.setFormats(key, formats_);
+		}
+
+		if (V4L2CapabilityCache::instance()) {
+			cerr << "Cache instance not unregistered" << endl;
+			return TestFail;
+		}
+
+		/* The formats must be retrieved from the file. */
+		if (check(key, true) != TestPass)
+			return TestFail;
+
+		if (check("sensor:vimc:VIMC MDEV:0:0:Sensor B:0", false) != TestPass)
+			return TestFail;
+
+		/* A cache file writable by other users must be ignored. */
+		chmod(path_.c_str(), 0666);
+
+		if (check(key, false) != TestPass)
+			return TestFail;
+
+		chmod(path_.c_str(), 0600);
+
+		/* A corrupted cache file must be ignored. */
+		if (truncate(path_.c_str(), 40) < 0)
+			return TestFail;
+
+		if (check(key, false) != TestPass)
+			return TestFail;
+
+		return TestPass;
+	}
+
+	void cleanup() override
+	{
+		unlink(path_.c_str());
+		rmdir((dir_ + "/cache").c_str());
+		rmdir(dir_.c_str());
+	}
+
+private:
+	string dir_;
+	string path_;
+	V4L2CapabilityCache::Formats formats_;
+};
+
+TEST_REGISTER(V4L2CapabilityCacheTest)
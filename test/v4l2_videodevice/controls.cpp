@@ -134,6 +134,76 @@ protected:
 			return TestFail;
 		}
 
+		/* Test that writing unchanged controls is skipped. */
+		V4L2Device::ControlStatistics stats = capture_->controlStatistics();
+
+		ret = capture_->setControls(&ctrls);
+		if (ret) {
+			cerr << "Failed to set controls (unchanged)" << endl;
+			return TestFail;
+		}
+
+		const V4L2Device::ControlStatistics &newStats = capture_->controlStatistics();
+		if (newStats.writes != stats.writes ||
+		    newStats.skippedWrites != stats.skippedWrites + 1 ||
+		    newStats.skippedControls != stats.skippedControls + ctrls.size()) {
+			cerr << "Unchanged controls written" << endl;
+			return TestFail;
+		}
+
+		/* Test that only the modified controls are written. */
+		stats = newStats;
+
+		ctrls.set(V4L2_CID_BRIGHTNESS, brightness.max());
+
+		ret = capture_->setControls(&ctrls);
+		if (ret) {
+			cerr << "Failed to set controls (modified)" << endl;
+			return TestFail;
+		}
+
+		if (newStats.writes != stats.writes + 1 ||
+		    newStats.skippedControls != stats.skippedControls + ctrls.size() - 1) {
+			cerr << "Incorrect controls written" << endl;
+			return TestFail;
+		}
+
+		ControlList result = capture_->getControls({ V4L2_CID_BRIGHTNESS });
+		if (result.get(V4L2_CID_BRIGHTNESS) != brightness.max()) {
+			cerr << "Modified control not written" << endl;
+			return TestFail;
+		}
+
+		/*
+		 * Test that controls written from V4L2 control structures are
+		 * cached.
+		 */
+		v4l2_ext_control v4l2Ctrl = {};
+		v4l2Ctrl.id = V4L2_CID_BRIGHTNESS;
+		v4l2Ctrl.value = brightness.min().get<int32_t>();
+
+		ret = capture_->setControls(Span<v4l2_ext_control>(&v4l2Ctrl, 1));
+		if (ret) {
+			cerr << "Failed to set controls (V4L2 structures)" << endl;
+			return TestFail;
+		}
+
+		stats = newStats;
+
+		ctrls.set(V4L2_CID_BRIGHTNESS, brightness.min());
+
+		ret = capture_->setControls(&ctrls);
+		if (ret) {
+			cerr << "Failed to set controls (cached)" << endl;
+			return TestFail;
+		}
+
+		if (newStats.writes != stats.writes ||
+		    newStats.skippedWrites != stats.skippedWrites + 1) {
+			cerr << "Controls written from V4L2 structures not cached" << endl;
+			return TestFail;
+		}
+
 		return TestPass;
 	}
 };